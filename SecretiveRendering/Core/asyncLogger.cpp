@@ -0,0 +1,183 @@
+#include "asyncLogger.h"
+
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief Line prefix of a level; info lines, the bulk of the log, have none
+     */
+    const char* LevelPrefix(core::LogLevel level) {
+        switch (level) {
+        case core::LogLevel::Trace:
+            return "[T] ";
+        case core::LogLevel::Warn:
+            return "[W] ";
+        case core::LogLevel::Error:
+            return "[E] ";
+        default:
+            return "";
+        }
+    }
+}
+
+core::AsyncLogger::~AsyncLogger() {
+    // Only reached at DLL unload; a drain thread still running there cannot be joined under the loader lock
+    if (drainThread.joinable()) {
+        drainThread.detach();
+    }
+    if (file) {
+        fclose(file);
+    }
+}
+
+void core::AsyncLogger::Start() {
+    std::lock_guard<std::mutex> guard(sleepLock);
+    if (drainThread.joinable()) {
+        return;
+    }
+    stopping = false;
+    drainThread = std::thread(&AsyncLogger::DrainLoop, this);
+}
+
+void core::AsyncLogger::Stop() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    if (drainThread.joinable()) {
+        drainThread.join();
+    }
+    Flush();
+}
+
+void core::AsyncLogger::Flush() {
+    Drain();
+}
+
+bool core::AsyncLogger::OpenFile(const char* path) {
+    std::lock_guard<std::mutex> guard(drainLock);
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+#ifdef _WIN32
+    if (fopen_s(&file, path, "a") != 0) {
+        file = nullptr;
+    }
+#else
+    file = fopen(path, "a");
+#endif
+    return file != nullptr;
+}
+
+uint64_t core::AsyncLogger::DroppedCount() const {
+    std::lock_guard<std::mutex> guard(ringsLock);
+    uint64_t dropped = 0;
+    for (const auto& ring : rings) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+core::LogRing* core::AsyncLogger::RegisterThread() {
+    // Once per thread; the ring outlives the thread so records logged just before exit are still written
+    std::lock_guard<std::mutex> guard(ringsLock);
+    rings.push_back(std::make_unique<LogRing>());
+    return rings.back().get();
+}
+
+void core::AsyncLogger::DrainLoop() {
+    std::unique_lock<std::mutex> guard(sleepLock);
+    while (!stopping) {
+        guard.unlock();
+        Drain();
+        guard.lock();
+
+        // Producers never signal (that could block them); poll instead
+        wakeUp.wait_for(guard, std::chrono::milliseconds(LOG_DRAIN_INTERVAL_MS), [this]() { return stopping; });
+    }
+}
+
+size_t core::AsyncLogger::Drain() {
+    std::lock_guard<std::mutex> drainGuard(drainLock);
+
+    std::vector<LogRing*> snapshot;
+    {
+        std::lock_guard<std::mutex> guard(ringsLock);
+        snapshot.reserve(rings.size());
+        for (const auto& ring : rings) {
+            snapshot.push_back(ring.get());
+        }
+    }
+
+    batch.clear();
+    uint64_t dropped = 0;
+    for (LogRing* ring : snapshot) {
+        const size_t head = ring->head.load(std::memory_order_relaxed);
+        const size_t tail = ring->tail.load(std::memory_order_acquire);
+        for (size_t i = head; i != tail; i++) {
+            batch.push_back(ring->records[i & (LOG_RING_CAPACITY - 1)]);
+        }
+        ring->head.store(tail, std::memory_order_release);
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+
+    if (batch.empty() && dropped == reportedDropped) {
+        return 0;
+    }
+
+    // Each ring is already in order; merge the threads by time
+    std::stable_sort(batch.begin(), batch.end(),
+        [](const LogRecord& a, const LogRecord& b) { return a.timestamp < b.timestamp; });
+
+    output.clear();
+    char value[64];
+    for (const LogRecord& record : batch) {
+        output += LevelPrefix(record.level);
+        output += record.name;
+        output += ": ";
+        switch (record.kind) {
+        case LogValueKind::Hex:
+            snprintf(value, sizeof(value), "%llx", static_cast<unsigned long long>(record.value.hex));
+            output += value;
+            break;
+        case LogValueKind::Float:
+            snprintf(value, sizeof(value), "%g", record.value.number);
+            output += value;
+            break;
+        case LogValueKind::Text:
+            output.append(record.value.text, record.length);
+            if (record.truncated) {
+                output += "...";
+            }
+            break;
+        }
+        output += '\n';
+    }
+
+    if (dropped != reportedDropped) {
+        snprintf(value, sizeof(value), "%sLog records dropped: %llu\n", LevelPrefix(LogLevel::Warn),
+            static_cast<unsigned long long>(dropped));
+        output += value;
+        reportedDropped = dropped;
+    }
+
+    WriteOutput(output.data(), output.size());
+    return batch.size();
+}
+
+void core::AsyncLogger::WriteOutput(const char* data, size_t size) {
+    fwrite(data, 1, size, stdout);
+    fflush(stdout);
+    if (file) {
+        fwrite(data, 1, size, file);
+        fflush(file);
+    }
+}
+
+core::AsyncLogger& core::GetLogger() {
+    static AsyncLogger logger;
+    return logger;
+}
\ No newline at end of file
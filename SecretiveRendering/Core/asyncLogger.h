@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Asynchronous logger behind the LOG* macros.
+// Every thread writes fixed-size binary records (name pointer + raw value) into its own
+// single-producer ring; nothing is formatted or written on the calling thread, and a full ring
+// drops the record instead of blocking. A drain thread formats and writes the records.
+// Start/Stop it from fMain (joining under the loader lock in DllMain deadlocks); Flush() drains on
+// the calling thread and is what DllMain uses after the drain thread is gone.
+namespace core {
+    constexpr size_t LOG_RING_CAPACITY = 1024;      // Records per thread (power of two)
+    constexpr size_t LOG_TEXT_CAPACITY = 104;       // String values longer than this are truncated
+    constexpr uint32_t LOG_DRAIN_INTERVAL_MS = 5;
+
+    static_assert((LOG_RING_CAPACITY & (LOG_RING_CAPACITY - 1)) == 0, "Log ring capacity must be a power of two");
+
+    enum class LogLevel : uint8_t {
+        Trace,
+        Info,
+        Warn,
+        Error
+    };
+
+    enum class LogValueKind : uint8_t {
+        Hex,        // Integers, booleans, enums and pointers (printed in hex like the old std::hex output)
+        Float,
+        Text
+    };
+
+    /**
+     * @brief One log call; the name is a string literal and serves as the format id
+     */
+    struct LogRecord {
+        uint64_t timestamp;     // steady_clock ticks, used to merge the per-thread rings
+        const char* name;
+        LogLevel level;
+        LogValueKind kind;
+        uint16_t length;        // Text: bytes stored in value.text
+        bool truncated;         // Text: the original string was longer
+        union {
+            uint64_t hex;
+            double number;
+            char text[LOG_TEXT_CAPACITY];
+        } value;
+    };
+
+    static_assert(sizeof(LogRecord) == 128, "Log records should stay two cache lines");
+
+    /**
+     * @brief Single-producer/single-consumer ring owned by one logging thread
+     */
+    struct LogRing {
+        alignas(64) std::atomic<size_t> head{ 0 };     // Next record to drain (consumer)
+        alignas(64) std::atomic<size_t> tail{ 0 };     // Next free slot (producer)
+        std::atomic<uint64_t> dropped{ 0 };             // Written by the producer only
+        LogRecord records[LOG_RING_CAPACITY];
+    };
+
+    namespace detail {
+        inline void CaptureText(LogRecord& record, const char* text, size_t length) {
+            record.kind = LogValueKind::Text;
+            record.truncated = length > LOG_TEXT_CAPACITY;
+            record.length = static_cast<uint16_t>(record.truncated ? LOG_TEXT_CAPACITY : length);
+            memcpy(record.value.text, text, record.length);
+        }
+
+        inline void Capture(LogRecord& record, const char* text) {
+            if (!text) {
+                text = "(null)";
+            }
+            CaptureText(record, text, strlen(text));
+        }
+
+        inline void Capture(LogRecord& record, char* text) {
+            Capture(record, static_cast<const char*>(text));
+        }
+
+        inline void Capture(LogRecord& record, const std::string& text) {
+            CaptureText(record, text.data(), text.size());
+        }
+
+        template<typename T>
+        inline void Capture(LogRecord& record, T* pointer) {
+            record.kind = LogValueKind::Hex;
+            record.value.hex = reinterpret_cast<uintptr_t>(pointer);
+        }
+
+        template<typename T>
+        inline std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> Capture(LogRecord& record, T value) {
+            if constexpr (std::is_floating_point_v<T>) {
+                record.kind = LogValueKind::Float;
+                record.value.number = static_cast<double>(value);
+            }
+            else if constexpr (std::is_same_v<T, bool>) {
+                record.kind = LogValueKind::Hex;
+                record.value.hex = value ? 1 : 0;
+            }
+            else if constexpr (std::is_enum_v<T>) {
+                Capture(record, static_cast<std::underlying_type_t<T>>(value));
+            }
+            else {
+                // Keep the type's width so negative values print like std::hex did (HRESULTs as 8 digits)
+                record.kind = LogValueKind::Hex;
+                record.value.hex = static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
+            }
+        }
+    }
+
+    class AsyncLogger {
+    public:
+        AsyncLogger() = default;
+        ~AsyncLogger();
+
+        AsyncLogger(const AsyncLogger&) = delete;
+        AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+        /**
+         * @brief Start the drain thread (records logged earlier are kept and written first)
+         */
+        void Start();
+
+        /**
+         * @brief Stop and join the drain thread, then write everything still queued
+         * Call from fMain before FreeLibraryAndExitThread, never from DllMain.
+         */
+        void Stop();
+
+        /**
+         * @brief Format and write every queued record on the calling thread
+         */
+        void Flush();
+
+        /**
+         * @brief Also write records to a file (appended)
+         * @return false if the file could not be opened
+         */
+        bool OpenFile(const char* path);
+
+        /**
+         * @brief Queue one record; never blocks and never formats
+         * @param name String literal (only the pointer is stored)
+         */
+        template<typename T>
+        void Write(LogLevel level, const char* name, const T& value) {
+            LogRing& ring = ThreadRing();
+            const size_t tail = ring.tail.load(std::memory_order_relaxed);
+            if (tail - ring.head.load(std::memory_order_acquire) >= LOG_RING_CAPACITY) {
+                ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+
+            LogRecord& record = ring.records[tail & (LOG_RING_CAPACITY - 1)];
+            record.timestamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            record.name = name;
+            record.level = level;
+            detail::Capture(record, value);
+            ring.tail.store(tail + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Records lost because a thread's ring was full
+         */
+        uint64_t DroppedCount() const;
+
+    private:
+        LogRing& ThreadRing() {
+            thread_local LogRing* ring = nullptr;
+            if (!ring) {
+                ring = RegisterThread();
+            }
+            return *ring;
+        }
+
+        LogRing* RegisterThread();
+        void DrainLoop();
+        size_t Drain();
+        void WriteOutput(const char* data, size_t size);
+
+        mutable std::mutex ringsLock;
+        std::vector<std::unique_ptr<LogRing>> rings;
+
+        std::mutex drainLock;                   // One consumer at a time (drain thread or Flush)
+        std::vector<LogRecord> batch;
+        std::string output;
+        uint64_t reportedDropped = 0;
+        FILE* file = nullptr;
+
+        std::thread drainThread;
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+        bool stopping = false;
+    };
+
+    /**
+     * @brief Process-wide logger used by the LOG* macros
+     */
+    AsyncLogger& GetLogger();
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "callbackThrottle.h"
+
+#include <algorithm>
+
+core::ThrottleChange core::CallbackThrottle::Account(double costUs) {
+    runs++;
+    lastUs = costUs;
+    averageUs = runs == 1 ? costUs : averageUs + (costUs - averageUs) * CALLBACK_AVERAGE_WEIGHT;
+    maxUs = (std::max)(maxUs, costUs);
+
+    if (costUs <= budgetUs) {
+        overrunStreak = 0;
+        if (interval > 1 && ++cleanStreak >= CALLBACK_CLEAN_RUNS_TO_RECOVER) {
+            interval /= 2;
+            cleanStreak = 0;
+            strikes = 0;
+            return ThrottleChange::Raised;
+        }
+        return ThrottleChange::None;
+    }
+
+    overruns++;
+    cleanStreak = 0;
+    if (++overrunStreak < CALLBACK_OVERRUNS_TO_THROTTLE) {
+        return ThrottleChange::None;
+    }
+    overrunStreak = 0;
+    if (interval < CALLBACK_MAX_INTERVAL) {
+        interval *= 2;
+        return ThrottleChange::Lowered;
+    }
+    if (++strikes >= CALLBACK_STRIKES_TO_DISABLE) {
+        disabled = true;
+        return ThrottleChange::Disabled;
+    }
+    return ThrottleChange::None;
+}
+
+void core::CallbackThrottle::Reset() {
+    disabled = false;
+    interval = 1;
+    overrunStreak = 0;
+    cleanStreak = 0;
+    strikes = 0;
+}
\ No newline at end of file
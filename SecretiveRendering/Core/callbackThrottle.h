@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+// Rate control of one overlay callback (see Rendering/overlayCallbacks.h), kept free of ImGui so it
+// can be exercised offline. Each call's cost is accounted against the callback's budget: after
+// CALLBACK_OVERRUNS_TO_THROTTLE consecutive overruns the callback is called at half the rate, down
+// to once every CALLBACK_MAX_INTERVAL builds; CALLBACK_CLEAN_RUNS_TO_RECOVER calls within budget
+// double it again. A callback that keeps overrunning at the lowest rate is disabled.
+namespace core {
+    constexpr uint32_t CALLBACK_MAX_INTERVAL = 8;           // Lowest call rate: once every 8 builds
+    constexpr uint32_t CALLBACK_OVERRUNS_TO_THROTTLE = 3;   // Consecutive overruns before the rate halves
+    constexpr uint32_t CALLBACK_CLEAN_RUNS_TO_RECOVER = 30; // Calls within budget before the rate doubles
+    constexpr uint32_t CALLBACK_STRIKES_TO_DISABLE = 3;     // Throttle steps past the lowest rate
+    constexpr double CALLBACK_AVERAGE_WEIGHT = 1.0 / 8.0;   // Weight of the newest call in the average
+
+    enum class ThrottleChange : uint8_t {
+        None,
+        Lowered,    // The rate halved
+        Raised,     // The rate doubled
+        Disabled    // Over budget at the lowest rate
+    };
+
+    class CallbackThrottle {
+    public:
+        explicit CallbackThrottle(double budgetUs) : budgetUs(budgetUs) {}
+
+        /**
+         * @brief Account one call and adjust the rate
+         * @param costUs Time the call took
+         * @return How the rate changed
+         */
+        ThrottleChange Account(double costUs);
+
+        /**
+         * @brief Stop calling (the callback threw)
+         */
+        void Disable() { disabled = true; }
+
+        /**
+         * @brief Fresh start at the full rate; the cost history is kept
+         */
+        void Reset();
+
+        double BudgetUs() const { return budgetUs; }
+        uint32_t Interval() const { return interval; }
+        bool Disabled() const { return disabled; }
+        uint64_t Runs() const { return runs; }
+        uint64_t Overruns() const { return overruns; }
+        double LastUs() const { return lastUs; }
+        double AverageUs() const { return averageUs; }
+        double MaxUs() const { return maxUs; }
+
+    private:
+        double budgetUs;
+        uint32_t interval = 1;          // Builds per call
+        uint32_t overrunStreak = 0;
+        uint32_t cleanStreak = 0;
+        uint32_t strikes = 0;
+        bool disabled = false;
+
+        uint64_t runs = 0;
+        uint64_t overruns = 0;
+        double lastUs = 0.0;
+        double averageUs = 0.0;         // Exponential moving average over calls
+        double maxUs = 0.0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "frameProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    constexpr uint64_t SUB_BUCKET_COUNT = 1ull << core::HISTOGRAM_SUB_BUCKET_BITS;
+    constexpr uint64_t MAX_VALUE = (1ull << (core::HISTOGRAM_MAX_BIT + 1)) - 1;
+
+    uint32_t HighestBit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return index;
+#else
+        return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+    }
+
+    double ToMicroseconds(uint64_t nanoseconds) {
+        return nanoseconds / 1000.0;
+    }
+}
+
+size_t core::LatencyHistogram::BucketIndex(uint64_t valueNs) {
+    // Values below 2 * SUB_BUCKET_COUNT get exact buckets; above that each power of two is split
+    // into SUB_BUCKET_COUNT linear buckets (the top HISTOGRAM_SUB_BUCKET_BITS + 1 bits of the value)
+    if (valueNs < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(valueNs);
+    }
+    valueNs = (std::min)(valueNs, MAX_VALUE);
+    const uint32_t magnitude = HighestBit(valueNs) - HISTOGRAM_SUB_BUCKET_BITS;
+    const uint64_t subBucket = (valueNs >> magnitude) - SUB_BUCKET_COUNT;
+    return static_cast<size_t>(((magnitude + 1) << HISTOGRAM_SUB_BUCKET_BITS) + subBucket);
+}
+
+uint64_t core::LatencyHistogram::BucketUpperBound(size_t index) {
+    if (index < 2 * SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const uint32_t magnitude = static_cast<uint32_t>(index >> HISTOGRAM_SUB_BUCKET_BITS) - 1;
+    const uint64_t subBucket = (index & (SUB_BUCKET_COUNT - 1)) + SUB_BUCKET_COUNT;
+    return ((subBucket + 1) << magnitude) - 1;
+}
+
+void core::LatencyHistogram::Record(uint64_t valueNs) {
+    counts[BucketIndex(valueNs)]++;
+    count++;
+    sum += valueNs;
+    minimum = (std::min)(minimum, valueNs);
+    maximum = (std::max)(maximum, valueNs);
+}
+
+void core::LatencyHistogram::Reset() {
+    *this = LatencyHistogram();
+}
+
+void core::LatencyHistogram::Percentiles(const double* percentiles, size_t percentileCount, uint64_t* results) const {
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < HISTOGRAM_BUCKET_COUNT && next < percentileCount; bucket++) {
+        seen += counts[bucket];
+        while (next < percentileCount && seen && seen >= (percentiles[next] / 100.0) * count) {
+            // The bucket bound may overshoot the largest value actually recorded
+            results[next++] = (std::min)(BucketUpperBound(bucket), maximum);
+        }
+    }
+    for (; next < percentileCount; next++) {
+        results[next] = maximum;
+    }
+}
+
+uint64_t core::LatencyHistogram::Percentile(double percentile) const {
+    uint64_t result = 0;
+    Percentiles(&percentile, 1, &result);
+    return result;
+}
+
+const char* core::FrameStageName(FrameStage stage) {
+    switch (stage) {
+    case FrameStage::NewFrame:
+        return "NewFrame";
+    case FrameStage::BuildUi:
+        return "UI build";
+    case FrameStage::Render:
+        return "Render";
+    case FrameStage::RenderDrawData:
+        return "RenderDrawData";
+    case FrameStage::OriginalPresent:
+        return "Original Present";
+    case FrameStage::Overhead:
+        return "Hook overhead";
+    default:
+        return "Unknown";
+    }
+}
+
+core::FrameProfiler::FrameProfiler() {
+#ifdef _WIN32
+    LARGE_INTEGER qpcFrequency;
+    QueryPerformanceFrequency(&qpcFrequency);
+    frequency = qpcFrequency.QuadPart;
+#else
+    frequency = 1000000000;
+#endif
+}
+
+int64_t core::FrameProfiler::Now() {
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+uint64_t core::FrameProfiler::TicksToNanoseconds(int64_t ticks) const {
+    if (ticks <= 0) {
+        return 0;
+    }
+    // Split to avoid overflowing ticks * 1e9
+    const uint64_t seconds = static_cast<uint64_t>(ticks / frequency);
+    const uint64_t remainder = static_cast<uint64_t>(ticks % frequency);
+    return seconds * 1000000000ull + remainder * 1000000000ull / static_cast<uint64_t>(frequency);
+}
+
+void core::FrameProfiler::Add(FrameStage stage, int64_t ticks) {
+    current[static_cast<size_t>(stage)] += ticks;
+}
+
+void core::FrameProfiler::EndFrame(int64_t hookTicks) {
+    current[static_cast<size_t>(FrameStage::Overhead)] = hookTicks - current[static_cast<size_t>(FrameStage::OriginalPresent)];
+
+    for (size_t stage = 0; stage < FRAME_STAGE_COUNT; stage++) {
+        const uint64_t nanoseconds = TicksToNanoseconds(current[stage]);
+        histograms[stage].Record(nanoseconds);
+        history[stage][historyNext] = static_cast<float>(ToMicroseconds(nanoseconds));
+        current[stage] = 0;
+    }
+    historyNext = (historyNext + 1) % FRAME_HISTORY;
+}
+
+void core::FrameProfiler::RefreshSummaries() {
+    static const double percentiles[] = { 50.0, 99.0, 99.9 };
+    for (size_t stage = 0; stage < FRAME_STAGE_COUNT; stage++) {
+        const LatencyHistogram& histogram = histograms[stage];
+        uint64_t values[3];
+        histogram.Percentiles(percentiles, 3, values);
+
+        StageSummary& summary = summaries[stage];
+        summary.frames = histogram.Count();
+        summary.meanUs = histogram.Mean() / 1000.0;
+        summary.p50Us = ToMicroseconds(values[0]);
+        summary.p99Us = ToMicroseconds(values[1]);
+        summary.p999Us = ToMicroseconds(values[2]);
+        summary.maxUs = ToMicroseconds(histogram.Max());
+    }
+}
+
+void core::FrameProfiler::Reset() {
+    for (size_t stage = 0; stage < FRAME_STAGE_COUNT; stage++) {
+        histograms[stage].Reset();
+        summaries[stage] = StageSummary();
+        std::fill(std::begin(history[stage]), std::end(history[stage]), 0.0f);
+        current[stage] = 0;
+    }
+    historyNext = 0;
+}
+
+bool core::FrameProfiler::ExportCsv(const std::string& path) const {
+    FILE* file = nullptr;
+#ifdef _WIN32
+    if (fopen_s(&file, path.c_str(), "w") != 0) {
+        return false;
+    }
+#else
+    file = fopen(path.c_str(), "w");
+#endif
+    if (!file) {
+        return false;
+    }
+
+    static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+    fprintf(file, "stage,frames,mean_us,min_us,p50_us,p90_us,p99_us,p99.9_us,max_us\n");
+    for (size_t stage = 0; stage < FRAME_STAGE_COUNT; stage++) {
+        const LatencyHistogram& histogram = histograms[stage];
+        uint64_t values[4];
+        histogram.Percentiles(percentiles, 4, values);
+        fprintf(file, "%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+            FrameStageName(static_cast<FrameStage>(stage)),
+            static_cast<unsigned long long>(histogram.Count()),
+            histogram.Mean() / 1000.0,
+            ToMicroseconds(histogram.Min()),
+            ToMicroseconds(values[0]), ToMicroseconds(values[1]), ToMicroseconds(values[2]), ToMicroseconds(values[3]),
+            ToMicroseconds(histogram.Max()));
+    }
+
+    const bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+core::FrameProfiler& core::GetFrameProfiler() {
+    static FrameProfiler profiler;
+    return profiler;
+}
\ No newline at end of file
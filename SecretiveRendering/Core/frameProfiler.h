@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Per-frame cost of hkPresent, split by stage.
+// Stages are timed with the performance counter and recorded into fixed-size log-linear
+// (HDR-style) histograms, so recording never allocates. The last FRAME_HISTORY frames are kept
+// for the overlay graph; percentile summaries are refreshed by a scheduled provider.
+namespace core {
+    constexpr uint32_t HISTOGRAM_SUB_BUCKET_BITS = 5;   // 32 buckets per power of two: <= 3.2% error
+    constexpr uint32_t HISTOGRAM_MAX_BIT = 39;          // Values are clamped below 2^40 ns (~18 min)
+    constexpr size_t HISTOGRAM_BUCKET_COUNT = (HISTOGRAM_MAX_BIT - HISTOGRAM_SUB_BUCKET_BITS + 2) << HISTOGRAM_SUB_BUCKET_BITS;
+
+    constexpr size_t FRAME_HISTORY = 240;
+    constexpr double OVERHEAD_BUDGET_US = 100.0;        // What the overlay may add to a frame
+
+    /**
+     * @brief Histogram of nanosecond values with bounded relative error
+     */
+    class LatencyHistogram {
+    public:
+        void Record(uint64_t valueNs);
+        void Reset();
+
+        /**
+         * @brief Several percentiles in one pass over the buckets
+         * @param percentiles Ascending, in [0, 100]
+         * @param results Highest value of the bucket holding each percentile (ns)
+         */
+        void Percentiles(const double* percentiles, size_t count, uint64_t* results) const;
+
+        uint64_t Percentile(double percentile) const;
+
+        uint64_t Count() const { return count; }
+        uint64_t Min() const { return count ? minimum : 0; }
+        uint64_t Max() const { return maximum; }
+        double Mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+        static size_t BucketIndex(uint64_t valueNs);
+        static uint64_t BucketUpperBound(size_t index);
+
+    private:
+        uint64_t counts[HISTOGRAM_BUCKET_COUNT] = {};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t minimum = UINT64_MAX;
+        uint64_t maximum = 0;
+    };
+
+    enum class FrameStage : uint8_t {
+        NewFrame,           // ImGui backend and ImGui::NewFrame
+        BuildUi,            // Our windows
+        Render,             // ImGui::EndFrame + ImGui::Render
+        RenderDrawData,     // Overlay renderer: upload and draws
+        OriginalPresent,    // The overlay's Present we forward to
+        Overhead,           // Everything in hkPresent except OriginalPresent
+        Count
+    };
+
+    constexpr size_t FRAME_STAGE_COUNT = static_cast<size_t>(FrameStage::Count);
+
+    const char* FrameStageName(FrameStage stage);
+
+    /**
+     * @brief Percentiles of one stage (microseconds)
+     */
+    struct StageSummary {
+        uint64_t frames = 0;
+        double meanUs = 0.0;
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+        double p999Us = 0.0;
+        double maxUs = 0.0;
+    };
+
+    class FrameProfiler {
+    public:
+        FrameProfiler();
+
+        /**
+         * @brief Performance counter ticks
+         */
+        static int64_t Now();
+
+        /**
+         * @brief Add time to a stage of the current frame
+         */
+        void Add(FrameStage stage, int64_t ticks);
+
+        /**
+         * @brief Commit the current frame
+         * @param hookTicks Time spent in the whole hook, OriginalPresent included
+         */
+        void EndFrame(int64_t hookTicks);
+
+        void Reset();
+
+        /**
+         * @brief Recompute the percentile summaries from the histograms
+         */
+        void RefreshSummaries();
+
+        const LatencyHistogram& Histogram(FrameStage stage) const { return histograms[static_cast<size_t>(stage)]; }
+        const StageSummary& Summary(FrameStage stage) const { return summaries[static_cast<size_t>(stage)]; }
+
+        /**
+         * @brief Ring of per-frame microseconds; the oldest entry is at HistoryOffset()
+         */
+        const float* History(FrameStage stage) const { return history[static_cast<size_t>(stage)]; }
+        size_t HistoryOffset() const { return historyNext; }
+
+        /**
+         * @brief Write the per-stage summary (microseconds) as CSV
+         * @return false if the file could not be written
+         */
+        bool ExportCsv(const std::string& path) const;
+
+        uint64_t TicksToNanoseconds(int64_t ticks) const;
+
+    private:
+        int64_t frequency;
+        int64_t current[FRAME_STAGE_COUNT] = {};
+        LatencyHistogram histograms[FRAME_STAGE_COUNT];
+        StageSummary summaries[FRAME_STAGE_COUNT];
+        float history[FRAME_STAGE_COUNT][FRAME_HISTORY] = {};
+        size_t historyNext = 0;
+    };
+
+    /**
+     * @brief Adds the lifetime of the scope to a stage
+     */
+    class ScopedStageTimer {
+    public:
+        ScopedStageTimer(FrameProfiler& profiler, FrameStage stage)
+            : profiler(profiler), stage(stage), start(FrameProfiler::Now()) {}
+        ~ScopedStageTimer() { profiler.Add(stage, FrameProfiler::Now() - start); }
+
+        ScopedStageTimer(const ScopedStageTimer&) = delete;
+        ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    private:
+        FrameProfiler& profiler;
+        FrameStage stage;
+        int64_t start;
+    };
+
+    /**
+     * @brief Profiler of the render thread (only touched from hkPresent)
+     */
+    FrameProfiler& GetFrameProfiler();
+}
\ No newline at end of file
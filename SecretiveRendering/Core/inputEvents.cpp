@@ -0,0 +1,119 @@
+#include "inputEvents.h"
+
+namespace {
+    constexpr LPARAM KEY_PREVIOUSLY_DOWN = 1 << 30;  // lParam bit 30 of WM_KEYDOWN: set for auto-repeat
+    constexpr uint64_t CURSOR_VALID = 1ull << 32;
+
+    bool IsInputMessage(UINT message) {
+        switch (message) {
+        case WM_KEYDOWN: case WM_KEYUP: case WM_SYSKEYDOWN: case WM_SYSKEYUP: case WM_CHAR:
+        case WM_LBUTTONDOWN: case WM_LBUTTONUP: case WM_LBUTTONDBLCLK:
+        case WM_RBUTTONDOWN: case WM_RBUTTONUP: case WM_RBUTTONDBLCLK:
+        case WM_MBUTTONDOWN: case WM_MBUTTONUP: case WM_MBUTTONDBLCLK:
+        case WM_XBUTTONDOWN: case WM_XBUTTONUP: case WM_XBUTTONDBLCLK:
+        case WM_MOUSEWHEEL: case WM_MOUSEHWHEEL:
+        case WM_SETFOCUS: case WM_KILLFOCUS: case WM_SIZE: case WM_MOUSELEAVE:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+core::InputEvents::InputEvents() {
+    for (auto& count : presses) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    shutdownEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+}
+
+core::InputEvents::~InputEvents() {
+    if (shutdownEvent) {
+        CloseHandle(shutdownEvent);
+    }
+}
+
+void core::InputEvents::OnWindowMessage(UINT message, WPARAM wParam, LPARAM lParam) {
+    if (message == WM_MOUSEMOVE) {
+        cursor.store(CURSOR_VALID | static_cast<uint32_t>(lParam & 0xFFFFFFFF), std::memory_order_relaxed);
+        return;
+    }
+    if (IsInputMessage(message)) {
+        inputGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    if (message != WM_KEYDOWN && message != WM_SYSKEYDOWN) {
+        return;
+    }
+    if ((lParam & KEY_PREVIOUSLY_DOWN) || wParam >= VIRTUAL_KEY_COUNT) {
+        return;
+    }
+
+    const UINT virtualKey = static_cast<UINT>(wParam);
+    presses[virtualKey].fetch_add(1, std::memory_order_release);
+
+    if (virtualKey == shutdownKey.load(std::memory_order_relaxed)) {
+        RequestShutdown();
+    }
+    if (virtualKey == wakeKey.load(std::memory_order_relaxed)) {
+        // Pairs with the consumer's fence: it sees the press or we see it stopped polling
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (void (*handler)() = wakeHandler.load(std::memory_order_acquire)) {
+            handler();
+        }
+    }
+}
+
+uint32_t core::InputEvents::ConsumePresses(UINT virtualKey) {
+    if (virtualKey >= VIRTUAL_KEY_COUNT) {
+        return 0;
+    }
+    // Relaxed load first: the common case (no press) never writes the shared cache line
+    if (presses[virtualKey].load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+    return presses[virtualKey].exchange(0, std::memory_order_acquire);
+}
+
+uint32_t core::InputEvents::PendingPresses(UINT virtualKey) const {
+    return virtualKey < VIRTUAL_KEY_COUNT ? presses[virtualKey].load(std::memory_order_acquire) : 0;
+}
+
+void core::InputEvents::SetWakeKey(UINT virtualKey, void (*handler)()) {
+    wakeHandler.store(handler, std::memory_order_release);
+    wakeKey.store(handler ? virtualKey : 0, std::memory_order_relaxed);
+}
+
+void core::InputEvents::SetShutdownKey(UINT virtualKey) {
+    shutdownKey.store(virtualKey, std::memory_order_relaxed);
+}
+
+void core::InputEvents::RequestShutdown() {
+    if (shutdownEvent) {
+        SetEvent(shutdownEvent);
+    }
+}
+
+bool core::InputEvents::WaitForShutdown(DWORD timeoutMs) {
+    return shutdownEvent && WaitForSingleObject(shutdownEvent, timeoutMs) == WAIT_OBJECT_0;
+}
+
+bool core::InputEvents::ShutdownRequested() const {
+    return shutdownEvent && WaitForSingleObject(shutdownEvent, 0) == WAIT_OBJECT_0;
+}
+
+bool core::InputEvents::CursorPosition(int& x, int& y) const {
+    const uint64_t value = cursor.load(std::memory_order_relaxed);
+    if (!(value & CURSOR_VALID)) {
+        return false;
+    }
+    // Same decoding as GET_X_LPARAM/GET_Y_LPARAM (coordinates are signed on multi-monitor setups)
+    x = static_cast<int16_t>(value & 0xFFFF);
+    y = static_cast<int16_t>((value >> 16) & 0xFFFF);
+    return true;
+}
+
+core::InputEvents& core::GetInputEvents() {
+    static InputEvents inputEvents;
+    return inputEvents;
+}
\ No newline at end of file
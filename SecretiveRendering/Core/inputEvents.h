@@ -0,0 +1,87 @@
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+
+// Key events decoded from the game window's messages (fed by hkWndProc).
+// Key-down transitions are counted per virtual key with atomics, so the render thread consumes
+// them without a syscall or a lock; auto-repeat is ignored. Pressing the shutdown key signals an
+// event that fMain blocks on. The retained HUD reads the input generation and cursor position
+// to tell whether ImGui could have seen anything new. A wake key runs a handler on the window
+// thread as soon as it is pressed, for code that stops polling while it has nothing to do.
+namespace core {
+    constexpr size_t VIRTUAL_KEY_COUNT = 256;
+
+    class InputEvents {
+    public:
+        InputEvents();
+        ~InputEvents();
+
+        InputEvents(const InputEvents&) = delete;
+        InputEvents& operator=(const InputEvents&) = delete;
+
+        /**
+         * @brief Decode one window message (call from the window procedure, before ImGui sees it)
+         */
+        void OnWindowMessage(UINT message, WPARAM wParam, LPARAM lParam);
+
+        /**
+         * @brief Number of presses of a key since the last call (one atomic exchange)
+         */
+        uint32_t ConsumePresses(UINT virtualKey);
+
+        /**
+         * @brief Presses of a key not consumed yet (does not consume them)
+         */
+        uint32_t PendingPresses(UINT virtualKey) const;
+
+        /**
+         * @brief Call handler from the window procedure whenever virtualKey is pressed
+         * The press is counted, followed by a full fence, before the handler runs; a consumer that
+         * stops polling should fence and check PendingPresses afterwards so no press is missed.
+         * @param handler nullptr disables
+         */
+        void SetWakeKey(UINT virtualKey, void (*handler)());
+
+        /**
+         * @brief Key whose press requests shutdown (0 disables)
+         */
+        void SetShutdownKey(UINT virtualKey);
+
+        void RequestShutdown();
+
+        /**
+         * @brief Block until shutdown is requested
+         * @return false on timeout
+         */
+        bool WaitForShutdown(DWORD timeoutMs = INFINITE);
+
+        bool ShutdownRequested() const;
+
+        /**
+         * @brief Incremented by every keyboard, mouse button, wheel, character, focus and size message
+         */
+        uint32_t InputGeneration() const { return inputGeneration.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Last cursor position from WM_MOUSEMOVE (client coordinates)
+         * @return false if no mouse move was seen yet
+         */
+        bool CursorPosition(int& x, int& y) const;
+
+    private:
+        std::atomic<uint32_t> presses[VIRTUAL_KEY_COUNT];
+        std::atomic<uint32_t> inputGeneration{ 0 };
+        std::atomic<uint64_t> cursor{ 0 };     // Valid bit 32 | y (16 bits) << 16 | x (16 bits)
+        std::atomic<UINT> shutdownKey{ 0 };
+        std::atomic<UINT> wakeKey{ 0 };
+        std::atomic<void (*)()> wakeHandler{ nullptr };
+        HANDLE shutdownEvent;
+    };
+
+    /**
+     * @brief Input of the game window
+     */
+    InputEvents& GetInputEvents();
+}
\ No newline at end of file
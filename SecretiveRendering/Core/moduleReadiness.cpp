@@ -0,0 +1,150 @@
+#include "moduleReadiness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    // ntdll loader notification API (documented, but only exported from ntdll)
+    constexpr ULONG LDR_DLL_NOTIFICATION_REASON_LOADED = 1;
+
+    struct LdrUnicodeString {
+        USHORT Length;          // Bytes, without terminator
+        USHORT MaximumLength;
+        PWSTR Buffer;
+    };
+
+    struct LdrDllNotificationData {
+        ULONG Flags;
+        const LdrUnicodeString* FullDllName;
+        const LdrUnicodeString* BaseDllName;
+        PVOID DllBase;
+        ULONG SizeOfImage;
+    };
+
+    using LdrDllNotificationFunction = VOID(CALLBACK*)(ULONG reason, const LdrDllNotificationData* data, PVOID context);
+    using LdrRegisterDllNotificationFn = LONG(NTAPI*)(ULONG flags, LdrDllNotificationFunction callback, PVOID context, PVOID* cookie);
+    using LdrUnregisterDllNotificationFn = LONG(NTAPI*)(PVOID cookie);
+
+    struct WaitContext {
+        const char* name;
+        size_t nameLength;
+        HANDLE mapped;                      // Set by the callback
+        std::atomic<uintptr_t> base{ 0 };
+    };
+
+    bool SameModuleName(const LdrUnicodeString* moduleName, const char* name, size_t nameLength) {
+        if (!moduleName || !moduleName->Buffer || moduleName->Length / sizeof(WCHAR) != nameLength) {
+            return false;
+        }
+        for (size_t i = 0; i < nameLength; i++) {
+            const WCHAR wide = moduleName->Buffer[i];
+            const WCHAR lowered = wide >= L'A' && wide <= L'Z' ? static_cast<WCHAR>(wide + (L'a' - L'A')) : wide;
+            const char narrow = name[i] >= 'A' && name[i] <= 'Z' ? static_cast<char>(name[i] + ('a' - 'A')) : name[i];
+            if (lowered != static_cast<WCHAR>(static_cast<unsigned char>(narrow))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Runs on the loading thread under the loader lock: compare and signal only
+     */
+    VOID CALLBACK OnDllNotification(ULONG reason, const LdrDllNotificationData* data, PVOID context) {
+        WaitContext* wait = static_cast<WaitContext*>(context);
+        if (reason == LDR_DLL_NOTIFICATION_REASON_LOADED && data &&
+            SameModuleName(data->BaseDllName, wait->name, wait->nameLength)) {
+            wait->base.store(reinterpret_cast<uintptr_t>(data->DllBase), std::memory_order_release);
+            SetEvent(wait->mapped);
+        }
+    }
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+core::ModuleWaitResult core::WaitForModule(const char* name, DWORD timeoutMs) {
+    ModuleWaitResult result;
+    const auto start = std::chrono::steady_clock::now();
+
+    WaitContext wait;
+    wait.name = name;
+    wait.nameLength = strlen(name);
+    wait.mapped = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+    // Register before the first check so a load between the two cannot be missed
+    PVOID cookie = nullptr;
+    LdrUnregisterDllNotificationFn unregisterNotification = nullptr;
+    HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+    if (ntdll && wait.mapped) {
+        auto registerNotification = reinterpret_cast<LdrRegisterDllNotificationFn>(
+            GetProcAddress(ntdll, "LdrRegisterDllNotification"));
+        unregisterNotification = reinterpret_cast<LdrUnregisterDllNotificationFn>(
+            GetProcAddress(ntdll, "LdrUnregisterDllNotification"));
+        if (registerNotification && unregisterNotification &&
+            registerNotification(0, &OnDllNotification, &wait, &cookie) >= 0) {
+            result.notificationsUsed = true;
+        }
+    }
+
+    result.module = GetModuleHandleA(name);
+    if (result.module) {
+        result.source = ModuleReadySource::AlreadyLoaded;
+    }
+
+    DWORD delay = MODULE_POLL_INITIAL_MS;
+    while (!result.module) {
+        const double waited = MillisecondsSince(start);
+        if (waited >= timeoutMs) {
+            break;
+        }
+        const DWORD remaining = timeoutMs - static_cast<DWORD>(waited);
+        const DWORD slice = (std::min)(delay, remaining);
+
+        const bool signaled = wait.mapped && WaitForSingleObject(wait.mapped, slice) == WAIT_OBJECT_0;
+        if (!wait.mapped) {
+            Sleep(slice);
+        }
+
+        if (signaled) {
+            // Mapped and linked, though its initializers may not have run yet; code can be scanned now
+            result.module = reinterpret_cast<HMODULE>(wait.base.load(std::memory_order_acquire));
+            result.source = ModuleReadySource::Notification;
+            break;
+        }
+
+        result.polls++;
+        result.module = GetModuleHandleA(name);
+        if (result.module) {
+            result.source = ModuleReadySource::Poll;
+        }
+        delay = (std::min)(delay * 2, MODULE_POLL_MAX_MS);
+    }
+
+    // No callback can be running once this returns (it takes the loader lock)
+    if (cookie) {
+        unregisterNotification(cookie);
+    }
+    if (wait.mapped) {
+        CloseHandle(wait.mapped);
+    }
+
+    result.waitedMs = MillisecondsSince(start);
+    return result;
+}
+
+const char* core::ReadySourceName(ModuleReadySource source) {
+    switch (source) {
+    case ModuleReadySource::AlreadyLoaded:
+        return "already loaded";
+    case ModuleReadySource::Notification:
+        return "loader notification";
+    case ModuleReadySource::Poll:
+        return "poll";
+    default:
+        return "timeout";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+
+// Waits for a module to be mapped into the process.
+// A loader DLL notification (LdrRegisterDllNotification) wakes the waiter the moment the module is
+// mapped; GetModuleHandle is re-checked with a bounded exponential backoff in case the notification
+// API is unavailable or the event is missed.
+namespace core {
+    constexpr DWORD MODULE_POLL_INITIAL_MS = 5;
+    constexpr DWORD MODULE_POLL_MAX_MS = 250;
+
+    /**
+     * @brief How the wait ended
+     */
+    enum class ModuleReadySource {
+        AlreadyLoaded,  // Loaded before the wait started
+        Notification,   // Loader notification fired
+        Poll,           // Found by a backoff re-check
+        Timeout
+    };
+
+    struct ModuleWaitResult {
+        HMODULE module = nullptr;
+        ModuleReadySource source = ModuleReadySource::Timeout;
+        double waitedMs = 0.0;
+        uint32_t polls = 0;             // Backoff re-checks performed
+        bool notificationsUsed = false; // LdrRegisterDllNotification was available
+    };
+
+    /**
+     * @brief Block until a module is mapped or the timeout expires
+     * Must not be called from DllMain (it waits on the loader).
+     * @param name Module file name, case-insensitive (e.g., "gameoverlayrenderer64.dll")
+     * @param timeoutMs Upper bound on the wait
+     * @return module is nullptr on timeout
+     */
+    ModuleWaitResult WaitForModule(const char* name, DWORD timeoutMs);
+
+    const char* ReadySourceName(ModuleReadySource source);
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "overlayHeap.h"
+#include "../debugMessage.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr size_t HEADER_SIZE = 16;          // Keeps every block 16-byte aligned
+    constexpr uint32_t OVERFLOW_CLASS = 0xFFFFFFFF;
+    constexpr uint32_t BLOCK_MAGIC = 0x4F564C48;  // "OVLH"
+
+    /**
+     * @brief Stored in front of every block
+     */
+    struct BlockHeader {
+        uint32_t sizeClass;     // Index into the free lists, or OVERFLOW_CLASS
+        uint32_t magic;
+        uint64_t blockBytes;
+    };
+
+    static_assert(sizeof(BlockHeader) == HEADER_SIZE, "Block header must keep 16-byte alignment");
+
+    /**
+     * @brief Smallest class whose blocks hold size bytes plus the header
+     * @return HEAP_CLASS_COUNT if no class is large enough
+     */
+    uint32_t SizeClass(size_t size) {
+        if (size > (static_cast<size_t>(1) << core::HEAP_MAX_CLASS_BITS) - HEADER_SIZE) {
+            return static_cast<uint32_t>(core::HEAP_CLASS_COUNT);
+        }
+        const size_t needed = size + HEADER_SIZE;
+        uint32_t bits = core::HEAP_MIN_CLASS_BITS;
+        while ((static_cast<size_t>(1) << bits) < needed) {
+            bits++;
+        }
+        return bits - core::HEAP_MIN_CLASS_BITS;
+    }
+
+    size_t ClassBytes(uint32_t sizeClass) {
+        return static_cast<size_t>(1) << (sizeClass + core::HEAP_MIN_CLASS_BITS);
+    }
+}
+
+core::OverlayHeap::OverlayHeap(size_t reserveBytes) {
+    base = static_cast<uint8_t*>(VirtualAlloc(nullptr, reserveBytes, MEM_RESERVE, PAGE_READWRITE));
+    reserved = base ? reserveBytes : 0;
+    stats.reservedBytes = reserved;
+    stats.overflowBudgetBytes = OVERLAY_HEAP_OVERFLOW_BUDGET;
+}
+
+core::OverlayHeap::~OverlayHeap() {
+    // Static destruction at unload: only give the range back if nothing still points into it
+    if (base && !stats.liveAllocations) {
+        VirtualFree(base, 0, MEM_RELEASE);
+    }
+}
+
+void* core::OverlayHeap::Carve(uint32_t sizeClass) {
+    const size_t bytes = ClassBytes(sizeClass);
+    if (bytes > reserved - carved) {
+        return nullptr;
+    }
+
+    if (carved + bytes > committed) {
+        size_t commitEnd = carved + bytes;
+        commitEnd = (commitEnd + OVERLAY_HEAP_COMMIT_STEP - 1) / OVERLAY_HEAP_COMMIT_STEP * OVERLAY_HEAP_COMMIT_STEP;
+        commitEnd = (std::min)(commitEnd, reserved);
+        currentSystemCalls++;
+        if (!VirtualAlloc(base + committed, commitEnd - committed, MEM_COMMIT, PAGE_READWRITE)) {
+            return nullptr;
+        }
+        committed = commitEnd;
+        stats.committedBytes = committed;
+    }
+
+    void* block = base + carved;
+    carved += bytes;
+    return block;
+}
+
+void* core::OverlayHeap::Allocate(size_t size) {
+    return AllocateBlock(size, false);
+}
+
+void* core::OverlayHeap::AllocateRequired(size_t size) {
+    return AllocateBlock(size, true);
+}
+
+void* core::OverlayHeap::AllocateBlock(size_t size, bool required) {
+    const uint32_t sizeClass = SizeClass(size);
+    bool budgetExceeded = false;
+    void* block = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        currentAllocations++;
+        stats.totalAllocations++;
+
+        size_t blockBytes = 0;
+        if (sizeClass < HEAP_CLASS_COUNT) {
+            blockBytes = ClassBytes(sizeClass);
+            if (FreeBlock* recycled = freeLists[sizeClass]) {
+                freeLists[sizeClass] = recycled->next;
+                stats.freeBytes -= blockBytes;
+                block = recycled;
+            } else {
+                block = Carve(sizeClass);
+            }
+        }
+
+        BlockHeader header = { sizeClass, BLOCK_MAGIC, blockBytes };
+        if (!block) {
+            // Too large for a class, or the range is full: the process heap, up to its own budget
+            blockBytes = size + HEADER_SIZE;
+            if (stats.overflowBytes + blockBytes > OVERLAY_HEAP_OVERFLOW_BUDGET) {
+                budgetExceeded = !overflowLogged;
+                overflowLogged = true;
+                if (!required) {
+                    stats.overflowRefused++;
+                }
+            }
+            if (stats.overflowBytes + blockBytes <= OVERLAY_HEAP_OVERFLOW_BUDGET || required) {
+                block = HeapAlloc(GetProcessHeap(), 0, blockBytes);
+            }
+            if (block) {
+                header = { OVERFLOW_CLASS, BLOCK_MAGIC, blockBytes };
+                stats.overflowAllocations++;
+                stats.overflowBytes += blockBytes;
+                currentSystemCalls++;
+            }
+        }
+
+        if (block) {
+            memcpy(block, &header, sizeof(header));
+            stats.liveAllocations++;
+            stats.liveBytes += blockBytes;
+            stats.peakLiveBytes = (std::max)(stats.peakLiveBytes, stats.liveBytes);
+        }
+    }
+
+    // Outside the lock: the logger may allocate
+    if (budgetExceeded) {
+        LOGWARN("Overlay heap overflow budget exceeded, request bytes", size);
+    }
+    return block ? static_cast<uint8_t*>(block) + HEADER_SIZE : nullptr;
+}
+
+void core::OverlayHeap::Free(void* pointer) {
+    if (!pointer) {
+        return;
+    }
+
+    uint8_t* block = static_cast<uint8_t*>(pointer) - HEADER_SIZE;
+    BlockHeader header;
+    memcpy(&header, block, sizeof(header));
+    if (header.magic != BLOCK_MAGIC) {
+        return;     // Not ours; leaking it is safer than corrupting a free list
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    stats.liveAllocations--;
+    stats.liveBytes -= header.blockBytes;
+    if (header.sizeClass == OVERFLOW_CLASS) {
+        stats.overflowBytes -= header.blockBytes;
+        HeapFree(GetProcessHeap(), 0, block);
+        return;
+    }
+
+    stats.freeBytes += header.blockBytes;
+    FreeBlock* freed = reinterpret_cast<FreeBlock*>(block);
+    freed->next = freeLists[header.sizeClass];
+    freeLists[header.sizeClass] = freed;
+}
+
+void core::OverlayHeap::EndFrame() {
+    std::lock_guard<std::mutex> guard(lock);
+    stats.frameAllocations = currentAllocations;
+    stats.frameSystemCalls = currentSystemCalls;
+    currentAllocations = 0;
+    currentSystemCalls = 0;
+}
+
+core::HeapStats core::OverlayHeap::Stats() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+}
+
+core::FrameArena::FrameArena(size_t capacity)
+    : memory(static_cast<uint8_t*>(GetOverlayHeap().Allocate(capacity))), capacity(memory ? capacity : 0) {
+}
+
+core::FrameArena::~FrameArena() {
+    GetOverlayHeap().Free(memory);
+}
+
+void* core::FrameArena::Allocate(size_t size, size_t alignment) {
+    const size_t start = (used + alignment - 1) & ~(alignment - 1);
+    if (start > capacity || size > capacity - start) {
+        return nullptr;
+    }
+    used = start + size;
+    peak = (std::max)(peak, used);
+    return memory + start;
+}
+
+core::OverlayHeap& core::GetOverlayHeap() {
+    static OverlayHeap heap(OVERLAY_HEAP_RESERVE);
+    return heap;
+}
+
+core::FrameArena& core::GetFrameArena() {
+    static FrameArena arena(FRAME_ARENA_SIZE);
+    return arena;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Private memory of the overlay: ImGui (through ImGui::SetAllocatorFunctions) and our own
+// containers allocate here instead of from the game's process heap.
+// One virtual range is reserved up front and committed as it fills; its size is the hard cap.
+// Blocks come in power-of-two size classes carved from the range and are recycled through per-class
+// free lists, so once the overlay has warmed up a frame makes no system calls at all. Requests
+// larger than the biggest class, or arriving after the range is full, go to the process heap as
+// overflow, which has its own budget: past it, Allocate fails (HeapAllocator throws) and only
+// AllocateRequired, used for ImGui (which cannot survive a null allocation), is still served.
+// Exceeding the budget is logged once.
+// Per-frame scratch comes from a FrameArena: a bump allocator reset at the start of each UI build.
+namespace core {
+    constexpr size_t OVERLAY_HEAP_RESERVE = 64 * 1024 * 1024;    // Hard cap of the private range
+    constexpr size_t OVERLAY_HEAP_COMMIT_STEP = 256 * 1024;      // Committed at a time
+    constexpr size_t OVERLAY_HEAP_OVERFLOW_BUDGET = 16 * 1024 * 1024; // Live process-heap bytes allowed
+    constexpr uint32_t HEAP_MIN_CLASS_BITS = 5;                  // 32-byte blocks (16-byte header + 16)
+    constexpr uint32_t HEAP_MAX_CLASS_BITS = 22;                 // 4 MB blocks
+    constexpr size_t HEAP_CLASS_COUNT = HEAP_MAX_CLASS_BITS - HEAP_MIN_CLASS_BITS + 1;
+    constexpr size_t FRAME_ARENA_SIZE = 64 * 1024;
+
+    /**
+     * @brief Memory accounting of the overlay heap
+     */
+    struct HeapStats {
+        uint64_t reservedBytes = 0;
+        uint64_t committedBytes = 0;
+        uint64_t liveBytes = 0;             // Blocks in use, headers and class rounding included
+        uint64_t peakLiveBytes = 0;
+        uint64_t freeBytes = 0;             // Carved from the range but waiting on a free list (fragmentation)
+        uint64_t liveAllocations = 0;
+        uint64_t totalAllocations = 0;
+        uint64_t frameAllocations = 0;      // Allocations during the last complete frame
+        uint64_t frameSystemCalls = 0;      // Commits and overflow allocations during the last frame
+        uint64_t overflowAllocations = 0;   // Served by the process heap (since start)
+        uint64_t overflowBytes = 0;         // Live process-heap bytes
+        uint64_t overflowBudgetBytes = 0;
+        uint64_t overflowRefused = 0;       // Allocations failed for being over the overflow budget
+    };
+
+    class OverlayHeap {
+    public:
+        /**
+         * @brief Reserve the range (nothing is committed yet)
+         */
+        explicit OverlayHeap(size_t reserveBytes);
+        ~OverlayHeap();
+
+        OverlayHeap(const OverlayHeap&) = delete;
+        OverlayHeap& operator=(const OverlayHeap&) = delete;
+
+        /**
+         * @brief 16-byte aligned block of at least size bytes (thread-safe)
+         * @return nullptr if the range is full and the overflow budget is spent, or the process heap fails
+         */
+        void* Allocate(size_t size);
+
+        /**
+         * @brief Allocate, served from the process heap even past the overflow budget (for ImGui)
+         * @return nullptr only if the process heap fails
+         */
+        void* AllocateRequired(size_t size);
+
+        /**
+         * @brief Return a block from Allocate (thread-safe; nullptr is ignored)
+         */
+        void Free(void* pointer);
+
+        /**
+         * @brief Close the current frame's counters (called once per UI build)
+         */
+        void EndFrame();
+
+        HeapStats Stats() const;
+
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        /**
+         * @brief New block of a class from the unused part of the range (lock held)
+         */
+        void* Carve(uint32_t sizeClass);
+
+        /**
+         * @param required Serve overflow past its budget
+         */
+        void* AllocateBlock(size_t size, bool required);
+
+        uint8_t* base = nullptr;
+        size_t reserved = 0;
+        size_t committed = 0;
+        size_t carved = 0;              // Bump offset of the next new block
+        bool overflowLogged = false;
+        FreeBlock* freeLists[HEAP_CLASS_COUNT] = {};
+
+        mutable std::mutex lock;
+        HeapStats stats;
+        uint64_t currentAllocations = 0;
+        uint64_t currentSystemCalls = 0;
+    };
+
+    /**
+     * @brief Bump allocator for data that lives until the end of the current UI build
+     * Not thread-safe: owned by the thread that builds the UI.
+     */
+    class FrameArena {
+    public:
+        explicit FrameArena(size_t capacity);
+        ~FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        /**
+         * @return nullptr when the arena is full (never falls back to a heap)
+         */
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        /**
+         * @brief Uninitialized array; only for types that need no destructor
+         */
+        template<typename T>
+        T* AllocateArray(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "Arena memory is released without destructors");
+            return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * @brief Release everything allocated since the previous Reset
+         */
+        void Reset() { used = 0; }
+
+        size_t Used() const { return used; }
+        size_t Peak() const { return peak; }
+        size_t Capacity() const { return capacity; }
+
+    private:
+        uint8_t* memory;
+        size_t capacity;
+        size_t used = 0;
+        size_t peak = 0;
+    };
+
+    /**
+     * @brief The overlay's heap (reserved on first use)
+     */
+    OverlayHeap& GetOverlayHeap();
+
+    /**
+     * @brief Scratch arena of the thread that builds the UI
+     */
+    FrameArena& GetFrameArena();
+
+    /**
+     * @brief Standard allocator over the overlay heap, for our own containers
+     * Throws std::bad_alloc once the range is full and the overflow budget is spent.
+     */
+    template<typename T>
+    struct HeapAllocator {
+        using value_type = T;
+
+        HeapAllocator() = default;
+        template<typename U>
+        HeapAllocator(const HeapAllocator<U>&) {}
+
+        T* allocate(size_t count) {
+            void* pointer = GetOverlayHeap().Allocate(count * sizeof(T));
+            if (!pointer) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(pointer);
+        }
+
+        void deallocate(T* pointer, size_t) { GetOverlayHeap().Free(pointer); }
+
+        template<typename U>
+        bool operator==(const HeapAllocator<U>&) const { return true; }
+        template<typename U>
+        bool operator!=(const HeapAllocator<U>&) const { return false; }
+    };
+
+    template<typename T>
+    using HeapVector = std::vector<T, HeapAllocator<T>>;
+}
\ No newline at end of file
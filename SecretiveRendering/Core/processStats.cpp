@@ -0,0 +1,42 @@
+#include "processStats.h"
+#include <psapi.h>
+#include "asyncLogger.h"
+
+namespace {
+    uint64_t ToUInt64(const FILETIME& time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+}
+
+core::ProcessStatsSampler::ProcessStatsSampler() {
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    processorCount = systemInfo.dwNumberOfProcessors ? systemInfo.dwNumberOfProcessors : 1;
+}
+
+bool core::ProcessStatsSampler::Sample(ProcessStats& stats) {
+    const HANDLE process = GetCurrentProcess();
+
+    FILETIME creationTime, exitTime, kernelTime, userTime, now;
+    if (!GetProcessTimes(process, &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return false;
+    }
+    GetSystemTimeAsFileTime(&now);
+
+    const uint64_t cpuTime = ToUInt64(kernelTime) + ToUInt64(userTime);
+    const uint64_t wallTime = ToUInt64(now);
+    if (lastWallTime && wallTime > lastWallTime) {
+        stats.cpuPercent = 100.0 * (cpuTime - lastCpuTime) / (static_cast<double>(wallTime - lastWallTime) * processorCount);
+    }
+    lastCpuTime = cpuTime;
+    lastWallTime = wallTime;
+
+    PROCESS_MEMORY_COUNTERS_EX memory = {};
+    if (GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&memory), sizeof(memory))) {
+        stats.workingSetBytes = memory.WorkingSetSize;
+        stats.privateBytes = memory.PrivateUsage;
+    }
+
+    stats.droppedLogRecords = GetLogger().DroppedCount();
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+
+// Resource usage of the game process, sampled by a background provider of the update scheduler
+// (the queries are syscalls and stay off the render thread).
+namespace core {
+    struct ProcessStats {
+        double cpuPercent = 0.0;            // Of all logical processors, since the previous sample
+        uint64_t workingSetBytes = 0;
+        uint64_t privateBytes = 0;
+        uint64_t droppedLogRecords = 0;
+    };
+
+    class ProcessStatsSampler {
+    public:
+        ProcessStatsSampler();
+
+        /**
+         * @brief Query the process counters
+         * @return false if the process could not be queried
+         */
+        bool Sample(ProcessStats& stats);
+
+    private:
+        uint64_t lastCpuTime = 0;           // 100 ns units, kernel + user
+        uint64_t lastWallTime = 0;
+        DWORD processorCount = 1;
+    };
+}
\ No newline at end of file
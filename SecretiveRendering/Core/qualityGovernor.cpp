@@ -0,0 +1,71 @@
+#include "qualityGovernor.h"
+
+const char* core::OverlayQualityName(OverlayQuality quality) {
+    switch (quality) {
+    case OverlayQuality::Full:
+        return "full";
+    case OverlayQuality::NoAntiAliasing:
+        return "no anti-aliasing";
+    case OverlayQuality::Essential:
+        return "essential";
+    case OverlayQuality::HalfRate:
+        return "half rate";
+    default:
+        return "unknown";
+    }
+}
+
+core::QualityGovernor::QualityGovernor(double targetFrameMs) : targetFrameMs(targetFrameMs) {
+}
+
+bool core::QualityGovernor::Update(double gameFrameMs) {
+    if (gameFrameMs <= 0.0 || gameFrameMs > GOVERNOR_MAX_FRAME_MS) {
+        return false;
+    }
+
+    double smoothed = primed ? smoothedFrameMs.load(std::memory_order_relaxed) : gameFrameMs;
+    smoothed += (gameFrameMs - smoothed) * GOVERNOR_SMOOTHING;
+    smoothedFrameMs.store(smoothed, std::memory_order_relaxed);
+    primed = true;
+
+    const double target = targetFrameMs.load(std::memory_order_relaxed);
+    if (smoothed > target * GOVERNOR_OVERLOAD_MARGIN) {
+        overloadedMs += gameFrameMs;
+        headroomMs = 0.0;
+    } else if (smoothed < target * GOVERNOR_RECOVER_RATIO) {
+        headroomMs += gameFrameMs;
+        overloadedMs = 0.0;
+    } else {
+        overloadedMs = 0.0;
+        headroomMs = 0.0;
+    }
+
+    const uint8_t current = static_cast<uint8_t>(Level());
+    if (overloadedMs >= GOVERNOR_STEP_DOWN_MS && current + 1 < static_cast<uint8_t>(OverlayQuality::Count)) {
+        level.store(static_cast<OverlayQuality>(current + 1), std::memory_order_relaxed);
+        stepsDown.fetch_add(1, std::memory_order_relaxed);
+        overloadedMs = 0.0;
+        return true;
+    }
+    if (headroomMs >= GOVERNOR_STEP_UP_MS && current > 0) {
+        level.store(static_cast<OverlayQuality>(current - 1), std::memory_order_relaxed);
+        stepsUp.fetch_add(1, std::memory_order_relaxed);
+        headroomMs = 0.0;
+        return true;
+    }
+    return false;
+}
+
+void core::QualityGovernor::Reset() {
+    overloadedMs = 0.0;
+    headroomMs = 0.0;
+    primed = false;
+    level.store(OverlayQuality::Full, std::memory_order_relaxed);
+}
+
+void core::QualityGovernor::SetTargetFrameMs(double frameMs) {
+    targetFrameMs.store(frameMs, std::memory_order_relaxed);
+    // Time accumulated against the old target says nothing about the new one
+    overloadedMs = 0.0;
+    headroomMs = 0.0;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Adapts the overlay's fidelity to the load the game is under.
+// Fed the game's own frame time once per Present (Present to Present, minus the hook's cost),
+// it steps the overlay down one quality level when the smoothed frame time stays more than
+// GOVERNOR_OVERLOAD_MARGIN above the target for GOVERNOR_STEP_DOWN_MS, and back up one level after
+// GOVERNOR_STEP_UP_MS of clear headroom (below GOVERNOR_RECOVER_RATIO of the target). The target is
+// the display's refresh interval, so a game presenting at its refresh rate (59.94 Hz on a 60 Hz
+// mode included) is never counted as overloaded. Stepping down is quick and stepping up slow, so a
+// level is never flipped back and forth by noise. Single writer (the render thread); the level and
+// the target can be read from any thread.
+namespace core {
+    constexpr double GOVERNOR_SMOOTHING = 0.1;          // Weight of the newest frame
+    constexpr double GOVERNOR_OVERLOAD_MARGIN = 1.10;   // Frame time over the target before a frame counts as overloaded
+    constexpr double GOVERNOR_RECOVER_RATIO = 0.85;
+    constexpr double GOVERNOR_STEP_DOWN_MS = 250.0;
+    constexpr double GOVERNOR_STEP_UP_MS = 2000.0;
+    constexpr double GOVERNOR_MAX_FRAME_MS = 250.0;     // Longer frames are loading screens or alt-tabs, not load
+
+    enum class OverlayQuality : uint8_t {
+        Full,
+        NoAntiAliasing,     // Anti-aliased lines and fills off
+        Essential,          // Also drops the live graph and non-essential callbacks
+        HalfRate,           // Also rebuilds the overlay on every other Present only
+        Count
+    };
+
+    const char* OverlayQualityName(OverlayQuality quality);
+
+    class QualityGovernor {
+    public:
+        explicit QualityGovernor(double targetFrameMs);
+
+        /**
+         * @brief Account one frame of the game (render thread)
+         * @param gameFrameMs The game's own frame time
+         * @return true if the level changed
+         */
+        bool Update(double gameFrameMs);
+
+        /**
+         * @brief Back to full quality with no history (the overlay was hidden)
+         */
+        void Reset();
+
+        /**
+         * @brief Follow a new display refresh interval (render thread)
+         * @param frameMs Frame time of one refresh
+         */
+        void SetTargetFrameMs(double frameMs);
+
+        OverlayQuality Level() const { return level.load(std::memory_order_relaxed); }
+        double TargetFrameMs() const { return targetFrameMs.load(std::memory_order_relaxed); }
+        double SmoothedFrameMs() const { return smoothedFrameMs.load(std::memory_order_relaxed); }
+        uint64_t StepsDown() const { return stepsDown.load(std::memory_order_relaxed); }
+        uint64_t StepsUp() const { return stepsUp.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> targetFrameMs;
+        double overloadedMs = 0.0;      // Time the smoothed frame time has been over the target
+        double headroomMs = 0.0;        // Time it has been clearly under it
+        bool primed = false;
+
+        std::atomic<OverlayQuality> level{ OverlayQuality::Full };
+        std::atomic<double> smoothedFrameMs{ 0.0 };
+        std::atomic<uint64_t> stepsDown{ 0 };
+        std::atomic<uint64_t> stepsUp{ 0 };
+    };
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "regionMap.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+bool core::RegionMap::Query(uintptr_t address, MemoryRegion& region, bool& committed) {
+    queryCount++;
+    committed = false;
+#ifdef _WIN32
+    MEMORY_BASIC_INFORMATION mbi;
+    if (!VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) || !mbi.RegionSize) {
+        return false;
+    }
+
+    region.begin = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+    region.end = region.begin + mbi.RegionSize;
+    region.protect = mbi.Protect;
+    committed = mbi.State == MEM_COMMIT;
+    return true;
+#else
+    (void)address;
+    (void)region;
+    return false;
+#endif
+}
+
+const core::MemoryRegion* core::RegionMap::FindLocked(uintptr_t address) const {
+    auto it = std::upper_bound(regions.begin(), regions.end(), address,
+        [](uintptr_t value, const MemoryRegion& region) { return value < region.begin; });
+    if (it == regions.begin()) {
+        return nullptr;
+    }
+    --it;
+    return address < it->end ? &*it : nullptr;
+}
+
+void core::RegionMap::EraseLocked(uintptr_t begin, uintptr_t end) {
+    regions.erase(std::remove_if(regions.begin(), regions.end(),
+        [begin, end](const MemoryRegion& region) { return region.begin < end && region.end > begin; }), regions.end());
+}
+
+void core::RegionMap::InsertLocked(const MemoryRegion& region) {
+    EraseLocked(region.begin, region.end);
+    auto it = std::lower_bound(regions.begin(), regions.end(), region.begin,
+        [](const MemoryRegion& existing, uintptr_t value) { return existing.begin < value; });
+    regions.insert(it, region);
+}
+
+size_t core::RegionMap::SnapshotLocked(uintptr_t begin, uintptr_t end) {
+    // Cached regions overlapping the range are dropped whole, so re-query all of them, not just the range
+    for (const MemoryRegion& region : regions) {
+        if (region.begin < end && region.end > begin) {
+            begin = (std::min)(begin, region.begin);
+            end = (std::max)(end, region.end);
+        }
+    }
+    EraseLocked(begin, end);
+
+    size_t inserted = 0;
+    uintptr_t address = begin;
+    while (address < end) {
+        MemoryRegion region;
+        bool committed = false;
+        if (!Query(address, region, committed) || region.end <= address) {
+            break;
+        }
+        if (committed) {
+            InsertLocked(region);
+            inserted++;
+        }
+        address = region.end;
+    }
+    return inserted;
+}
+
+size_t core::RegionMap::Snapshot(uintptr_t begin, uintptr_t end) {
+    std::unique_lock<std::shared_mutex> guard(lock);
+    if (begin >= end) {
+        return 0;
+    }
+
+    // Counted as inserted: the regions this replaces were erased first, so a size difference undercounts
+    const size_t recorded = SnapshotLocked(begin, end);
+
+    const bool tracked = std::any_of(trackedRanges.begin(), trackedRanges.end(),
+        [begin, end](const Range& range) { return range.begin == begin && range.end == end; });
+    if (!tracked) {
+        trackedRanges.push_back({ begin, end });
+    }
+    return recorded;
+}
+
+void core::RegionMap::Refresh() {
+    std::unique_lock<std::shared_mutex> guard(lock);
+    regions.clear();
+    for (const Range& range : trackedRanges) {
+        SnapshotLocked(range.begin, range.end);
+    }
+}
+
+void core::RegionMap::Refresh(uintptr_t begin, uintptr_t end) {
+    std::unique_lock<std::shared_mutex> guard(lock);
+    if (begin < end) {
+        SnapshotLocked(begin, end);
+    }
+}
+
+void core::RegionMap::Clear() {
+    std::unique_lock<std::shared_mutex> guard(lock);
+    regions.clear();
+    trackedRanges.clear();
+}
+
+bool core::RegionMap::Find(uintptr_t address, MemoryRegion& region) {
+    {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        if (const MemoryRegion* cached = FindLocked(address)) {
+            region = *cached;
+            return true;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> guard(lock);
+    if (const MemoryRegion* cached = FindLocked(address)) {
+        region = *cached;
+        return true;
+    }
+
+    // Only committed regions are cached; reserved/free memory may be committed later
+    bool committed = false;
+    if (!Query(address, region, committed) || !committed) {
+        return false;
+    }
+    InsertLocked(region);
+    return true;
+}
+
+bool core::RegionMap::IsExecutable(uintptr_t address) {
+    MemoryRegion region;
+    return address && Find(address, region) && region.IsExecutable();
+}
+
+bool core::RegionMap::IsReadable(uintptr_t address, size_t size) {
+    if (!address || address + size < address) {
+        return false;
+    }
+
+    const uintptr_t end = address + (size ? size : 1);
+    while (address < end) {
+        MemoryRegion region;
+        if (!Find(address, region) || !region.IsReadable()) {
+            return false;
+        }
+        address = region.end;
+    }
+    return true;
+}
+
+size_t core::RegionMap::RegionCount() const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return regions.size();
+}
+
+size_t core::RegionMap::QueryCount() const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return queryCount;
+}
+
+core::RegionMap& core::GetRegionMap() {
+    static RegionMap regionMap;
+    return regionMap;
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+// Cached view of the process address space.
+// Committed regions of the modules we care about are snapshotted once with VirtualQuery, then
+// validation is a binary search with no kernel transition. Addresses outside the snapshot are
+// queried once and cached. Call Refresh() after changing protections (hook install/removal).
+namespace core {
+    // Page protection flags (same values as PAGE_*)
+    constexpr uint32_t PROTECT_READONLY = 0x02;
+    constexpr uint32_t PROTECT_READWRITE = 0x04;
+    constexpr uint32_t PROTECT_WRITECOPY = 0x08;
+    constexpr uint32_t PROTECT_EXECUTE = 0x10;
+    constexpr uint32_t PROTECT_EXECUTE_READ = 0x20;
+    constexpr uint32_t PROTECT_EXECUTE_READWRITE = 0x40;
+    constexpr uint32_t PROTECT_EXECUTE_WRITECOPY = 0x80;
+    constexpr uint32_t PROTECT_GUARD = 0x100;
+    constexpr uint32_t PROTECT_NOACCESS = 0x01;
+
+    /**
+     * @brief One committed region [begin, end) with uniform protection
+     */
+    struct MemoryRegion {
+        uintptr_t begin = 0;
+        uintptr_t end = 0;
+        uint32_t protect = 0;
+
+        /**
+         * @brief Same test the hooks used on MEMORY_BASIC_INFORMATION::Protect
+         */
+        bool IsExecutable() const {
+            return (protect & (PROTECT_EXECUTE | PROTECT_EXECUTE_READ | PROTECT_EXECUTE_READWRITE)) != 0;
+        }
+
+        bool IsReadable() const {
+            return !(protect & (PROTECT_GUARD | PROTECT_NOACCESS)) && (protect & (PROTECT_READONLY | PROTECT_READWRITE |
+                PROTECT_WRITECOPY | PROTECT_EXECUTE_READ | PROTECT_EXECUTE_READWRITE | PROTECT_EXECUTE_WRITECOPY)) != 0;
+        }
+    };
+
+    class RegionMap {
+    public:
+        /**
+         * @brief Record every committed region in [begin, end) and keep the range for Refresh()
+         * @return Number of regions recorded
+         */
+        size_t Snapshot(uintptr_t begin, uintptr_t end);
+
+        /**
+         * @brief Re-query every snapshotted range (call after protections are known to change)
+         */
+        void Refresh();
+
+        /**
+         * @brief Re-query only [begin, end) and the full extent of the cached regions overlapping it
+         */
+        void Refresh(uintptr_t begin, uintptr_t end);
+
+        /**
+         * @brief Drop all cached regions and tracked ranges
+         */
+        void Clear();
+
+        /**
+         * @brief Committed region containing an address
+         * O(log n) on a hit; a miss costs one query, and the result is cached if committed.
+         * @return false if the address is not committed
+         */
+        bool Find(uintptr_t address, MemoryRegion& region);
+
+        /**
+         * @brief Replacement for VirtualQuery + PAGE_EXECUTE* checks
+         */
+        bool IsExecutable(uintptr_t address);
+
+        /**
+         * @brief true if every byte of [address, address + size) is committed and readable
+         */
+        bool IsReadable(uintptr_t address, size_t size);
+
+        size_t RegionCount() const;
+
+        /**
+         * @brief Number of system queries issued so far (snapshots, refreshes and misses)
+         */
+        size_t QueryCount() const;
+
+    private:
+        struct Range {
+            uintptr_t begin;
+            uintptr_t end;
+        };
+
+        bool Query(uintptr_t address, MemoryRegion& region, bool& committed);
+        /**
+         * @return Number of committed regions inserted
+         */
+        size_t SnapshotLocked(uintptr_t begin, uintptr_t end);
+        void InsertLocked(const MemoryRegion& region);
+        void EraseLocked(uintptr_t begin, uintptr_t end);
+        const MemoryRegion* FindLocked(uintptr_t address) const;
+
+        mutable std::shared_mutex lock;
+        std::vector<MemoryRegion> regions;  // Sorted by begin, non-overlapping
+        std::vector<Range> trackedRanges;
+        size_t queryCount = 0;
+    };
+
+    /**
+     * @brief Process-wide region map used by all address validation
+     */
+    RegionMap& GetRegionMap();
+}
\ No newline at end of file
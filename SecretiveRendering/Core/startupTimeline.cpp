@@ -0,0 +1,33 @@
+#include "startupTimeline.h"
+#include "traceRecorder.h"
+#include "../debugMessage.h"
+
+core::StartupTimeline::StartupTimeline() : start(Clock::now()) {
+}
+
+double core::StartupTimeline::Mark(const char* name) {
+    const double ms = Elapsed();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stages.push_back({ name, ms });
+    }
+    GetTraceRecorder().Instant(name);
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+    GetLogger().Write(LogLevel::Info, name, ms);
+#endif
+    return ms;
+}
+
+double core::StartupTimeline::Elapsed() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::vector<core::StartupStage> core::StartupTimeline::Stages() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return stages;
+}
+
+core::StartupTimeline& core::GetStartupTimeline() {
+    static StartupTimeline timeline;
+    return timeline;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Timestamps of the startup sequence (injection -> overlay module -> signatures -> hooks -> first frame).
+// Every stage is logged as it is reached, in milliseconds since the timeline was created in fMain,
+// and marked as an instant in the trace (see traceRecorder.h).
+namespace core {
+    /**
+     * @brief One reached startup stage
+     */
+    struct StartupStage {
+        const char* name;   // String literal
+        double ms;          // Since injection
+    };
+
+    class StartupTimeline {
+    public:
+        StartupTimeline();
+
+        /**
+         * @brief Record and log a stage (thread-safe; the render thread marks the first frame)
+         * @param name String literal, e.g. "Startup (ms): hooks enabled"
+         * @return Milliseconds since injection
+         */
+        double Mark(const char* name);
+
+        /**
+         * @brief Milliseconds since injection
+         */
+        double Elapsed() const;
+
+        std::vector<StartupStage> Stages() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point start;
+        mutable std::mutex lock;
+        std::vector<StartupStage> stages;
+    };
+
+    /**
+     * @brief Timeline of this injection (created on first use, i.e. at the top of fMain)
+     */
+    StartupTimeline& GetStartupTimeline();
+}
\ No newline at end of file
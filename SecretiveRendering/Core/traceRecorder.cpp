@@ -0,0 +1,180 @@
+#include "traceRecorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    uint32_t CurrentThreadId() {
+#ifdef _WIN32
+        return GetCurrentThreadId();
+#else
+        static thread_local const uint32_t id = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return id;
+#endif
+    }
+
+    uint32_t CurrentProcessId() {
+#ifdef _WIN32
+        return GetCurrentProcessId();
+#else
+        return static_cast<uint32_t>(getpid());
+#endif
+    }
+
+    /**
+     * @brief Copy a slot that may be rewritten while it is read
+     * @return false if it was never written or changed during the copy
+     */
+    template<typename Slot>
+    bool ReadSlot(const Slot& slot, uint64_t expected, core::TraceEvent& event) {
+        if (slot.sequence.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+        event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == expected;
+    }
+
+    void WriteJsonString(FILE* file, const char* text) {
+        fputc('"', file);
+        for (const char* c = text ? text : ""; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                fputc('\\', file);
+                fputc(*c, file);
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                fprintf(file, "\\u%04x", *c);
+            } else {
+                fputc(*c, file);
+            }
+        }
+        fputc('"', file);
+    }
+}
+
+void core::TraceRecorder::Record(const TraceEvent& event, bool pinned) {
+    if (pinned || startupOpen.load(std::memory_order_relaxed)) {
+        const uint64_t index = startupCount.fetch_add(1, std::memory_order_relaxed);
+        if (index >= TRACE_STARTUP_CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Slot& slot = startup[index];
+        slot.event = event;
+        slot.sequence.store(2, std::memory_order_release);
+        return;
+    }
+
+    // Per-slot sequence lock: odd while written, 2 * (index + 1) once complete
+    const uint64_t index = ringHead.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = ring[index % TRACE_RING_CAPACITY];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+void core::TraceRecorder::Complete(const char* name, int64_t start, int64_t end) {
+    Record({ name, start, end - start, 0.0, CurrentThreadId(), TracePhase::Complete }, false);
+}
+
+void core::TraceRecorder::Instant(const char* name) {
+    Record({ name, FrameProfiler::Now(), 0, 0.0, CurrentThreadId(), TracePhase::Instant }, false);
+}
+
+void core::TraceRecorder::Counter(const char* name, double value) {
+    Record({ name, FrameProfiler::Now(), 0, value, CurrentThreadId(), TracePhase::Counter }, false);
+}
+
+void core::TraceRecorder::NameThread(const char* name) {
+    Record({ name, FrameProfiler::Now(), 0, 0.0, CurrentThreadId(), TracePhase::ThreadName }, true);
+}
+
+uint64_t core::TraceRecorder::Recorded() const {
+    const uint64_t startupEvents = (std::min)(startupCount.load(std::memory_order_relaxed), static_cast<uint64_t>(TRACE_STARTUP_CAPACITY));
+    return startupEvents + ringHead.load(std::memory_order_relaxed);
+}
+
+bool core::TraceRecorder::ExportJson(const std::string& path) const {
+    std::vector<TraceEvent> events;
+    events.reserve(TRACE_STARTUP_CAPACITY + TRACE_RING_CAPACITY);
+
+    TraceEvent event;
+    const uint64_t startupEvents = (std::min)(startupCount.load(std::memory_order_acquire), static_cast<uint64_t>(TRACE_STARTUP_CAPACITY));
+    for (uint64_t i = 0; i < startupEvents; i++) {
+        if (ReadSlot(startup[i], 2, event)) {
+            events.push_back(event);
+        }
+    }
+    const uint64_t head = ringHead.load(std::memory_order_acquire);
+    for (uint64_t i = head > TRACE_RING_CAPACITY ? head - TRACE_RING_CAPACITY : 0; i < head; i++) {
+        if (ReadSlot(ring[i % TRACE_RING_CAPACITY], 2 * i + 2, event)) {
+            events.push_back(event);
+        }
+    }
+    if (events.empty()) {
+        return false;
+    }
+
+    FILE* file = nullptr;
+#ifdef _WIN32
+    if (fopen_s(&file, path.c_str(), "w") != 0) {
+        return false;
+    }
+#else
+    file = fopen(path.c_str(), "w");
+#endif
+    if (!file) {
+        return false;
+    }
+
+    // Timestamps relative to the earliest event (spans may start before the recorder existed)
+    int64_t base = events[0].start;
+    for (const TraceEvent& retained : events) {
+        base = (std::min)(base, retained.start);
+    }
+    const FrameProfiler& profiler = GetFrameProfiler();
+    const uint32_t processId = CurrentProcessId();
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& retained = events[i];
+        if (retained.phase == TracePhase::ThreadName) {
+            fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":", processId, retained.threadId);
+            WriteJsonString(file, retained.name);
+            fprintf(file, "}}");
+        } else {
+            fprintf(file, "{\"name\":");
+            WriteJsonString(file, retained.name);
+            fprintf(file, ",\"ph\":\"%c\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f", static_cast<char>(retained.phase), processId,
+                retained.threadId, profiler.TicksToNanoseconds(retained.start - base) / 1000.0);
+            if (retained.phase == TracePhase::Complete) {
+                fprintf(file, ",\"dur\":%.3f", profiler.TicksToNanoseconds(retained.duration) / 1000.0);
+            } else if (retained.phase == TracePhase::Instant) {
+                fprintf(file, ",\"s\":\"t\"");
+            } else if (retained.phase == TracePhase::Counter) {
+                fprintf(file, ",\"args\":{\"value\":%.6g}", std::isfinite(retained.value) ? retained.value : 0.0);
+            }
+            fprintf(file, "}");
+        }
+        fprintf(file, i + 1 < events.size() ? ",\n" : "\n");
+    }
+    fprintf(file, "]}\n");
+
+    const bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+core::TraceRecorder& core::GetTraceRecorder() {
+    static TraceRecorder recorder;
+    return recorder;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "frameProfiler.h"
+
+// Timeline of spans, instants and counters, exported as Chrome trace-event JSON
+// (chrome://tracing, ui.perfetto.dev).
+// Recording is a slot claim with one atomic add and a copy of the event: no lock, no allocation,
+// no formatting. Events up to EndStartup() (the first overlay frame) are kept in a buffer that
+// never wraps, so the whole startup sequence survives; later events, such as per-frame spans, go
+// to a ring that keeps the most recent TRACE_RING_CAPACITY. Event names must be string literals.
+// Timestamps are FrameProfiler::Now() ticks, so spans can reuse ticks the profiler already took.
+namespace core {
+    constexpr size_t TRACE_STARTUP_CAPACITY = 2048;
+    constexpr size_t TRACE_RING_CAPACITY = 16384;   // A few seconds of per-frame spans
+
+    enum class TracePhase : char {
+        Complete = 'X',     // Span with a duration
+        Instant = 'i',
+        Counter = 'C',
+        ThreadName = 'M'    // Metadata: name of the recording thread
+    };
+
+    struct TraceEvent {
+        const char* name;
+        int64_t start;      // FrameProfiler::Now() ticks
+        int64_t duration;   // Ticks (Complete only)
+        double value;       // Counter only
+        uint32_t threadId;
+        TracePhase phase;
+    };
+
+    class TraceRecorder {
+    public:
+        TraceRecorder() = default;
+
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        /**
+         * @brief Span between two FrameProfiler::Now() ticks on the calling thread
+         */
+        void Complete(const char* name, int64_t start, int64_t end);
+
+        void Instant(const char* name);
+
+        void Counter(const char* name, double value);
+
+        /**
+         * @brief Name the calling thread in the trace (kept even after startup)
+         */
+        void NameThread(const char* name);
+
+        /**
+         * @brief Close the startup buffer; later events go to the ring
+         */
+        void EndStartup() { startupOpen.store(false, std::memory_order_release); }
+
+        /**
+         * @brief Write every retained event as trace-event JSON (any thread; recording may go on)
+         * @return false if the file could not be written
+         */
+        bool ExportJson(const std::string& path) const;
+
+        /**
+         * @brief Events recorded since injection (ring events may since have been overwritten)
+         */
+        uint64_t Recorded() const;
+
+        /**
+         * @brief Startup events lost to a full startup buffer
+         */
+        uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> sequence{ 0 };    // Odd while written; 0 if never written
+            TraceEvent event;
+        };
+
+        void Record(const TraceEvent& event, bool pinned);
+
+        Slot startup[TRACE_STARTUP_CAPACITY];
+        Slot ring[TRACE_RING_CAPACITY];
+        std::atomic<uint64_t> startupCount{ 0 };
+        std::atomic<uint64_t> ringHead{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<bool> startupOpen{ true };
+    };
+
+    /**
+     * @brief Trace of this injection
+     */
+    TraceRecorder& GetTraceRecorder();
+
+    /**
+     * @brief Records the lifetime of the scope as a span
+     */
+    class TraceScope {
+    public:
+        explicit TraceScope(const char* name) : name(name), start(FrameProfiler::Now()) {}
+        ~TraceScope() { GetTraceRecorder().Complete(name, start, FrameProfiler::Now()); }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+        const char* name;
+        int64_t start;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-over of whole values from one producer thread to one consumer thread.
+// Three slots: the producer fills its back slot and swaps it with the shared middle slot; the
+// consumer swaps its front slot with the middle one when a newer value is there. Neither side
+// ever waits for the other, and the consumer always gets the newest finished value (values it
+// had no time to pick up are skipped, not queued).
+namespace core {
+    template<typename T>
+    class TripleBuffer {
+    public:
+        /**
+         * @brief Slot the producer fills next (producer thread only)
+         */
+        T& WriteBuffer() { return slots[back]; }
+
+        /**
+         * @brief Hand the filled slot to the consumer (producer thread only)
+         * @return true if it replaced a value the consumer never picked up
+         */
+        bool Publish() {
+            const uint8_t previous = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel);
+            back = previous & INDEX_MASK;
+            return (previous & FRESH) != 0;
+        }
+
+        /**
+         * @brief Take the newest published value if there is one (consumer thread only)
+         * @return true if ReadBuffer() now holds a value it did not hold before
+         */
+        bool Acquire() {
+            // Relaxed check first: without a new value the shared line is never written
+            if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+                return false;
+            }
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+            return true;
+        }
+
+        /**
+         * @brief Value taken by the last successful Acquire (consumer thread only)
+         */
+        T& ReadBuffer() { return slots[front]; }
+
+        /**
+         * @brief Reset every slot to T() (only while neither thread uses the buffer)
+         */
+        void Reset() {
+            for (T& slot : slots) {
+                slot = T();
+            }
+            back = 0;
+            middle.store(1, std::memory_order_relaxed);
+            front = 2;
+        }
+
+    private:
+        static constexpr uint8_t INDEX_MASK = 0x3;
+        static constexpr uint8_t FRESH = 0x4;   // The middle slot holds a value not yet acquired
+
+        T slots[3];
+        uint8_t back = 0;
+        std::atomic<uint8_t> middle{ 1 };
+        uint8_t front = 2;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "updateScheduler.h"
+#include "traceRecorder.h"
+
+#include <algorithm>
+
+core::UpdateScheduler::~UpdateScheduler() {
+    // Only reached at DLL unload; a thread still running there cannot be joined under the loader lock
+    if (backgroundThread.joinable()) {
+        backgroundThread.detach();
+    }
+}
+
+void core::UpdateScheduler::Register(const char* name, double periodMs, UpdateThread thread, std::function<void()> update) {
+    auto provider = std::make_unique<Provider>();
+    provider->name = name;
+    provider->period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(periodMs));
+    provider->thread = thread;
+    provider->update = std::move(update);
+    provider->due = Clock::time_point::min();
+
+    if (thread == UpdateThread::Render) {
+        renderProviders.push_back(std::move(provider));
+        nextRenderDue = Clock::time_point::min();
+    } else {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        backgroundProviders.push_back(std::move(provider));
+    }
+}
+
+void core::UpdateScheduler::RunDue(std::vector<std::unique_ptr<Provider>>& providers, Clock::time_point& nextDue) {
+    Clock::time_point earliest = Clock::time_point::max();
+    for (auto& provider : providers) {
+        const Clock::time_point now = Clock::now();
+        if (now >= provider->due) {
+            provider->update();
+            const Clock::time_point end = Clock::now();
+
+            const int64_t costNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - now).count();
+            provider->runs.fetch_add(1, std::memory_order_relaxed);
+            provider->lastCostNs.store(costNs, std::memory_order_relaxed);
+            if (costNs > provider->maxCostNs.load(std::memory_order_relaxed)) {
+                provider->maxCostNs.store(costNs, std::memory_order_relaxed);
+            }
+
+            // Keep the cadence, but a provider that fell a whole period behind restarts from now
+            // instead of running back to back to catch up
+            provider->due += provider->period;
+            if (provider->due <= now) {
+                provider->due = now + provider->period;
+            }
+        }
+        earliest = (std::min)(earliest, provider->due);
+    }
+    nextDue = earliest;
+}
+
+void core::UpdateScheduler::Start() {
+    if (backgroundThread.joinable()) {
+        return;
+    }
+    stopping = false;
+    backgroundThread = std::thread(&UpdateScheduler::BackgroundLoop, this);
+}
+
+void core::UpdateScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (backgroundThread.joinable()) {
+        backgroundThread.join();
+    }
+}
+
+void core::UpdateScheduler::BackgroundLoop() {
+    GetTraceRecorder().NameThread("Update scheduler");
+    std::unique_lock<std::mutex> guard(sleepLock);
+    while (!stopping) {
+        Clock::time_point nextDue;
+        guard.unlock();
+        RunDue(backgroundProviders, nextDue);
+        guard.lock();
+
+        if (nextDue == Clock::time_point::max()) {
+            wakeUp.wait(guard, [this]() { return stopping; });
+        } else {
+            wakeUp.wait_until(guard, nextDue, [this]() { return stopping; });
+        }
+    }
+}
+
+size_t core::UpdateScheduler::Stats(ProviderStats* out, size_t capacity) const {
+    size_t count = 0;
+    for (const auto* providers : { &renderProviders, &backgroundProviders }) {
+        for (const auto& provider : *providers) {
+            if (count == capacity) {
+                return count;
+            }
+            out[count++] = { provider->name, std::chrono::duration<double, std::milli>(provider->period).count(), provider->thread,
+                provider->runs.load(std::memory_order_relaxed),
+                provider->lastCostNs.load(std::memory_order_relaxed) / 1000.0,
+                provider->maxCostNs.load(std::memory_order_relaxed) / 1000.0 };
+        }
+    }
+    return count;
+}
+
+core::UpdateScheduler& core::GetUpdateScheduler() {
+    static UpdateScheduler scheduler;
+    return scheduler;
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Runs overlay data providers at their own rates instead of once per Present.
+// Each provider declares a period and a thread. Render-thread providers run from hkPresent when
+// due (a single clock compare when nothing is); background providers run on the scheduler's
+// thread and publish their results through a Snapshot (seqlock), which hkPresent reads without
+// waiting. Register every provider before Start; Start/Stop from fMain (joining under the loader
+// lock in DllMain deadlocks).
+namespace core {
+    constexpr int SNAPSHOT_READ_ATTEMPTS = 4;   // A reader never spins longer than this
+
+    /**
+     * @brief Single-writer value readable from any thread without locks (seqlock)
+     * The reader retries a few times if it overlaps a write and otherwise keeps its old copy.
+     */
+    template<typename T>
+    class Snapshot {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot values are copied with memcpy");
+
+    public:
+        /**
+         * @brief Publish a new value (one writer thread only)
+         */
+        void Publish(const T& value) {
+            const uint32_t current = sequence.load(std::memory_order_relaxed);
+            sequence.store(current + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            memcpy(&data, &value, sizeof(T));
+            sequence.store(current + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Copy the latest value
+         * @return false if nothing was published yet or every attempt overlapped a write
+         */
+        bool TryRead(T& value) const {
+            for (int attempt = 0; attempt < SNAPSHOT_READ_ATTEMPTS; attempt++) {
+                const uint32_t before = sequence.load(std::memory_order_acquire);
+                if (before & 1) {
+                    continue;
+                }
+                memcpy(&value, &data, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    return before != 0;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Number of values published (compare to skip reading an unchanged snapshot)
+         */
+        uint32_t Version() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+    private:
+        std::atomic<uint32_t> sequence{ 0 };    // Odd while a write is in progress
+        T data{};
+    };
+
+    enum class UpdateThread : uint8_t {
+        Render,         // From hkPresent (cheap work on render-thread data)
+        Background      // On the scheduler thread (syscalls, anything slow)
+    };
+
+    /**
+     * @brief Run statistics of one provider
+     */
+    struct ProviderStats {
+        const char* name;
+        double periodMs;
+        UpdateThread thread;
+        uint64_t runs;
+        double lastCostUs;
+        double maxCostUs;
+    };
+
+    class UpdateScheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        UpdateScheduler() = default;
+        ~UpdateScheduler();
+
+        UpdateScheduler(const UpdateScheduler&) = delete;
+        UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+
+        /**
+         * @brief Add a provider; it first runs as soon as its thread gets to it
+         * @param name Name for statistics (must outlive the scheduler)
+         * @param periodMs Time between runs
+         * @param thread Where update runs
+         * @param update The provider
+         */
+        void Register(const char* name, double periodMs, UpdateThread thread, std::function<void()> update);
+
+        /**
+         * @brief Run the render-thread providers that are due (call once per Present)
+         */
+        void RunRenderUpdates() {
+            if (Clock::now() >= nextRenderDue) {
+                RunDue(renderProviders, nextRenderDue);
+            }
+        }
+
+        /**
+         * @brief Start the background thread
+         */
+        void Start();
+
+        /**
+         * @brief Stop and join the background thread
+         */
+        void Stop();
+
+        size_t ProviderCount() const { return renderProviders.size() + backgroundProviders.size(); }
+
+        /**
+         * @brief Copy the statistics of up to capacity providers (no allocation)
+         * @return Number of entries written
+         */
+        size_t Stats(ProviderStats* out, size_t capacity) const;
+
+    private:
+        struct Provider {
+            const char* name;
+            Clock::duration period;
+            UpdateThread thread;
+            std::function<void()> update;
+            Clock::time_point due;
+            std::atomic<uint64_t> runs{ 0 };
+            std::atomic<int64_t> lastCostNs{ 0 };
+            std::atomic<int64_t> maxCostNs{ 0 };
+        };
+
+        /**
+         * @brief Run the due providers of a list and move nextDue to its earliest deadline
+         */
+        static void RunDue(std::vector<std::unique_ptr<Provider>>& providers, Clock::time_point& nextDue);
+        void BackgroundLoop();
+
+        std::vector<std::unique_ptr<Provider>> renderProviders;
+        std::vector<std::unique_ptr<Provider>> backgroundProviders;
+        Clock::time_point nextRenderDue = Clock::time_point::min();
+
+        std::thread backgroundThread;
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+        bool stopping = false;
+    };
+
+    /**
+     * @brief Scheduler of the overlay's providers
+     */
+    UpdateScheduler& GetUpdateScheduler();
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "workerPool.h"
+
+namespace {
+    std::mutex g_sharedPoolLock;
+    std::unique_ptr<core::WorkerPool> g_sharedPool;
+    bool g_sharedPoolShutDown = false;
+}
+
+core::WorkerPool::WorkerPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    for (size_t i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&WorkerPool::WorkerLoop, this, i);
+    }
+}
+
+core::WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void core::WorkerPool::Submit(std::function<void()> task) {
+    // Count the task before publishing it so the counter never dips below the queued total
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        pendingTasks.fetch_add(1, std::memory_order_release);
+    }
+
+    const size_t index = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wakeUp.notify_one();
+}
+
+bool core::WorkerPool::PopTask(size_t preferredQueue, std::function<void()>& task) {
+    // Own queue first (LIFO keeps recently split work cache-warm), then steal FIFO from the others
+    {
+        WorkQueue& own = *queues[preferredQueue];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < queues.size(); i++) {
+        WorkQueue& victim = *queues[(preferredQueue + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool core::WorkerPool::RunPendingTask() {
+    if (pendingTasks.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    std::function<void()> task;
+    const size_t start = nextQueue.load(std::memory_order_relaxed) % queues.size();
+    if (!PopTask(start, task)) {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+void core::WorkerPool::WorkerLoop(size_t index) {
+    for (;;) {
+        std::function<void()> task;
+        if (PopTask(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this]() {
+            return stopping.load() || pendingTasks.load(std::memory_order_acquire) != 0;
+        });
+
+        if (stopping && pendingTasks.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void core::TaskGroup::Run(std::function<void()> task) {
+    outstanding.fetch_add(1, std::memory_order_relaxed);
+    pool.Submit([this, task = std::move(task)]() {
+        // An escaping exception would kill the worker, and the group would wait for it forever
+        try {
+            task();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        outstanding.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void core::TaskGroup::Wait() {
+    Drain();
+
+    std::exception_ptr thrown;
+    {
+        std::lock_guard<std::mutex> guard(errorLock);
+        thrown = std::move(error);
+        error = nullptr;
+    }
+    if (thrown) {
+        std::rethrow_exception(thrown);
+    }
+}
+
+void core::TaskGroup::Drain() {
+    while (outstanding.load(std::memory_order_acquire) != 0) {
+        // Help out instead of sleeping; if nothing is queued our tasks are running elsewhere
+        if (!pool.RunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+core::WorkerPool* core::GetWorkerPool() {
+    std::lock_guard<std::mutex> guard(g_sharedPoolLock);
+    if (!g_sharedPool && !g_sharedPoolShutDown) {
+        const size_t hardwareThreads = std::thread::hardware_concurrency();
+        size_t threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        if (threadCount > MAX_WORKER_THREADS) {
+            threadCount = MAX_WORKER_THREADS;
+        }
+        g_sharedPool = std::make_unique<WorkerPool>(threadCount);
+    }
+    return g_sharedPool.get();
+}
+
+void core::ShutdownWorkerPool() {
+    std::unique_ptr<WorkerPool> pool;
+    {
+        std::lock_guard<std::mutex> guard(g_sharedPoolLock);
+        pool = std::move(g_sharedPool);
+        g_sharedPoolShutDown = true;
+    }
+    // Destructor joins the workers outside the lock
+}
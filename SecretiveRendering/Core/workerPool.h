@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing thread pool shared by startup work (pattern scanning, cache loading, ...).
+// Created once on first use and reused; must be shut down from fMain before the DLL unloads,
+// because joining threads under the loader lock in DllMain deadlocks. Once shut down it stays
+// down: GetWorkerPool() returns nullptr and callers drop or inline their work.
+namespace core {
+    constexpr size_t MAX_WORKER_THREADS = 4;
+
+    class WorkerPool {
+    public:
+        /**
+         * @brief Start the worker threads
+         * @param threadCount Number of workers (at least 1)
+         */
+        explicit WorkerPool(size_t threadCount);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        /**
+         * @brief Queue a task; workers pick it up or steal it from each other
+         */
+        void Submit(std::function<void()> task);
+
+        /**
+         * @brief Run one queued task on the calling thread if any is available
+         * Used by waiters so a blocked caller (including a worker) keeps the pool moving.
+         * @return true if a task was executed
+         */
+        bool RunPendingTask();
+
+        size_t ThreadCount() const { return workers.size(); }
+
+    private:
+        struct WorkQueue {
+            std::mutex lock;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        bool PopTask(size_t preferredQueue, std::function<void()>& task);
+        void WorkerLoop(size_t index);
+
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        std::vector<std::thread> workers;
+        std::atomic<size_t> nextQueue{ 0 };
+        std::atomic<size_t> pendingTasks{ 0 };
+        std::atomic<bool> stopping{ false };
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+    };
+
+    /**
+     * @brief Set of tasks that can be waited on together
+     * Wait() executes queued work while it waits instead of blocking a thread. A task that throws
+     * still counts as finished; the first exception is rethrown by Wait().
+     */
+    class TaskGroup {
+    public:
+        explicit TaskGroup(WorkerPool& pool) : pool(pool) {}
+        ~TaskGroup() { Drain(); }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        void Run(std::function<void()> task);
+
+        /**
+         * @brief Wait for every task, then rethrow the first exception one of them threw
+         */
+        void Wait();
+
+    private:
+        /**
+         * @brief Wait for every task without rethrowing (destructor)
+         */
+        void Drain();
+
+        WorkerPool& pool;
+        std::atomic<size_t> outstanding{ 0 };
+        std::mutex errorLock;
+        std::exception_ptr error;
+    };
+
+    /**
+     * @brief Run fn(index) for every index in [0, count) on the pool and wait for completion
+     */
+    template<typename Fn>
+    inline void ParallelFor(WorkerPool& pool, size_t count, Fn&& fn) {
+        TaskGroup group(pool);
+        for (size_t i = 0; i < count; i++) {
+            group.Run([&fn, i]() { fn(i); });
+        }
+        group.Wait();
+    }
+
+    /**
+     * @brief Shared pool, created on first use with min(hardware threads - 1, MAX_WORKER_THREADS) workers
+     * @return nullptr once ShutdownWorkerPool() has run (threads started then would never be joined)
+     */
+    WorkerPool* GetWorkerPool();
+
+    /**
+     * @brief Stop and join the shared pool for good (call from fMain before FreeLibraryAndExitThread)
+     */
+    void ShutdownWorkerPool();
+}
@@ -1,8 +1,5 @@
 #include "basicHook.h"
 
-#define REGISTER_HOOK(pTarget, pDetour, ppOriginal) Hook(pTarget, pDetour, ppOriginal); \
-originalFunctions.push_back(pTarget);
-
 // 64-bit function signatures for TF2 Steam overlay
 using tPresent = HRESULT(STDMETHODCALLTYPE*) (IDirect3DDevice9*, const RECT*, const RECT*, HWND, const RGNDATA*);
 using tReset = HRESULT (STDMETHODCALLTYPE*) (IDirect3DDevice9*, D3DPRESENT_PARAMETERS*);
@@ -17,6 +14,92 @@ tReset oReset = nullptr;
 static bool g_overlayVisible = true;
 static bool g_initialized = false;
 
+// Present-to-Present frame rate shown by the overlay
+static hud::FrameRateMeter g_frameRate;
+static int64_t g_lastPresentTicks = 0;
+
+// Process counters published by a background provider; hkPresent keeps the last copy it read
+static core::Snapshot<core::ProcessStats> g_processStats;
+static core::ProcessStats g_processView;
+static uint32_t g_processVersion = 0;
+
+// Draws the overlay with persistent buffers and recorded state blocks (replaces ImGui_ImplDX9_RenderDrawData)
+static std::unique_ptr<render::Dx9Renderer> g_renderer;
+
+// Overlay fidelity from the game's frame time; the render thread feeds it, the UI build reads the level
+static core::QualityGovernor g_governor(TF2Config::GOVERNOR_TARGET_FRAME_MS);
+static int64_t g_lastHookTicks = 0;         // Our share of the previous frame (hook minus the original Present)
+static uint64_t g_presentCount = 0;
+static double g_skippedMs = 0.0;            // Time of Presents that did not rebuild the overlay
+
+// Where hkPresent goes: PresentOverlay, or the original Present itself while the overlay is hidden
+static HRESULT STDMETHODCALLTYPE PresentOverlay(IDirect3DDevice9* thisptr, const RECT* src, const RECT* dest, HWND wnd_override, const RGNDATA* dirty_region);
+static std::atomic<tPresent> g_presentPath{ &PresentOverlay };
+
+/**
+ * @brief What the overlay shows, collected by hkPresent
+ * The UI thread, when it builds the overlay, reads the copy published every Present.
+ */
+struct OverlayData {
+    double fps;
+    core::ProcessStats process;
+    core::StageSummary stages[core::FRAME_STAGE_COUNT];
+    float overheadHistory[core::FRAME_HISTORY];
+    size_t historyOffset;
+    render::RenderStats renderStats;
+};
+static OverlayData g_presentData = {};
+static core::Snapshot<OverlayData> g_overlayData;
+
+// Overlay buttons only post requests; hkPresent owns the profiler and the visibility flag
+static std::atomic<bool> g_hideRequested{ false };
+static std::atomic<bool> g_exportRequested{ false };
+static std::atomic<bool> g_resetRequested{ false };
+static std::atomic<bool> g_traceRequested{ false };
+
+/**
+ * @brief Time of each ImGui stage of one overlay build (performance counter ticks)
+ */
+struct BuildTimings {
+    int64_t newFrame = 0;
+    int64_t buildUi = 0;
+    int64_t render = 0;
+};
+
+/**
+ * @brief Resolve the Steam function referenced by the LEA instruction preceding a pattern hit
+ * The instructions before the hit are decoded backwards to the nearest RIP-relative LEA (any
+ * register), so only the final target needs a memory query.
+ * @param patternAddr Address where the call pattern was found
+ * @param resolvedOffset Optional; receives the offset of the LEA that resolved
+ * @return Steam function address, or 0 if no valid LEA was found
+ */
+static uintptr_t ResolveFunctionFromPattern(uintptr_t patternAddr, int* resolvedOffset = nullptr) {
+    if (!patternAddr) {
+        return 0;
+    }
+
+    // Hits come from a section scan of a mapped module; its headers precede every section, so
+    // the lookbehind window is always readable
+    const uint8_t* hit = reinterpret_cast<const uint8_t*>(patternAddr);
+    x64::Reference reference;
+    if (!x64::FindReferenceBefore(hit, hit - x64::MAX_LOOKBEHIND, x64::REFERENCE_LEA, reference)) {
+        return 0;
+    }
+
+    if (reference.offset != -7) {
+        LOGHEX("Found function with offset", reference.offset);
+    }
+
+    if (!IsValidExecutableAddress(reference.target)) {
+        return 0;
+    }
+    if (resolvedOffset) {
+        *resolvedOffset = reference.offset;
+    }
+    return reference.target;
+}
+
 /**
  * @brief Extract Steam overlay function address from pattern using LEA instruction analysis
  * @param pattern Pattern to search for in Steam overlay
@@ -33,20 +116,8 @@ uintptr_t ExtractSteamFunction(const char* pattern, const char* patternName) {
     LOGHEX("Found pattern for", patternName);
     LOGHEX("Pattern address", patternAddr);
 
-    // Extract function address using LEA instruction analysis
-    uintptr_t functionAddr = ExtractFunctionFromLEA(patternAddr, -7);
-    if (!functionAddr) {
-        // Try alternative offsets if standard -7 doesn't work
-        for (int offset = -15; offset <= -3; offset++) {
-            functionAddr = ExtractFunctionFromLEA(patternAddr, offset);
-            if (functionAddr) {
-                LOGHEX("Found function with offset", offset);
-                break;
-            }
-        }
-    }
-
-    if (functionAddr && IsValidExecutableAddress(functionAddr)) {
+    uintptr_t functionAddr = ResolveFunctionFromPattern(patternAddr);
+    if (functionAddr) {
         LOGHEX("Extracted Steam function", functionAddr);
         return functionAddr;
     }
@@ -56,119 +127,670 @@ uintptr_t ExtractSteamFunction(const char* pattern, const char* patternName) {
 }
 
 /**
- * @brief TF2 Present hook - renders overlay interface
+ * @brief Resolve a Steam overlay function from the hits of a multi-signature scan
+ * Hits are tried in address order; the first one with a valid LEA wins.
+ * @param signature Hits for one named signature
+ * @param patternAddr Optional; receives the hit that resolved
+ * @param leaOffset Optional; receives the offset of the LEA relative to that hit
+ * @return Steam function address, or 0 if no hit resolved
+ */
+uintptr_t ResolveSteamFunction(const scanner::SignatureHits& signature, uintptr_t* patternAddr, int* leaOffset) {
+    if (signature.hits.empty()) {
+        LOGHEX("Pattern not found for", signature.name);
+        return 0;
+    }
+
+    LOGHEX("Found pattern for", signature.name);
+    LOGHEX("Pattern hits", signature.hits.size());
+
+    for (const uint8_t* hit : signature.hits) {
+        int offset = 0;
+        uintptr_t functionAddr = ResolveFunctionFromPattern(reinterpret_cast<uintptr_t>(hit), &offset);
+        if (functionAddr) {
+            LOGHEX("Pattern address", reinterpret_cast<uintptr_t>(hit));
+            LOGHEX("Extracted Steam function", functionAddr);
+            if (patternAddr) {
+                *patternAddr = reinterpret_cast<uintptr_t>(hit);
+            }
+            if (leaOffset) {
+                *leaOffset = offset;
+            }
+            return functionAddr;
+        }
+    }
+
+    LOGHEX("Failed to extract valid function for", signature.name);
+    return 0;
+}
+
+/**
+ * @brief Path of a file in our %LOCALAPPDATA% directory, creating the directory if needed
+ * @param fileName File name (e.g., TF2Config::SIGNATURE_CACHE_FILE)
+ * @return Full file path, or an empty string if %LOCALAPPDATA% is unavailable
+ */
+static std::string GetDataFilePath(const char* fileName) {
+    char localAppData[MAX_PATH];
+    DWORD length = GetEnvironmentVariableA("LOCALAPPDATA", localAppData, MAX_PATH);
+    if (!length || length >= MAX_PATH) {
+        return std::string();
+    }
+
+    std::string directory = std::string(localAppData) + "\\" + TF2Config::DATA_DIRECTORY;
+    CreateDirectoryA(directory.c_str(), nullptr);
+    return directory + "\\" + fileName;
+}
+
+/**
+ * @brief Re-check a cached signature site in the loaded module without scanning
+ * The cached RVA must still lie in a code section, the signature must still match there and
+ * the LEA at the cached offset must still resolve to the cached function.
+ * @param entry Cached resolution
+ * @param pattern Compiled signature
+ * @param moduleBase Base address of the loaded module
+ * @param info Headers parsed from the loaded module
+ * @return Function address, or 0 if the cached site no longer holds
+ */
+static uintptr_t ValidateCachedSignature(const scanner::CachedSignature& entry, const scanner::Pattern& pattern, uintptr_t moduleBase, const pe::ImageInfo& info) {
+    // The LEA lives before the hit, so keep the whole probe inside one code section
+    const pe::Section* section = pe::FindSection(info, entry.patternRva);
+    if (!section || !(pe::SectionTarget(*section) & pe::TARGET_CODE)) {
+        return 0;
+    }
+
+    const int64_t probeBegin = static_cast<int64_t>(entry.patternRva) + (std::min)(entry.instructionOffset, 0);
+    const int64_t probeEnd = static_cast<int64_t>(entry.patternRva) + pattern.length;
+    const int64_t sectionEnd = static_cast<int64_t>(section->virtualAddress) + pe::MappedSize(*section);
+    if (probeBegin < section->virtualAddress || probeEnd > sectionEnd) {
+        return 0;
+    }
+
+    const uintptr_t patternAddr = moduleBase + entry.patternRva;
+    if (!scanner::MatchesAt(reinterpret_cast<const uint8_t*>(patternAddr), pattern)) {
+        return 0;
+    }
+
+    const uintptr_t functionAddr = ExtractFunctionFromLEA(patternAddr, entry.instructionOffset);
+    if (functionAddr != moduleBase + entry.functionRva) {
+        return 0;
+    }
+    return functionAddr;
+}
+
+/**
+ * @brief Per-stage cost of hkPresent: percentiles, a graph of the last frames and CSV export
+ */
+static void DrawOverheadStats(const OverlayData& data, bool showGraph) {
+    const core::StageSummary& overhead = data.stages[static_cast<size_t>(core::FrameStage::Overhead)];
+
+    ImGui::Text("Hook overhead p99.9: %.1f us (budget %.0f us)", overhead.p999Us, core::OVERHEAD_BUDGET_US);
+
+    if (showGraph) {
+        char graphLabel[64];
+        snprintf(graphLabel, sizeof(graphLabel), "p50 %.1f us", overhead.p50Us);
+        ImGui::PlotLines("##overhead", data.overheadHistory, static_cast<int>(core::FRAME_HISTORY),
+            static_cast<int>(data.historyOffset), graphLabel, 0.0f, static_cast<float>(core::OVERHEAD_BUDGET_US), ImVec2(0, 60));
+    }
+
+    ImGui::Text("Quality: %s (game frame %.2f ms, target %.2f ms), %llu steps down, %llu up",
+        core::OverlayQualityName(g_governor.Level()), g_governor.SmoothedFrameMs(), g_governor.TargetFrameMs(),
+        static_cast<unsigned long long>(g_governor.StepsDown()), static_cast<unsigned long long>(g_governor.StepsUp()));
+
+    ImGui::Text("%-18s %8s %8s %8s", "Stage (us)", "p50", "p99", "p99.9");
+    for (size_t stage = 0; stage < core::FRAME_STAGE_COUNT; stage++) {
+        const core::StageSummary& summary = data.stages[stage];
+        ImGui::Text("%-18s %8.1f %8.1f %8.1f", core::FrameStageName(static_cast<core::FrameStage>(stage)),
+            summary.p50Us, summary.p99Us, summary.p999Us);
+    }
+    ImGui::Text("Frames: %llu", static_cast<unsigned long long>(overhead.frames));
+
+    const hud::RetainedHud& retainedHud = hud::GetRetainedHud();
+    ImGui::Text("UI rebuilt: %llu, replayed: %llu", static_cast<unsigned long long>(retainedHud.RebuiltFrames()),
+        static_cast<unsigned long long>(retainedHud.ReplayedFrames()));
+
+    const hud::UiThread& uiThread = hud::GetUiThread();
+    if (uiThread.Running()) {
+        const hud::UiThreadStats uiStats = uiThread.Stats();
+        ImGui::Text("UI thread: %llu frames (%llu skipped), build %.1f us, max %.1f us",
+            static_cast<unsigned long long>(uiStats.frames), static_cast<unsigned long long>(uiStats.skipped),
+            uiStats.lastBuildUs, uiStats.maxBuildUs);
+    }
+
+    const render::RenderStats& renderStats = data.renderStats;
+    ImGui::Text("Draws: %u of %u commands, %u vertices%s", renderStats.batches, renderStats.commands,
+        renderStats.vertices, renderStats.uploaded ? "" : " (reused)");
+
+    const render::FontAtlasCache& fontCache = render::GetFontAtlasCache();
+    const render::FontWarmUp& warmUp = fontCache.WarmUp();
+    ImGui::Text("Font atlas: %s %.2f ms, wait %.2f ms, texture %.2f ms%s", warmUp.fromCache ? "cached" : "rasterized",
+        warmUp.atlasMs, warmUp.waitMs, warmUp.textureMs, fontCache.HasTexture() ? " (managed)" : "");
+
+    const core::HeapStats heap = core::GetOverlayHeap().Stats();
+    const core::FrameArena& arena = core::GetFrameArena();
+    ImGui::Text("Heap: %.2f MB live (peak %.2f MB), %.2f MB free in lists, %.2f of %.0f MB committed",
+        heap.liveBytes / (1024.0 * 1024.0), heap.peakLiveBytes / (1024.0 * 1024.0), heap.freeBytes / (1024.0 * 1024.0),
+        heap.committedBytes / (1024.0 * 1024.0), heap.reservedBytes / (1024.0 * 1024.0));
+    ImGui::Text("Heap allocations: %llu last frame, %llu live, %llu system calls",
+        static_cast<unsigned long long>(heap.frameAllocations), static_cast<unsigned long long>(heap.liveAllocations),
+        static_cast<unsigned long long>(heap.frameSystemCalls));
+    ImGui::Text("Heap overflow: %llu allocations, %.2f of %.0f MB live, %llu refused",
+        static_cast<unsigned long long>(heap.overflowAllocations), heap.overflowBytes / (1024.0 * 1024.0),
+        heap.overflowBudgetBytes / (1024.0 * 1024.0), static_cast<unsigned long long>(heap.overflowRefused));
+    ImGui::Text("Frame arena: %zu of %zu bytes (peak %zu)", arena.Used(), arena.Capacity(), arena.Peak());
+
+    // Scratch for the provider table comes from the frame arena: no heap traffic per frame
+    const core::UpdateScheduler& scheduler = core::GetUpdateScheduler();
+    const size_t providerCapacity = scheduler.ProviderCount();
+    core::ProviderStats* providers = core::GetFrameArena().AllocateArray<core::ProviderStats>(providerCapacity);
+    const size_t providerCount = providers ? scheduler.Stats(providers, providerCapacity) : 0;
+    hud::CallbackRegistry& callbacks = hud::GetCallbackRegistry();
+    if (callbacks.Count()) {
+        ImGui::Text("Overlay callbacks: %zu, dispatch %.1f us", callbacks.Count(), callbacks.LastDispatchUs());
+        ImGui::Text("%-22s %5s %8s %8s %8s %6s %-9s", "Callback", "prio", "budget", "avg us", "max us", "every", "state");
+        for (size_t i = 0; i < callbacks.Count(); i++) {
+            const hud::CallbackStats callback = callbacks.Stats(i);
+            ImGui::Text("%-22s %5d %8.0f %8.1f %8.1f %6u %-9s", callback.name, callback.priority, callback.budgetUs,
+                callback.averageUs, callback.maxUs, callback.interval, hud::CallbackStateName(callback.state));
+            if (callback.state == hud::CallbackState::Disabled) {
+                ImGui::SameLine();
+                ImGui::PushID(static_cast<int>(i));
+                if (ImGui::SmallButton("Enable")) {
+                    callbacks.Enable(i);
+                }
+                ImGui::PopID();
+            }
+        }
+    }
+
+    ImGui::Text("%-22s %7s %9s %9s", "Provider", "Hz", "last us", "max us");
+    for (size_t i = 0; i < providerCount; i++) {
+        const core::ProviderStats& provider = providers[i];
+        ImGui::Text("%-22s %7.1f %9.1f %9.1f", provider.name, 1000.0 / provider.periodMs, provider.lastCostUs, provider.maxCostUs);
+    }
+    ImGui::Text("Dropped log records: %llu", static_cast<unsigned long long>(data.process.droppedLogRecords));
+
+    const core::TraceRecorder& tracer = core::GetTraceRecorder();
+    ImGui::Text("Trace: %llu events (%llu startup events dropped)", static_cast<unsigned long long>(tracer.Recorded()),
+        static_cast<unsigned long long>(tracer.Dropped()));
+
+    // The profiler belongs to hkPresent; the buttons only ask it
+    if (ImGui::Button("Export CSV")) {
+        g_exportRequested.store(true, std::memory_order_relaxed);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        g_resetRequested.store(true, std::memory_order_relaxed);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace")) {
+        g_traceRequested.store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Write the frame timings to CSV on a worker
+ */
+static void ExportFrameTimings() {
+    // Copy the histograms and write them on a worker; file I/O has no place on the render thread
+    core::WorkerPool* pool = core::GetWorkerPool();
+    if (!pool) {
+        LOGWARN("Frame timings not exported: shutting down", 0);
+        return;
+    }
+    auto snapshot = std::make_shared<core::FrameProfiler>(core::GetFrameProfiler());
+    pool->Submit([snapshot]() {
+        const std::string path = GetDataFilePath(TF2Config::FRAME_TIMINGS_FILE);
+        if (!path.empty() && snapshot->ExportCsv(path)) {
+            LOGHEX("Frame timings exported to", path);
+        } else {
+            LOGERROR("Failed to export frame timings", path);
+        }
+    });
+}
+
+void hooks::ExportTrace() {
+    const std::string path = GetDataFilePath(TF2Config::TRACE_FILE);
+    if (!path.empty() && core::GetTraceRecorder().ExportJson(path)) {
+        LOGHEX("Trace exported to", path);
+    } else {
+        LOGERROR("Failed to export trace", path);
+    }
+}
+
+/**
+ * @brief Take a request made by an overlay button
+ */
+static bool ConsumeRequest(std::atomic<bool>& request) {
+    // Relaxed load first: the common case (no request) never writes the shared cache line
+    return request.load(std::memory_order_relaxed) && request.exchange(false, std::memory_order_acquire);
+}
+
+/**
+ * @brief Gather what the overlay shows (render thread)
+ */
+static void CollectOverlayData(OverlayData& data) {
+    const core::FrameProfiler& profiler = core::GetFrameProfiler();
+    data.fps = g_frameRate.DisplayedFps();
+    data.process = g_processView;
+    for (size_t stage = 0; stage < core::FRAME_STAGE_COUNT; stage++) {
+        data.stages[stage] = profiler.Summary(static_cast<core::FrameStage>(stage));
+    }
+    memcpy(data.overheadHistory, profiler.History(core::FrameStage::Overhead), sizeof(data.overheadHistory));
+    data.historyOffset = profiler.HistoryOffset();
+    data.renderStats = g_renderer ? g_renderer->LastStats() : render::RenderStats();
+}
+
+/**
+ * @brief Run an ImGui frame for the layers that changed
+ * Runs on the render thread, or on the UI thread while it is running.
+ * @param data What the overlay shows
+ * @param elapsedMs Time since the previous call
+ * @param timings Receives the time of each ImGui stage
+ * @return true if ImGui ran (the retained HUD holds new geometry)
+ */
+static bool BuildOverlay(const OverlayData& data, double elapsedMs, BuildTimings& timings) {
+    hud::RetainedHud& retainedHud = hud::GetRetainedHud();
+    const double fps = data.fps;
+
+    // One call per UI frame: closes the heap's per-frame counters and frees the previous frame's scratch
+    core::GetOverlayHeap().EndFrame();
+    core::GetFrameArena().Reset();
+
+    // Everything that changes in a layer is formatted up front; the key is the hash of that text
+    char frameRateText[64];
+    char frameTimeText[64];
+    char hudFpsText[32];
+    char processText[96];
+    snprintf(frameRateText, sizeof(frameRateText), "Frame Rate: %.1f FPS", fps);
+    snprintf(frameTimeText, sizeof(frameTimeText), "Frame Time: %.3f ms", fps > 0.0 ? 1000.0 / fps : 0.0);
+    snprintf(hudFpsText, sizeof(hudFpsText), "FPS: %.0f", fps);
+    snprintf(processText, sizeof(processText), "Process: %.1f%% CPU, %.0f MB working set", data.process.cpuPercent,
+        data.process.workingSetBytes / (1024.0 * 1024.0));
+
+    uint64_t layerKeys[hud::LAYER_COUNT];
+    layerKeys[static_cast<size_t>(hud::Layer::Window)] = hud::HashText(processText, hud::HashText(frameTimeText, hud::HashText(frameRateText)));
+    layerKeys[static_cast<size_t>(hud::Layer::Hud)] = hud::HashText(hudFpsText);
+
+    if (!retainedHud.Prepare(layerKeys, elapsedMs)) {
+        return false;
+    }
+
+    // The level is set on the render thread; the style belongs to the thread building the UI
+    const core::OverlayQuality quality = g_governor.Level();
+    const bool essentialOnly = quality >= core::OverlayQuality::Essential;
+    ImGuiStyle& style = ImGui::GetStyle();
+    style.AntiAliasedLines = quality < core::OverlayQuality::NoAntiAliasing;
+    style.AntiAliasedFill = quality < core::OverlayQuality::NoAntiAliasing;
+
+    const int64_t newFrameStart = core::FrameProfiler::Now();
+    // The backend would create its own font texture over the managed one
+    if (!render::GetFontAtlasCache().HasTexture()) {
+        ImGui_ImplDX9_NewFrame();
+    }
+    ImGui_ImplWin32_NewFrame();
+    ImGui::NewFrame();
+
+    const int64_t uiStart = core::FrameProfiler::Now();
+    timings.newFrame = uiStart - newFrameStart;
+
+    // Every window is submitted whenever ImGui runs, or it would drop the focus, hover and active
+    // state of the ones left out; Capture keeps only the changed layers and replays the others
+
+    // TF2-specific overlay interface
+    ImGui::SetNextWindowPos(ImVec2(50, 50), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(350, 250), ImGuiCond_FirstUseEver);
+
+    if (ImGui::Begin("TF2 Secretive Rendering", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::Text("Team Fortress 2 Steam Overlay Hook");
+        ImGui::Separator();
+
+        ImGui::Text("Architecture: x64");
+        ImGui::Text("Target Game: Team Fortress 2");
+        ImGui::Text("Steam Module: %s", TF2Config::STEAM_OVERLAY_DLL);
+
+        ImGui::Separator();
+        ImGui::TextUnformatted(frameRateText);
+        ImGui::TextUnformatted(frameTimeText);
+        ImGui::TextUnformatted(processText);
+
+        if (ImGui::CollapsingHeader("Hook Overhead")) {
+            // The graph moves every frame; under load it goes, and the section refreshes with the window
+            if (!essentialOnly) {
+                retainedHud.MarkLive(hud::Layer::Window);
+            }
+            DrawOverheadStats(data, !essentialOnly);
+        }
+
+        ImGui::Separator();
+        ImGui::TextWrapped("This overlay is invisible to streaming software!");
+        ImGui::TextWrapped("Press F1 to toggle overlay visibility");
+
+        ImGui::Separator();
+        if (ImGui::Button("Hide Overlay")) {
+            g_hideRequested.store(true, std::memory_order_relaxed);
+        }
+    }
+    ImGui::End();
+
+    // Windows of registered modules belong to the same layer
+    hud::GetCallbackRegistry().Dispatch(essentialOnly);
+
+    // Minimal HUD in corner
+    ImGui::SetNextWindowPos(ImVec2(10, 10));
+    ImGui::SetNextWindowBgAlpha(0.3f);
+
+    if (ImGui::Begin(TF2Config::HUD_WINDOW, nullptr,
+                     ImGuiWindowFlags_NoTitleBar |
+                     ImGuiWindowFlags_NoResize |
+                     ImGuiWindowFlags_NoMove |
+                     ImGuiWindowFlags_NoScrollbar |
+                     ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::Text("TF2 x64");
+        ImGui::TextUnformatted(hudFpsText);
+    }
+    ImGui::End();
+
+    const int64_t renderStart = core::FrameProfiler::Now();
+    timings.buildUi = renderStart - uiStart;
+
+    ImGui::EndFrame();
+    ImGui::Render();
+    retainedHud.Capture(ImGui::GetDrawData(), TF2Config::HUD_WINDOW);
+    timings.render = core::FrameProfiler::Now() - renderStart;
+    return true;
+}
+
+/**
+ * @brief Build function of the UI thread: the overlay from the latest data hkPresent published
+ */
+static ImDrawData* BuildOnUiThread(double elapsedMs, uint64_t& generation) {
+    static OverlayData data = {};
+    g_overlayData.TryRead(data);
+    if (!g_overlayData.Version()) {
+        return nullptr;
+    }
+
+    try {
+        BuildTimings timings;
+        if (!BuildOverlay(data, elapsedMs, timings)) {
+            return nullptr;
+        }
+    }
+    catch (...) {
+        LOGERROR("Exception in TF2 overlay UI thread", 0);
+        g_hideRequested.store(true, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    hud::RetainedHud& retainedHud = hud::GetRetainedHud();
+    generation = retainedHud.Generation();
+    return retainedHud.Replay();
+}
+
+/**
+ * @brief Register the overlay's data providers with the update scheduler
+ * Everything the overlay shows is refreshed at the rate a reader can follow, not the game's frame rate.
+ */
+static void RegisterUpdateProviders() {
+    core::UpdateScheduler& scheduler = core::GetUpdateScheduler();
+
+    scheduler.Register("Frame rate", TF2Config::FPS_UPDATE_MS, core::UpdateThread::Render, []() {
+        g_frameRate.Sample();
+        core::TraceRecorder& tracer = core::GetTraceRecorder();
+        tracer.Counter("FPS", g_frameRate.DisplayedFps());
+        tracer.Counter("Overlay heap (KB)", core::GetOverlayHeap().Stats().liveBytes / 1024.0);
+    });
+    scheduler.Register("Overhead percentiles", TF2Config::OVERHEAD_UPDATE_MS, core::UpdateThread::Render, []() {
+        core::GetFrameProfiler().RefreshSummaries();
+    });
+
+    auto sampler = std::make_shared<core::ProcessStatsSampler>();
+    scheduler.Register("Process stats", TF2Config::PROCESS_STATS_UPDATE_MS, core::UpdateThread::Background, [sampler]() {
+        core::ProcessStats stats;
+        if (sampler->Sample(stats)) {
+            g_processStats.Publish(stats);
+        }
+    });
+}
+
+/**
+ * @brief Wake handler of the toggle key: route Present through the overlay again (window thread)
+ */
+static void ArmOverlayPath() {
+    g_presentPath.store(&PresentOverlay, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Route Present straight to the original while the overlay is hidden (render thread)
+ */
+static void DisarmOverlayPath() {
+    g_presentPath.store(oPresent, std::memory_order_relaxed);
+    // A toggle press that raced with the store re-arms at once (see InputEvents::SetWakeKey)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (core::GetInputEvents().PendingPresses(TF2Config::OVERLAY_TOGGLE_KEY)) {
+        ArmOverlayPath();
+    }
+}
+
+/**
+ * @brief Aim the governor at the display's refresh interval (render thread, after init and Reset)
+ */
+static void TargetDisplayRefresh(IDirect3DDevice9* device) {
+    D3DDISPLAYMODE mode = {};
+    const bool known = SUCCEEDED(device->GetDisplayMode(0, &mode)) && mode.RefreshRate > 0;
+    g_governor.SetTargetFrameMs(known ? 1000.0 / mode.RefreshRate : TF2Config::GOVERNOR_TARGET_FRAME_MS);
+    LOGHEX("Quality governor target (ms)", g_governor.TargetFrameMs());
+}
+
+/**
+ * @brief Feed the governor one frame of the game (render thread, overlay visible)
+ */
+static void GovernQuality(double frameMs) {
+    const double hookMs = core::GetFrameProfiler().TicksToNanoseconds(g_lastHookTicks) / 1000000.0;
+    if (!g_governor.Update(frameMs - hookMs)) {
+        return;
+    }
+    const core::OverlayQuality quality = g_governor.Level();
+    LOGHEX("Overlay quality", core::OverlayQualityName(quality));
+    core::GetTraceRecorder().Counter("Overlay quality", static_cast<double>(quality));
+    // Style and widgets change with the level: rebuild every layer
+    hud::GetRetainedHud().RequestInvalidate();
+}
+
+/**
+ * @brief TF2 Present hook
+ * One indirect call: PresentOverlay while the overlay is shown, the original Present while it is hidden.
+ * Counted in flight, since even the hidden path returns here from the original Present.
  */
 HRESULT STDMETHODCALLTYPE hkPresent(IDirect3DDevice9* thisptr, const RECT* src, const RECT* dest, HWND wnd_override, const RGNDATA* dirty_region) {
+    const hooks::DetourCall call;
+    return g_presentPath.load(std::memory_order_relaxed)(thisptr, src, dest, wnd_override, dirty_region);
+}
+
+/**
+ * @brief Present with the overlay - initializes, renders the overlay interface, then presents
+ */
+static HRESULT STDMETHODCALLTYPE PresentOverlay(IDirect3DDevice9* thisptr, const RECT* src, const RECT* dest, HWND wnd_override, const RGNDATA* dirty_region) {
+    const int64_t hookStart = core::FrameProfiler::Now();
+    core::FrameProfiler& profiler = core::GetFrameProfiler();
+
     // Initialize ImGui on first call
     if (!g_initialized && thisptr) {
         HRESULT deviceState = thisptr->TestCooperativeLevel();
         if (deviceState == D3D_OK) {
+            core::TraceRecorder& tracer = core::GetTraceRecorder();
+            tracer.NameThread("Render");
             imguiHook::InitializeImgui(thisptr);
+            {
+                core::TraceScope trace("Create renderer objects");
+                g_renderer = std::make_unique<render::Dx9Renderer>(thisptr);
+                if (!g_renderer->CreateDeviceObjects()) {
+                    LOGERROR("Failed to create overlay renderer objects", reinterpret_cast<uintptr_t>(thisptr));
+                }
+            }
             g_initialized = true;
+            TargetDisplayRefresh(thisptr);
             LOGHEX("ImGui initialized for TF2", reinterpret_cast<uintptr_t>(thisptr));
+            core::GetStartupTimeline().Mark("Startup (ms): first overlay frame");
+            // The startup buffer is complete; per-frame spans go to the ring from here on
+            tracer.EndStartup();
+
+            // With the managed font texture nothing here needs ImGui any more, so the UI can move out
+            if (TF2Config::UI_THREAD && render::GetFontAtlasCache().HasTexture()) {
+                hud::GetUiThread().Start(BuildOnUiThread);
+            }
         } else {
-            LOGHEX("D3D device not ready, state", deviceState);
+            LOGTRACE("D3D device not ready, state", deviceState);
             return oPresent(thisptr, src, dest, wnd_override, dirty_region);
         }
     }
 
-    // Handle overlay toggle
-    static bool toggleKeyPressed = false;
-    bool toggleKeyDown = (GetAsyncKeyState(TF2Config::OVERLAY_TOGGLE_KEY) & 0x8000) != 0;
-    
-    if (toggleKeyDown && !toggleKeyPressed) {
+    // Frame rate from Present itself: replayed frames never run ImGui::NewFrame
+    const double frameMs = g_lastPresentTicks ? profiler.TicksToNanoseconds(hookStart - g_lastPresentTicks) / 1000000.0 : 0.0;
+    g_lastPresentTicks = hookStart;
+    g_frameRate.Tick(frameMs);
+
+    // Providers that are due; a clock compare otherwise
+    core::GetUpdateScheduler().RunRenderUpdates();
+    if (g_processStats.Version() != g_processVersion && g_processStats.TryRead(g_processView)) {
+        g_processVersion = g_processStats.Version();
+    }
+
+    // Handle overlay toggle (presses decoded by hkWndProc; an even count cancels out)
+    if (core::GetInputEvents().ConsumePresses(TF2Config::OVERLAY_TOGGLE_KEY) & 1) {
         g_overlayVisible = !g_overlayVisible;
         LOGHEX("TF2 Overlay visibility toggled", g_overlayVisible);
+        if (g_overlayVisible) {
+            hud::GetRetainedHud().RequestInvalidate();
+        }
+    }
+
+    // Requests from the overlay's buttons
+    if (ConsumeRequest(g_hideRequested)) {
+        g_overlayVisible = false;
+    }
+    if (ConsumeRequest(g_resetRequested)) {
+        profiler.Reset();
+    }
+    if (ConsumeRequest(g_exportRequested)) {
+        ExportFrameTimings();
+    }
+    if (ConsumeRequest(g_traceRequested)) {
+        // Without a pool the DLL is shutting down, and fMain exports the trace itself
+        if (core::WorkerPool* pool = core::GetWorkerPool()) {
+            pool->Submit([]() { hooks::ExportTrace(); });
+        }
     }
-    toggleKeyPressed = toggleKeyDown;
 
     // Render overlay if initialized and visible
     if (g_initialized && g_overlayVisible) {
+        if (TF2Config::QUALITY_GOVERNOR) {
+            GovernQuality(frameMs);
+        }
+        // At the lowest level only every other Present rebuilds; the others draw the last frame again
+        const bool rebuild = g_governor.Level() < core::OverlayQuality::HalfRate || (++g_presentCount & 1);
+        const double elapsedMs = frameMs + g_skippedMs;
+        g_skippedMs = rebuild ? 0.0 : elapsedMs;
+
         try {
-            ImGui_ImplDX9_NewFrame();
-            ImGui_ImplWin32_NewFrame();
-            ImGui::NewFrame();
-
-            // TF2-specific overlay interface
-            ImGui::SetNextWindowPos(ImVec2(50, 50), ImGuiCond_FirstUseEver);
-            ImGui::SetNextWindowSize(ImVec2(350, 250), ImGuiCond_FirstUseEver);
-            
-            if (ImGui::Begin("TF2 Secretive Rendering", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
-                ImGui::Text("Team Fortress 2 Steam Overlay Hook");
-                ImGui::Separator();
-                
-                ImGui::Text("Architecture: x64");
-                ImGui::Text("Target Game: Team Fortress 2");
-                ImGui::Text("Steam Module: %s", TF2Config::STEAM_OVERLAY_DLL);
-                
-                ImGui::Separator();
-                ImGui::Text("Frame Rate: %.1f FPS", ImGui::GetIO().Framerate);
-                ImGui::Text("Frame Time: %.3f ms", 1000.0f / ImGui::GetIO().Framerate);
-                
-                ImGui::Separator();
-                ImGui::TextWrapped("This overlay is invisible to streaming software!");
-                ImGui::TextWrapped("Press F1 to toggle overlay visibility");
-                
-                ImGui::Separator();
-                if (ImGui::Button("Hide Overlay")) {
-                    g_overlayVisible = false;
+            CollectOverlayData(g_presentData);
+
+            hud::UiThread& uiThread = hud::GetUiThread();
+            if (uiThread.Running()) {
+                // The UI thread builds the next frame from this copy; draw the newest one it finished
+                if (rebuild) {
+                    g_overlayData.Publish(g_presentData);
+                    uiThread.NotifyPresent();
+                }
+                if (hud::DrawSnapshot* snapshot = uiThread.Latest()) {
+                    core::ScopedStageTimer timer(profiler, core::FrameStage::RenderDrawData);
+                    g_renderer->RenderDrawData(&snapshot->drawData, snapshot->generation);
+                }
+            } else {
+                BuildTimings timings;
+                if (rebuild && BuildOverlay(g_presentData, elapsedMs, timings)) {
+                    profiler.Add(core::FrameStage::NewFrame, timings.newFrame);
+                    profiler.Add(core::FrameStage::BuildUi, timings.buildUi);
+                    profiler.Add(core::FrameStage::Render, timings.render);
                 }
-            }
-            ImGui::End();
-
-            // Minimal HUD in corner
-            ImGui::SetNextWindowPos(ImVec2(10, 10));
-            ImGui::SetNextWindowBgAlpha(0.3f);
-            
-            if (ImGui::Begin("TF2 HUD", nullptr, 
-                             ImGuiWindowFlags_NoTitleBar | 
-                             ImGuiWindowFlags_NoResize | 
-                             ImGuiWindowFlags_NoMove | 
-                             ImGuiWindowFlags_NoScrollbar |
-                             ImGuiWindowFlags_AlwaysAutoResize)) {
-                ImGui::Text("TF2 x64");
-                ImGui::Text("FPS: %.0f", ImGui::GetIO().Framerate);
-            }
-            ImGui::End();
 
-            ImGui::EndFrame();
-            ImGui::Render();
-            ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());
+                core::ScopedStageTimer timer(profiler, core::FrameStage::RenderDrawData);
+                hud::RetainedHud& retainedHud = hud::GetRetainedHud();
+                g_renderer->RenderDrawData(retainedHud.Replay(), retainedHud.Generation());
+            }
         }
+
         catch (...) {
-            LOGHEX("Exception in TF2 overlay rendering", 0);
+            LOGERROR("Exception in TF2 overlay rendering", 0);
             g_overlayVisible = false;
         }
     }
 
-    return oPresent(thisptr, src, dest, wnd_override, dirty_region);
+    const int64_t presentStart = core::FrameProfiler::Now();
+    HRESULT result = oPresent(thisptr, src, dest, wnd_override, dirty_region);
+    const int64_t hookEnd = core::FrameProfiler::Now();
+
+    profiler.Add(core::FrameStage::OriginalPresent, hookEnd - presentStart);
+    profiler.EndFrame(hookEnd - hookStart);
+    g_lastHookTicks = presentStart - hookStart;
+    if (TF2Config::TRACE_FRAMES) {
+        // Ticks the profiler already took: two slot claims per frame
+        core::TraceRecorder& tracer = core::GetTraceRecorder();
+        tracer.Complete("hkPresent", hookStart, hookEnd);
+        tracer.Complete("Original Present", presentStart, hookEnd);
+    }
+
+    // Stale input would replay when the overlay comes back (see uiThread.h)
+    hud::GetUiThread().AcceptInput(g_overlayVisible);
+
+    // Hidden: later Presents skip all of the above until the toggle key re-arms this path
+    if (g_initialized && !g_overlayVisible) {
+        g_lastPresentTicks = 0;
+        g_skippedMs = 0.0;
+        g_governor.Reset();
+        DisarmOverlayPath();
+    }
+    return result;
 }
 
 /**
  * @brief TF2 Reset hook - handles device reset
  */
 HRESULT STDMETHODCALLTYPE hkReset(IDirect3DDevice9* thisptr, D3DPRESENT_PARAMETERS* params) {
+    const hooks::DetourCall call;
     LOGHEX("TF2 Device Reset requested", reinterpret_cast<uintptr_t>(thisptr));
     
+    // A managed font texture survives the reset; only the backend's default-pool one is rebuilt
+    const bool managedFont = render::GetFontAtlasCache().HasTexture();
     if (g_initialized) {
-        ImGui_ImplDX9_InvalidateDeviceObjects();
+        g_renderer->InvalidateDeviceObjects();
+        if (!managedFont) {
+            ImGui_ImplDX9_InvalidateDeviceObjects();
+        }
     }
     
     HRESULT result = oReset(thisptr, params);
     
     if (SUCCEEDED(result) && g_initialized) {
-        ImGui_ImplDX9_CreateDeviceObjects();
+        if (!managedFont) {
+            ImGui_ImplDX9_CreateDeviceObjects();
+            // Cached draw commands reference the font texture that was just recreated
+            hud::GetRetainedHud().Invalidate();
+        }
+        g_renderer->CreateDeviceObjects();
+        // A mode change comes with a Reset
+        TargetDisplayRefresh(thisptr);
         LOGHEX("TF2 Device Reset successful", result);
     } else if (!SUCCEEDED(result)) {
-        LOGHEX("TF2 Device Reset failed", result);
+        LOGERROR("TF2 Device Reset failed", result);
     }
     
     return result;
 }
 
-std::vector<void*> originalFunctions;
+// Every overlay hook; enabled and disabled as one transaction (one thread freeze each way)
+static hooks::HookRegistry g_hookRegistry;
 
-void hooks::Initialize()
+bool hooks::Initialize()
 {
     try {
         LOGHEX("Initializing TF2 Steam Overlay Hook (x64)", 0);
@@ -180,17 +802,118 @@ void hooks::Initialize()
         }
         
         LOGHEX("TF2 Steam overlay module found", reinterpret_cast<uintptr_t>(overlayModule));
+
+        // Snapshot the overlay's memory layout once; every later address check is a lookup
+        uintptr_t moduleStart = 0;
+        uintptr_t moduleEnd = 0;
+        if (GetModuleRange(TF2Config::STEAM_OVERLAY_DLL, moduleStart, moduleEnd)) {
+            LOGHEX("Overlay regions cached", core::GetRegionMap().Snapshot(moduleStart, moduleEnd));
+        }
         
         // Initialize MinHook
-        if (MH_Initialize() != MH_OK) {
-            throw std::exception("MH_Initialize failed!");
+        {
+            core::TraceScope trace("MH_Initialize");
+            if (MH_Initialize() != MH_OK) {
+                throw std::exception("MH_Initialize failed!");
+            }
         }
         
         LOGHEX("MinHook initialized for TF2", 0);
+        LOGHEX("Pattern scanner backend", scanner::BackendName(scanner::GetActiveBackend()));
+
+        // ImGui's allocator is global, not per context: route it to the overlay heap before the
+        // atlas bake below allocates its first glyph
+        ImGui::SetAllocatorFunctions(
+            [](size_t size, void* heap) { return static_cast<core::OverlayHeap*>(heap)->AllocateRequired(size); },
+            [](void* pointer, void* heap) { static_cast<core::OverlayHeap*>(heap)->Free(pointer); },
+            &core::GetOverlayHeap());
 
-        // Extract Steam overlay function addresses using modern pattern analysis
-        uintptr_t presentFunction = ExtractSteamFunction(TF2Config::PRESENT_PATTERN, "Present");
-        uintptr_t resetFunction = ExtractSteamFunction(TF2Config::RESET_PATTERN, "Reset");
+        // Bake the font atlas on a worker while the signatures are resolved; the first frame only uploads it
+        render::GetFontAtlasCache().BeginWarmUp(GetDataFilePath(TF2Config::FONT_ATLAS_CACHE_FILE));
+
+        // Signatures are parsed and validated at compile time (see Scanning/overlaySignatures.h)
+        struct SteamSignature {
+            const scanner::Signature* signature;
+            uintptr_t function;
+        };
+        SteamSignature steamSignatures[] = {
+            { &overlaySignatures::PRESENT, 0 },
+            { &overlaySignatures::RESET, 0 },
+        };
+
+        // Cached resolutions are reused only for the exact overlay build they were recorded for
+        const int64_t resolveStart = core::FrameProfiler::Now();
+        const uintptr_t moduleBase = reinterpret_cast<uintptr_t>(overlayModule);
+        const uint8_t* moduleImage = reinterpret_cast<const uint8_t*>(overlayModule);
+        pe::ImageInfo moduleInfo;
+        char modulePath[MAX_PATH] = { 0 };
+        scanner::ModuleIdentity moduleIdentity;
+        const bool haveIdentity = pe::ParseImage(moduleImage, 0x1000, moduleInfo) &&
+            GetModuleFileNameA(overlayModule, modulePath, MAX_PATH) &&
+            scanner::ComputeFileIdentity(modulePath, moduleIdentity);
+
+        const std::string cachePath = haveIdentity ? GetDataFilePath(TF2Config::SIGNATURE_CACHE_FILE) : std::string();
+        scanner::SignatureCache signatureCache;
+        if (!cachePath.empty()) {
+            LOGHEX("Signature cache matches overlay build", signatureCache.Load(cachePath, moduleIdentity));
+        }
+
+        scanner::SignatureSet signatures;
+        for (SteamSignature& steamSignature : steamSignatures) {
+            const scanner::Signature& signature = *steamSignature.signature;
+            const scanner::CachedSignature* cached = signatureCache.Find(signature.name, scanner::HashPattern(signature.text));
+            if (cached) {
+                steamSignature.function = ValidateCachedSignature(*cached, signature.pattern, moduleBase, moduleInfo);
+            }
+
+            if (steamSignature.function) {
+                LOGHEX("Signature cache hit for", signature.name);
+            }
+            else {
+                signatureCache.Remove(signature.name);
+                signatures.Add(signature.name, signature.pattern, signature.sections);
+            }
+        }
+
+        // Locate every remaining Steam overlay signature with a single pass over the module
+        if (signatures.Size()) {
+            const int64_t scanStart = core::FrameProfiler::Now();
+            std::vector<scanner::SignatureHits> signatureHits = FindPatterns(TF2Config::STEAM_OVERLAY_DLL, signatures);
+            core::GetTraceRecorder().Complete("FindPatterns", scanStart, core::FrameProfiler::Now());
+            for (SteamSignature& steamSignature : steamSignatures) {
+                const scanner::Signature& signature = *steamSignature.signature;
+                const int index = signatures.IndexOf(signature.name);
+                if (index < 0) {
+                    continue;
+                }
+
+                // Extract Steam overlay function addresses using modern pattern analysis
+                uintptr_t patternAddr = 0;
+                int leaOffset = 0;
+                {
+                    core::TraceScope trace("ResolveSteamFunction");
+                    steamSignature.function = ResolveSteamFunction(signatureHits[index], &patternAddr, &leaOffset);
+                }
+                if (steamSignature.function) {
+                    scanner::CachedSignature entry;
+                    entry.name = signature.name;
+                    entry.patternHash = scanner::HashPattern(signature.text);
+                    entry.patternRva = static_cast<uint32_t>(patternAddr - moduleBase);
+                    entry.instructionOffset = leaOffset;
+                    entry.functionRva = static_cast<uint32_t>(steamSignature.function - moduleBase);
+                    signatureCache.Store(entry);
+                }
+            }
+
+            if (!cachePath.empty() && !signatureCache.Save(cachePath)) {
+                LOGHEX("Failed to write signature cache", cachePath);
+            }
+        }
+
+        uintptr_t presentFunction = steamSignatures[0].function;
+        uintptr_t resetFunction = steamSignatures[1].function;
+        core::GetTraceRecorder().Complete("Resolve signatures", resolveStart, core::FrameProfiler::Now());
+        core::GetStartupTimeline().Mark("Startup (ms): signatures resolved");
 
         if (!presentFunction) {
             throw std::exception("Failed to locate TF2 Steam Present function!");
@@ -199,43 +922,96 @@ void hooks::Initialize()
         LOGHEX("TF2 Present function", presentFunction);
         
         // Hook Present function (required)
-        REGISTER_HOOK(reinterpret_cast<void*>(presentFunction), &hkPresent, &oPresent);
+        {
+            core::TraceScope trace("Create Present hook");
+            if (!g_hookRegistry.Add("Present", reinterpret_cast<void*>(presentFunction), &hkPresent, &oPresent)) {
+                throw std::exception("Failed to create TF2 Present hook!");
+            }
+        }
         
         // Hook Reset function (optional, but recommended)
         if (resetFunction) {
             LOGHEX("TF2 Reset function", resetFunction);
-            REGISTER_HOOK(reinterpret_cast<void*>(resetFunction), &hkReset, &oReset);
+            core::TraceScope trace("Create Reset hook");
+            g_hookRegistry.Add("Reset", reinterpret_cast<void*>(resetFunction), &hkReset, &oReset);
         } else {
             LOGHEX("TF2 Reset function not found (non-critical)", 0);
         }
 
-        LOGHEX("TF2 Steam Overlay hooks installed successfully", originalFunctions.size());
+        // Providers must exist before hkPresent can run them
+        RegisterUpdateProviders();
+
+        // While the overlay is hidden hkPresent stops polling input; the toggle key re-arms it
+        core::GetInputEvents().SetWakeKey(TF2Config::OVERLAY_TOGGLE_KEY, &ArmOverlayPath);
+
+        // Enable everything in one MH_ApplyQueued; a failure leaves no hook installed
+        {
+            core::TraceScope trace("Enable hooks");
+            if (!g_hookRegistry.EnableAll()) {
+                throw std::exception("Failed to enable TF2 Steam overlay hooks!");
+            }
+        }
+
+        core::GetStartupTimeline().Mark("Startup (ms): hooks enabled");
+        LOGHEX("TF2 Steam Overlay hooks installed successfully", g_hookRegistry.Size());
+        LOGHEX("Memory queries during initialization", core::GetRegionMap().QueryCount());
+        return true;
 
     } catch (const std::exception &ex) {
         MessageBoxA(nullptr, ex.what(), "TF2 Steam Overlay Hook Error", MB_ICONERROR);
+        return false;
+    }
+}
+
+bool hooks::Disable()
+{
+    LOGHEX("Disabling TF2 Steam Overlay hooks", g_hookRegistry.Size());
+
+    // Calls already past the patch take the cheapest path, and the toggle key no longer re-arms it
+    core::GetInputEvents().SetWakeKey(0, nullptr);
+    if (oPresent) {
+        g_presentPath.store(oPresent, std::memory_order_relaxed);
     }
+
+    // No new call reaches a detour after this
+    if (g_hookRegistry.Size() && !g_hookRegistry.DisableAll()) {
+        LOGERROR("Failed to disable TF2 Steam overlay hooks", 0);
+        return false;
+    }
+    imguiHook::RestoreWndProc();
+
+    if (!hooks::WaitForDetours(TF2Config::HOOK_DRAIN_TIMEOUT_MS)) {
+        LOGERROR("Hook calls still in flight after (ms)", TF2Config::HOOK_DRAIN_TIMEOUT_MS);
+        return false;
+    }
+    return true;
 }
 
 void hooks::Uninitialize()
 {
-    LOGHEX("Uninitializing TF2 Steam Overlay Hook", originalFunctions.size());
+    LOGHEX("Uninitializing TF2 Steam Overlay Hook", g_hookRegistry.Size());
+    core::GetInputEvents().SetWakeKey(0, nullptr);
     
     // Cleanup ImGui if initialized
     if (g_initialized) {
+        imguiHook::RestoreWndProc();
+        // fMain disabled the hooks and stopped the UI thread; the context is ours again
+        hud::GetUiThread().Release();
+        hud::GetRetainedHud().Release();
+        hud::GetCallbackRegistry().Release();
+        g_renderer.reset();
         ImGui_ImplDX9_Shutdown();
         ImGui_ImplWin32_Shutdown();
         ImGui::DestroyContext();
         g_initialized = false;
     }
+    // The atlas is shared with the context, so it goes after it
+    render::GetFontAtlasCache().Release();
     
-    // Remove all hooks
-    for (auto& org : originalFunctions) {
-        MH_DisableHook(org);
-    }
-    
-    originalFunctions.clear();
+    // Remove all hooks (disabled together in a single transaction)
+    g_hookRegistry.DisableAll();
+    g_hookRegistry.RemoveAll();
     MH_Uninitialize();
     
     LOGHEX("TF2 Steam Overlay Hook cleanup complete", 0);
-}
-
+}
\ No newline at end of file
@@ -1,12 +1,34 @@
 #pragma once
 #include "MinHook.h"
 #include <d3d9.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <windows.h>
 #include "../findpattern.h"
+#include "../Scanning/overlaySignatures.h"
+#include "../Scanning/signatureCache.h"
+#include "../Core/frameProfiler.h"
+#include "../Core/inputEvents.h"
+#include "../Core/overlayHeap.h"
+#include "../Core/processStats.h"
+#include "../Core/qualityGovernor.h"
+#include "../Core/updateScheduler.h"
+#include "../Core/workerPool.h"
+#include "../Core/startupTimeline.h"
+#include "../Core/traceRecorder.h"
 #include "../debugMessage.h"
 #include "imguiHook.h"
+#include "hookRegistry.h"
+#include "dx9Renderer.h"
+#include "retainedHud.h"
+#include "fontAtlasCache.h"
+#include "overlayCallbacks.h"
+#include "uiThread.h"
 
 // Enforce 64-bit compilation
 #ifndef _WIN64
@@ -17,59 +39,29 @@ namespace hooks {
     /**
      * @brief Initialize TF2 Steam overlay hooks (x64)
      * Locates and hooks Steam overlay functions for Team Fortress 2
+     * @return false if any step failed (the error is shown to the user and no hook is enabled)
      */
-    void Initialize();
+    bool Initialize();
 
     /**
-     * @brief Enhanced MinHook wrapper with 64-bit validation and error handling
-     * @tparam T Function pointer type
-     * @param pTarget Target function address to hook
-     * @param pDetour Detour function to redirect to
-     * @param ppOriginal Pointer to store original function
+     * @brief Stop every hook from running overlay code (fMain, before stopping any thread)
+     * Disables the hooks, restores the window procedure and waits for calls still in flight, so
+     * nothing touches the renderer or ImGui while the threads and then the context are torn down.
+     * @return false if a hook stayed enabled or a call is still in flight (hkWndProc in a modal
+     *         move or size loop); nothing may be torn down and the DLL must stay loaded
      */
-    template<typename T>
-    inline void Hook(void* pTarget, void* pDetour, T** ppOriginal)
-    {
-        if (!pTarget || !pDetour) {
-            std::cout << "TF2 Hook: Invalid parameters (target: " << pTarget << ", detour: " << pDetour << ")" << std::endl;
-            return;
-        }
-
-        // Validate target address is in executable memory
-        MEMORY_BASIC_INFORMATION mbi;
-        if (!VirtualQuery(pTarget, &mbi, sizeof(mbi))) {
-            std::cout << "TF2 Hook: Failed to query target memory" << std::endl;
-            return;
-        }
-
-        if (!(mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE))) {
-            std::cout << "TF2 Hook: Target is not executable memory (protect: 0x" << std::hex << mbi.Protect << ")" << std::endl;
-            return;
-        }
-
-        // Create hook with enhanced error reporting
-        MH_STATUS creationStatus = MH_CreateHook(pTarget, pDetour, reinterpret_cast<LPVOID*>(ppOriginal));
-        if (creationStatus != MH_OK) {
-            std::cout << "TF2 Hook: MH_CreateHook() failed with status: " << MH_StatusToString(creationStatus) << std::endl;
-            return;
-        }
-
-        // Enable hook with enhanced error reporting
-        MH_STATUS enableStatus = MH_EnableHook(pTarget);
-        if (enableStatus != MH_OK) {
-            std::cout << "TF2 Hook: MH_EnableHook() failed with status: " << MH_StatusToString(enableStatus) << std::endl;
-            MH_RemoveHook(pTarget); // Cleanup on failure
-            return;
-        }
-
-        std::cout << "TF2 Hook: Successfully hooked function at 0x" << std::hex << reinterpret_cast<uintptr_t>(pTarget) << std::endl;
-    }
+    bool Disable();
 
     /**
      * @brief Safely uninitialize all TF2 Steam overlay hooks
      * Performs proper cleanup of MinHook and ImGui resources
      */
     void Uninitialize();
+
+    /**
+     * @brief Write the trace of this injection (fMain, once the other threads are stopped)
+     */
+    void ExportTrace();
 }
 
 // Forward declarations for TF2-specific hook functions
@@ -83,12 +75,35 @@ extern "C" {
     uintptr_t ExtractSteamFunction(const char* pattern, const char* patternName);
 }
 
+/**
+ * @brief Resolve a Steam overlay function from the hits of a single-pass multi-signature scan
+ * @param signature Hits for one named signature (see FindPatterns)
+ * @param patternAddr Optional; receives the hit that resolved
+ * @param leaOffset Optional; receives the LEA offset relative to that hit
+ * @return Function address or 0 if no hit resolved
+ */
+uintptr_t ResolveSteamFunction(const scanner::SignatureHits& signature, uintptr_t* patternAddr = nullptr, int* leaOffset = nullptr);
+
 // TF2 Steam overlay configuration
 namespace TF2Config {
     constexpr const char* STEAM_OVERLAY_DLL = "gameoverlayrenderer64.dll";
-    constexpr const char* PRESENT_PATTERN = "48 8B ? 88 00 00 00 E8";
-    constexpr const char* RESET_PATTERN = "48 8B ? 80 00 00 00 E8";
+    constexpr const char* PRESENT_PATTERN = overlaySignatures::PRESENT.text;
+    constexpr const char* RESET_PATTERN = overlaySignatures::RESET.text;
     constexpr DWORD OVERLAY_TOGGLE_KEY = VK_F1;
+    constexpr const char* HUD_WINDOW = "TF2 HUD";                   // Window cached as the Hud layer
+    constexpr double FPS_UPDATE_MS = 250.0;                         // Displayed frame rate refresh
+    constexpr double OVERHEAD_UPDATE_MS = 250.0;                    // Hook Overhead percentiles
+    constexpr double PROCESS_STATS_UPDATE_MS = 1000.0;              // CPU and memory (background thread)
+    constexpr bool UI_THREAD = true;                                // Build the UI off the render thread (needs the managed font texture)
+    constexpr bool TRACE_FRAMES = true;                             // Per-frame spans in the trace (the startup is always traced)
+    constexpr bool QUALITY_GOVERNOR = true;                         // Lower the overlay's fidelity while the game is under load
+    constexpr double GOVERNOR_TARGET_FRAME_MS = 1000.0 / 60.0;      // Governor target while the display's refresh rate is unknown
+    constexpr DWORD HOOK_DRAIN_TIMEOUT_MS = 2000;                   // Wait for hook calls in flight before unloading
+    constexpr const char* DATA_DIRECTORY = "TF2SecretiveRendering";  // Under %LOCALAPPDATA%
+    constexpr const char* SIGNATURE_CACHE_FILE = "signatures.cache";
+    constexpr const char* FRAME_TIMINGS_FILE = "frame_timings.csv";
+    constexpr const char* FONT_ATLAS_CACHE_FILE = "font_atlas.cache";
+    constexpr const char* TRACE_FILE = "trace.json";                // Chrome trace-event JSON
 }
 
 // Global state management for TF2 overlay
@@ -0,0 +1,268 @@
+#include "dx9Renderer.h"
+#include "imgui_impl_dx9.h"
+#include "../debugMessage.h"
+
+namespace {
+    constexpr DWORD OVERLAY_FVF = D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1;
+
+    static_assert(sizeof(render::SourceVertex) == sizeof(ImDrawVert), "ImDrawVert layout changed");
+    static_assert(sizeof(ImDrawIdx) == sizeof(uint16_t), "The overlay renderer expects 16-bit ImDrawIdx");
+
+    const D3DMATRIX IDENTITY = { { {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    } } };
+
+    template<typename T>
+    void SafeRelease(T*& object) {
+        if (object) {
+            object->Release();
+            object = nullptr;
+        }
+    }
+}
+
+render::Dx9Device::Dx9Device(IDirect3DDevice9* device) : device(device) {
+    if (device) {
+        device->AddRef();
+    }
+}
+
+render::Dx9Device::~Dx9Device() {
+    ReleaseStateBlocks();
+    ReleaseBuffers();
+    SafeRelease(device);
+}
+
+bool render::Dx9Device::CreateBuffers(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    ReleaseBuffers();
+    if (!device) {
+        return false;
+    }
+
+    if (FAILED(device->CreateVertexBuffer(vertexCapacity * sizeof(Vertex), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY,
+        OVERLAY_FVF, D3DPOOL_DEFAULT, &vertexBuffer, nullptr))) {
+        LOGERROR("Failed to create overlay vertex buffer", vertexCapacity);
+        return false;
+    }
+    if (FAILED(device->CreateIndexBuffer(indexCapacity * sizeof(uint16_t), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY,
+        D3DFMT_INDEX16, D3DPOOL_DEFAULT, &indexBuffer, nullptr))) {
+        LOGERROR("Failed to create overlay index buffer", indexCapacity);
+        ReleaseBuffers();
+        return false;
+    }
+
+    LOGHEX("Overlay buffers created (vertices)", vertexCapacity);
+    return true;
+}
+
+void render::Dx9Device::ReleaseBuffers() {
+    SafeRelease(vertexBuffer);
+    SafeRelease(indexBuffer);
+}
+
+void render::Dx9Device::RecordStates() {
+    // Same states as ImGui_ImplDX9_SetupRenderState; the per-frame ones (viewport, projection,
+    // buffers) are set by BeginOverlay but recorded here so the game's values are saved too
+    D3DVIEWPORT9 viewport = { 0, 0, 1, 1, 0.0f, 1.0f };
+    device->SetViewport(&viewport);
+    device->SetStreamSource(0, nullptr, 0, 0);
+    device->SetIndices(nullptr);
+    device->SetFVF(OVERLAY_FVF);
+    device->SetTexture(0, nullptr);
+    RECT scissor = { 0, 0, 1, 1 };
+    device->SetScissorRect(&scissor);
+
+    device->SetPixelShader(nullptr);
+    device->SetVertexShader(nullptr);
+    device->SetRenderState(D3DRS_FILLMODE, D3DFILL_SOLID);
+    device->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
+    device->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+    device->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    device->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    device->SetRenderState(D3DRS_ZENABLE, FALSE);
+    device->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    device->SetRenderState(D3DRS_BLENDOP, D3DBLENDOP_ADD);
+    device->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    device->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    device->SetRenderState(D3DRS_SEPARATEALPHABLENDENABLE, TRUE);
+    device->SetRenderState(D3DRS_SRCBLENDALPHA, D3DBLEND_ONE);
+    device->SetRenderState(D3DRS_DESTBLENDALPHA, D3DBLEND_INVSRCALPHA);
+    device->SetRenderState(D3DRS_SCISSORTESTENABLE, TRUE);
+    device->SetRenderState(D3DRS_FOGENABLE, FALSE);
+    device->SetRenderState(D3DRS_RANGEFOGENABLE, FALSE);
+    device->SetRenderState(D3DRS_SPECULARENABLE, FALSE);
+    device->SetRenderState(D3DRS_STENCILENABLE, FALSE);
+    device->SetRenderState(D3DRS_CLIPPING, TRUE);
+    device->SetRenderState(D3DRS_LIGHTING, FALSE);
+    device->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    device->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    device->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+    device->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    device->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    device->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+    device->SetTextureStageState(1, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    device->SetTextureStageState(1, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    device->SetSamplerState(0, D3DSAMP_MINFILTER, D3DTEXF_LINEAR);
+    device->SetSamplerState(0, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR);
+    device->SetTransform(D3DTS_WORLD, &IDENTITY);
+    device->SetTransform(D3DTS_VIEW, &IDENTITY);
+    device->SetTransform(D3DTS_PROJECTION, &IDENTITY);
+}
+
+bool render::Dx9Device::CreateStateBlocks() {
+    ReleaseStateBlocks();
+    if (!device) {
+        return false;
+    }
+
+    IDirect3DStateBlock9** blocks[] = { &overlayState, &savedState };
+    for (IDirect3DStateBlock9** block : blocks) {
+        if (FAILED(device->BeginStateBlock())) {
+            ReleaseStateBlocks();
+            return false;
+        }
+        RecordStates();
+        if (FAILED(device->EndStateBlock(block))) {
+            ReleaseStateBlocks();
+            return false;
+        }
+    }
+    return true;
+}
+
+void render::Dx9Device::ReleaseStateBlocks() {
+    SafeRelease(overlayState);
+    SafeRelease(savedState);
+}
+
+render::Vertex* render::Dx9Device::LockVertices(uint32_t first, uint32_t count, bool discard) {
+    void* data = nullptr;
+    if (!vertexBuffer || FAILED(vertexBuffer->Lock(first * sizeof(Vertex), count * sizeof(Vertex), &data,
+        discard ? D3DLOCK_DISCARD : D3DLOCK_NOOVERWRITE))) {
+        return nullptr;
+    }
+    return static_cast<Vertex*>(data);
+}
+
+void render::Dx9Device::UnlockVertices() {
+    vertexBuffer->Unlock();
+}
+
+uint16_t* render::Dx9Device::LockIndices(uint32_t first, uint32_t count, bool discard) {
+    void* data = nullptr;
+    if (!indexBuffer || FAILED(indexBuffer->Lock(first * sizeof(uint16_t), count * sizeof(uint16_t), &data,
+        discard ? D3DLOCK_DISCARD : D3DLOCK_NOOVERWRITE))) {
+        return nullptr;
+    }
+    return static_cast<uint16_t*>(data);
+}
+
+void render::Dx9Device::UnlockIndices() {
+    indexBuffer->Unlock();
+}
+
+void render::Dx9Device::BeginOverlay(const FrameView& frame) {
+    savedState->Capture();
+    overlayState->Apply();
+
+    device->SetStreamSource(0, vertexBuffer, 0, sizeof(Vertex));
+    device->SetIndices(indexBuffer);
+
+    D3DVIEWPORT9 viewport = { 0, 0, static_cast<DWORD>(frame.displayWidth), static_cast<DWORD>(frame.displayHeight), 0.0f, 1.0f };
+    device->SetViewport(&viewport);
+
+    // Orthographic projection of the display rectangle (half-pixel offset of D3D9)
+    const float left = frame.displayX + 0.5f;
+    const float right = frame.displayX + frame.displayWidth + 0.5f;
+    const float top = frame.displayY + 0.5f;
+    const float bottom = frame.displayY + frame.displayHeight + 0.5f;
+    const D3DMATRIX projection = { { {
+        2.0f / (right - left), 0.0f, 0.0f, 0.0f,
+        0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
+        0.0f, 0.0f, 0.5f, 0.0f,
+        (left + right) / (left - right), (top + bottom) / (bottom - top), 0.5f, 1.0f
+    } } };
+    device->SetTransform(D3DTS_PROJECTION, &projection);
+}
+
+void render::Dx9Device::EndOverlay() {
+    savedState->Apply();
+}
+
+void render::Dx9Device::SetTexture(uint64_t texture) {
+    device->SetTexture(0, reinterpret_cast<IDirect3DTexture9*>(static_cast<uintptr_t>(texture)));
+}
+
+void render::Dx9Device::SetScissor(const ScissorRect& scissor) {
+    const RECT rect = { scissor.left, scissor.top, scissor.right, scissor.bottom };
+    device->SetScissorRect(&rect);
+}
+
+void render::Dx9Device::DrawIndexed(uint32_t baseVertex, uint32_t vertexCount, uint32_t startIndex, uint32_t primitiveCount) {
+    device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, static_cast<INT>(baseVertex), 0, vertexCount, startIndex, primitiveCount);
+}
+
+render::Dx9Renderer::Dx9Renderer(IDirect3DDevice9* d3dDevice) : device(d3dDevice), renderer(device) {
+}
+
+void render::Dx9Renderer::RenderDrawData(ImDrawData* drawData, uint64_t generation) {
+    if (!drawData) {
+        return;
+    }
+#ifdef IMGUI_HAS_TEXTURES
+    // Font atlas creation and updates still go through the backend
+    if (drawData->Textures) {
+        for (ImTextureData* texture : *drawData->Textures) {
+            if (texture->Status != ImTextureStatus_OK) {
+                ImGui_ImplDX9_UpdateTexture(texture);
+            }
+        }
+    }
+#endif
+    if (!drawData->Valid || drawData->DisplaySize.x <= 0.0f || drawData->DisplaySize.y <= 0.0f) {
+        return;
+    }
+
+    // Commands first: lists point into the vector once it stops growing
+    commands.clear();
+    for (int i = 0; i < drawData->CmdListsCount; i++) {
+        for (const ImDrawCmd& command : drawData->CmdLists[i]->CmdBuffer) {
+            // The overlay registers no draw callbacks
+            if (command.UserCallback) {
+                continue;
+            }
+            commands.push_back({ { command.ClipRect.x, command.ClipRect.y, command.ClipRect.z, command.ClipRect.w },
+                static_cast<uint64_t>((uintptr_t)command.GetTexID()), command.ElemCount, command.IdxOffset, command.VtxOffset });
+        }
+    }
+
+    lists.clear();
+    size_t commandIndex = 0;
+    for (int i = 0; i < drawData->CmdListsCount; i++) {
+        const ImDrawList* list = drawData->CmdLists[i];
+        const size_t first = commandIndex;
+        for (const ImDrawCmd& command : list->CmdBuffer) {
+            if (!command.UserCallback) {
+                commandIndex++;
+            }
+        }
+        lists.push_back({ reinterpret_cast<const SourceVertex*>(list->VtxBuffer.Data), static_cast<uint32_t>(list->VtxBuffer.Size),
+            list->IdxBuffer.Data, static_cast<uint32_t>(list->IdxBuffer.Size),
+            commands.data() + first, static_cast<uint32_t>(commandIndex - first) });
+    }
+
+    FrameView frame;
+    frame.displayX = drawData->DisplayPos.x;
+    frame.displayY = drawData->DisplayPos.y;
+    frame.displayWidth = drawData->DisplaySize.x;
+    frame.displayHeight = drawData->DisplaySize.y;
+    frame.lists = lists.data();
+    frame.listCount = lists.size();
+    frame.totalVertices = static_cast<uint32_t>(drawData->TotalVtxCount);
+    frame.totalIndices = static_cast<uint32_t>(drawData->TotalIdxCount);
+    frame.generation = generation;
+    renderer.Render(frame);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <d3d9.h>
+#include <vector>
+#include "imgui.h"
+#include "overlayRenderer.h"
+#include "../Core/overlayHeap.h"
+
+// Direct3D 9 side of the overlay renderer.
+// Buffers are D3DPOOL_DEFAULT dynamic write-only buffers, so they are released before a device
+// reset and recreated after it. The overlay's render states are recorded into one state block,
+// and a second block recorded over the same states captures the game's values each frame, so
+// only what the overlay changes is saved and restored (instead of a D3DSBT_ALL block per frame).
+namespace render {
+    class Dx9Device final : public IRenderDevice {
+    public:
+        explicit Dx9Device(IDirect3DDevice9* device);
+        ~Dx9Device() override;
+
+        Dx9Device(const Dx9Device&) = delete;
+        Dx9Device& operator=(const Dx9Device&) = delete;
+
+        bool CreateBuffers(uint32_t vertexCapacity, uint32_t indexCapacity) override;
+        void ReleaseBuffers() override;
+        bool CreateStateBlocks() override;
+        void ReleaseStateBlocks() override;
+
+        Vertex* LockVertices(uint32_t first, uint32_t count, bool discard) override;
+        void UnlockVertices() override;
+        uint16_t* LockIndices(uint32_t first, uint32_t count, bool discard) override;
+        void UnlockIndices() override;
+
+        void BeginOverlay(const FrameView& frame) override;
+        void EndOverlay() override;
+
+        void SetTexture(uint64_t texture) override;
+        void SetScissor(const ScissorRect& scissor) override;
+        void DrawIndexed(uint32_t baseVertex, uint32_t vertexCount, uint32_t startIndex, uint32_t primitiveCount) override;
+
+    private:
+        void RecordStates();
+
+        IDirect3DDevice9* device;
+        IDirect3DVertexBuffer9* vertexBuffer = nullptr;
+        IDirect3DIndexBuffer9* indexBuffer = nullptr;
+        IDirect3DStateBlock9* overlayState = nullptr;  // Our fixed states, applied every frame
+        IDirect3DStateBlock9* savedState = nullptr;    // The game's values of the same states
+    };
+
+    /**
+     * @brief Feeds ImGui draw data to an OverlayRenderer on a Dx9Device
+     */
+    class Dx9Renderer {
+    public:
+        explicit Dx9Renderer(IDirect3DDevice9* d3dDevice);
+
+        bool CreateDeviceObjects() { return renderer.CreateDeviceObjects(); }
+        void InvalidateDeviceObjects() { renderer.InvalidateDeviceObjects(); }
+
+        /**
+         * @brief Draw ImGui output
+         * @param drawData Draw data (ImGui::GetDrawData() or a replay)
+         * @param generation Non-zero id of the geometry; pass the same id to redraw without uploading
+         */
+        void RenderDrawData(ImDrawData* drawData, uint64_t generation = 0);
+
+        const RenderStats& LastStats() const { return renderer.LastStats(); }
+
+    private:
+        Dx9Device device;
+        OverlayRenderer renderer;
+        core::HeapVector<DrawListView> lists;
+        core::HeapVector<DrawCommand> commands;
+    };
+}
\ No newline at end of file
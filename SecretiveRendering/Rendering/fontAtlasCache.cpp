@@ -0,0 +1,524 @@
+#include "fontAtlasCache.h"
+#include "imgui_internal.h"
+#include "../Core/startupTimeline.h"
+#include "../Core/traceRecorder.h"
+#include "../Core/workerPool.h"
+#include "../Scanning/signatureCache.h"
+#include "../debugMessage.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+#ifndef IMGUI_HAS_TEXTURES
+    constexpr char CACHE_MAGIC[8] = { 'T', 'F', '2', 'S', 'R', 'F', 'N', 'T' };
+    constexpr uint32_t CACHE_VERSION = 2;
+    constexpr uint32_t MAX_TEXTURE_SIZE = 16384;
+    constexpr size_t MAX_RUN = 255;
+
+    // File layout: header, atlas UVs, custom rects, per font its metrics then its glyphs, then the
+    // RLE pixels. Glyphs registered from custom rects are left out; ImFontAtlasBuildFinish adds them
+    struct CacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t fontCount;
+        uint64_t configHash;    // HashAtlasConfig(): ImGui version and everything the rasterizer reads
+        uint32_t width;
+        uint32_t height;
+        uint32_t lineCount;     // TexUvLines entries
+        uint32_t pixelBytes;    // Encoded alpha pixels
+        uint32_t customRectCount;
+        int32_t packIdMouseCursors;
+        int32_t packIdLines;
+    };
+
+    /**
+     * @brief Packed custom rect (mouse cursors, baked lines, user rects)
+     */
+    struct CachedRect {
+        uint16_t width, height;
+        uint16_t x, y;
+        uint32_t glyphId;
+        float advanceX;
+        float offsetX, offsetY;
+        int32_t font;           // Index into Fonts, or -1
+    };
+
+    struct CachedFont {
+        float ascent;
+        float descent;
+        uint32_t glyphCount;
+    };
+
+    struct CachedGlyph {
+        uint32_t codepoint;
+        uint32_t colored;
+        float advanceX;
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1;
+    };
+
+    template<typename T>
+    uint64_t HashValue(const T& value, uint64_t seed) {
+        return scanner::HashBytes(reinterpret_cast<const uint8_t*>(&value), sizeof(T), seed);
+    }
+
+    /**
+     * @brief Hash of the inputs that decide the rasterized atlas
+     */
+    uint64_t HashAtlasConfig(const ImFontAtlas& atlas) {
+        uint64_t hash = HashValue(IMGUI_VERSION_NUM, 0);
+        hash = HashValue(sizeof(ImFontGlyph), hash);
+        hash = HashValue(atlas.Flags, hash);
+        hash = HashValue(atlas.TexDesiredWidth, hash);
+        hash = HashValue(atlas.TexGlyphPadding, hash);
+        // User rects (added before the build; the atlas adds its own while building)
+        for (const ImFontAtlasCustomRect& rect : atlas.CustomRects) {
+            hash = HashValue(rect.Width, hash);
+            hash = HashValue(rect.Height, hash);
+            hash = HashValue(static_cast<uint32_t>(rect.GlyphID), hash);
+            hash = HashValue(rect.GlyphAdvanceX, hash);
+            hash = HashValue(rect.GlyphOffset.x, hash);
+            hash = HashValue(rect.GlyphOffset.y, hash);
+        }
+        for (const ImFontConfig& config : atlas.ConfigData) {
+            hash = scanner::HashBytes(static_cast<const uint8_t*>(config.FontData), static_cast<size_t>(config.FontDataSize), hash);
+            hash = HashValue(config.FontNo, hash);
+            hash = HashValue(config.SizePixels, hash);
+            hash = HashValue(config.OversampleH, hash);
+            hash = HashValue(config.OversampleV, hash);
+            hash = HashValue(config.PixelSnapH, hash);
+            hash = HashValue(config.GlyphOffset.x, hash);
+            hash = HashValue(config.GlyphOffset.y, hash);
+            hash = HashValue(config.GlyphMinAdvanceX, hash);
+            hash = HashValue(config.GlyphMaxAdvanceX, hash);
+            hash = HashValue(config.MergeMode, hash);
+            hash = HashValue(config.RasterizerMultiply, hash);
+            for (const ImWchar* range = config.GlyphRanges; range && range[0]; range += 2) {
+                hash = HashValue(range[0], hash);
+                hash = HashValue(range[1], hash);
+            }
+        }
+        return hash;
+    }
+
+    template<typename T>
+    void Append(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    /**
+     * @brief Bounds-checked reads from a loaded cache file
+     */
+    struct Reader {
+        const uint8_t* data;
+        size_t size;
+        size_t offset = 0;
+
+        template<typename T>
+        bool Read(T& value) {
+            if (size - offset < sizeof(T)) {
+                return false;
+            }
+            memcpy(&value, data + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        }
+
+        size_t Remaining() const { return size - offset; }
+    };
+
+    /**
+     * @brief Run-length encode alpha pixels as (count, value) pairs; the atlas is mostly empty
+     */
+    void EncodeRuns(const uint8_t* pixels, size_t count, std::vector<uint8_t>& out) {
+        for (size_t i = 0; i < count;) {
+            size_t run = 1;
+            while (i + run < count && run < MAX_RUN && pixels[i + run] == pixels[i]) {
+                run++;
+            }
+            out.push_back(static_cast<uint8_t>(run));
+            out.push_back(pixels[i]);
+            i += run;
+        }
+    }
+
+    bool DecodeRuns(const uint8_t* data, size_t size, uint8_t* pixels, size_t count) {
+        if (size % 2) {
+            return false;
+        }
+        size_t written = 0;
+        for (size_t i = 0; i < size; i += 2) {
+            const size_t run = data[i];
+            if (!run || run > count - written) {
+                return false;
+            }
+            memset(pixels + written, data[i + 1], run);
+            written += run;
+        }
+        return written == count;
+    }
+
+    int32_t FontIndex(const ImFontAtlas& atlas, const ImFont* font) {
+        for (int i = 0; i < atlas.Fonts.Size; i++) {
+            if (atlas.Fonts[i] == font) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Whether ImFontAtlasBuildFinish registers a glyph for the rect
+     */
+    bool IsGlyphRect(const ImFontAtlasCustomRect& rect) {
+        return rect.Font && rect.GlyphID != 0;
+    }
+
+    /**
+     * @brief Cache file contents for a built atlas
+     * @return Empty if the atlas has no alpha pixels (colored glyphs are not cached)
+     */
+    std::vector<uint8_t> SerializeAtlas(const ImFontAtlas& atlas, uint64_t configHash) {
+        std::vector<uint8_t> out;
+        if (!atlas.TexPixelsAlpha8 || atlas.TexWidth <= 0 || atlas.TexHeight <= 0) {
+            return out;
+        }
+
+        std::vector<uint8_t> pixels;
+        EncodeRuns(atlas.TexPixelsAlpha8, static_cast<size_t>(atlas.TexWidth) * atlas.TexHeight, pixels);
+
+        CacheHeader header = {};
+        memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+        header.version = CACHE_VERSION;
+        header.fontCount = static_cast<uint32_t>(atlas.Fonts.Size);
+        header.configHash = configHash;
+        header.width = static_cast<uint32_t>(atlas.TexWidth);
+        header.height = static_cast<uint32_t>(atlas.TexHeight);
+        header.lineCount = static_cast<uint32_t>(IM_ARRAYSIZE(atlas.TexUvLines));
+        header.pixelBytes = static_cast<uint32_t>(pixels.size());
+        header.customRectCount = static_cast<uint32_t>(atlas.CustomRects.Size);
+        header.packIdMouseCursors = atlas.PackIdMouseCursors;
+        header.packIdLines = atlas.PackIdLines;
+
+        Append(out, header);
+        Append(out, atlas.TexUvScale);
+        Append(out, atlas.TexUvWhitePixel);
+        for (const ImVec4& line : atlas.TexUvLines) {
+            Append(out, line);
+        }
+
+        // ImFontAtlasBuildFinish appended one glyph per glyph rect, in rect order, after the rasterized ones
+        std::vector<uint32_t> rectGlyphs(static_cast<size_t>(atlas.Fonts.Size), 0);
+        for (const ImFontAtlasCustomRect& rect : atlas.CustomRects) {
+            const int32_t font = rect.Font ? FontIndex(atlas, rect.Font) : -1;
+            if (rect.Font && font < 0) {
+                return std::vector<uint8_t>();
+            }
+            if (IsGlyphRect(rect)) {
+                rectGlyphs[font]++;
+            }
+            Append(out, CachedRect{ rect.Width, rect.Height, rect.X, rect.Y, static_cast<uint32_t>(rect.GlyphID),
+                rect.GlyphAdvanceX, rect.GlyphOffset.x, rect.GlyphOffset.y, font });
+        }
+
+        for (int i = 0; i < atlas.Fonts.Size; i++) {
+            const ImFont* font = atlas.Fonts[i];
+            if (static_cast<uint32_t>(font->Glyphs.Size) < rectGlyphs[i]) {
+                return std::vector<uint8_t>();
+            }
+            const uint32_t glyphCount = static_cast<uint32_t>(font->Glyphs.Size) - rectGlyphs[i];
+            Append(out, CachedFont{ font->Ascent, font->Descent, glyphCount });
+            for (uint32_t g = 0; g < glyphCount; g++) {
+                const ImFontGlyph& glyph = font->Glyphs[static_cast<int>(g)];
+                Append(out, CachedGlyph{ glyph.Codepoint, glyph.Colored, glyph.AdvanceX,
+                    glyph.X0, glyph.Y0, glyph.X1, glyph.Y1, glyph.U0, glyph.V0, glyph.U1, glyph.V1 });
+            }
+        }
+        out.insert(out.end(), pixels.begin(), pixels.end());
+        return out;
+    }
+
+    /**
+     * @brief Restore an atlas from cache file contents instead of rasterizing it
+     * The file is validated completely before the atlas is touched, so on failure the atlas can
+     * still be built normally.
+     * @param atlas Atlas with the same fonts added as when the cache was written
+     */
+    bool DeserializeAtlas(const std::vector<uint8_t>& file, uint64_t configHash, ImFontAtlas& atlas) {
+        Reader reader = { file.data(), file.size() };
+        CacheHeader header;
+        if (!reader.Read(header) || memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) || header.version != CACHE_VERSION) {
+            return false;
+        }
+        if (header.configHash != configHash || header.fontCount != static_cast<uint32_t>(atlas.Fonts.Size) ||
+            header.lineCount != static_cast<uint32_t>(IM_ARRAYSIZE(atlas.TexUvLines)) ||
+            !header.width || !header.height || header.width > MAX_TEXTURE_SIZE || header.height > MAX_TEXTURE_SIZE) {
+            return false;
+        }
+
+        ImVec2 uvScale;
+        ImVec2 uvWhitePixel;
+        ImVec4 uvLines[IM_ARRAYSIZE(atlas.TexUvLines)];
+        if (!reader.Read(uvScale) || !reader.Read(uvWhitePixel)) {
+            return false;
+        }
+        for (ImVec4& line : uvLines) {
+            if (!reader.Read(line)) {
+                return false;
+            }
+        }
+
+        // The cursor and line rects must be there and packed: ImFontAtlasBuildFinish renders into them
+        if (header.customRectCount > reader.Remaining() / sizeof(CachedRect) ||
+            header.packIdMouseCursors < 0 || static_cast<uint32_t>(header.packIdMouseCursors) >= header.customRectCount ||
+            (header.packIdLines >= 0 && static_cast<uint32_t>(header.packIdLines) >= header.customRectCount)) {
+            return false;
+        }
+        std::vector<CachedRect> rects(header.customRectCount);
+        for (CachedRect& rect : rects) {
+            reader.Read(rect);
+            if (rect.font < -1 || rect.font >= static_cast<int32_t>(header.fontCount) ||
+                static_cast<uint32_t>(rect.x) + rect.width > header.width || static_cast<uint32_t>(rect.y) + rect.height > header.height) {
+                return false;
+            }
+        }
+
+        std::vector<CachedFont> fonts(header.fontCount);
+        std::vector<std::vector<CachedGlyph>> glyphs(header.fontCount);
+        for (uint32_t i = 0; i < header.fontCount; i++) {
+            if (!reader.Read(fonts[i]) || fonts[i].glyphCount > reader.Remaining() / sizeof(CachedGlyph)) {
+                return false;
+            }
+            glyphs[i].resize(fonts[i].glyphCount);
+            for (CachedGlyph& glyph : glyphs[i]) {
+                reader.Read(glyph);
+            }
+        }
+
+        const size_t pixelCount = static_cast<size_t>(header.width) * header.height;
+        std::vector<uint8_t> pixels(pixelCount);
+        if (reader.Remaining() != header.pixelBytes ||
+            !DecodeRuns(file.data() + reader.offset, header.pixelBytes, pixels.data(), pixelCount)) {
+            return false;
+        }
+
+        // Valid: set the atlas up the way the rasterizer would have left it
+        atlas.ClearTexData();
+        atlas.TexWidth = static_cast<int>(header.width);
+        atlas.TexHeight = static_cast<int>(header.height);
+        atlas.TexUvScale = uvScale;
+        atlas.TexUvWhitePixel = uvWhitePixel;
+        memcpy(atlas.TexUvLines, uvLines, sizeof(uvLines));
+        atlas.TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixelCount));
+        memcpy(atlas.TexPixelsAlpha8, pixels.data(), pixelCount);
+
+        atlas.CustomRects.resize(static_cast<int>(rects.size()));
+        for (size_t i = 0; i < rects.size(); i++) {
+            const CachedRect& cached = rects[i];
+            ImFontAtlasCustomRect& rect = atlas.CustomRects[static_cast<int>(i)];
+            rect = ImFontAtlasCustomRect();
+            rect.Width = cached.width;
+            rect.Height = cached.height;
+            rect.X = cached.x;
+            rect.Y = cached.y;
+            rect.GlyphID = cached.glyphId;
+            rect.GlyphAdvanceX = cached.advanceX;
+            rect.GlyphOffset = ImVec2(cached.offsetX, cached.offsetY);
+            rect.Font = cached.font >= 0 ? atlas.Fonts[cached.font] : nullptr;
+        }
+        atlas.PackIdMouseCursors = header.packIdMouseCursors;
+        atlas.PackIdLines = header.packIdLines;
+
+        for (ImFontConfig& config : atlas.ConfigData) {
+            for (int i = 0; i < atlas.Fonts.Size; i++) {
+                if (atlas.Fonts[i] == config.DstFont) {
+                    ImFontAtlasBuildSetupFont(&atlas, config.DstFont, &config, fonts[i].ascent, fonts[i].descent);
+                }
+            }
+        }
+        for (int i = 0; i < atlas.Fonts.Size; i++) {
+            ImFont* font = atlas.Fonts[i];
+            // No config: the cached glyphs already have advance and snapping applied
+            for (const CachedGlyph& glyph : glyphs[i]) {
+                font->AddGlyph(nullptr, static_cast<ImWchar>(glyph.codepoint), glyph.x0, glyph.y0, glyph.x1, glyph.y1,
+                    glyph.u0, glyph.v0, glyph.u1, glyph.v1, glyph.advanceX);
+                font->Glyphs.back().Colored = glyph.colored ? 1 : 0;
+            }
+        }
+
+        // The rasterizer's own last step: cursor and line pixels (identical to the cached ones),
+        // custom rect glyphs, lookup tables, ellipsis and dot characters, TexReady
+        ImFontAtlasBuildFinish(&atlas);
+        return true;
+    }
+
+    bool ReadFile(const std::string& path, std::vector<uint8_t>& contents) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !contents.empty();
+    }
+
+    bool WriteFile(const std::string& path, const std::vector<uint8_t>& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+        return static_cast<bool>(file);
+    }
+#endif
+}
+
+void render::FontAtlasCache::BeginWarmUp(const std::string& cachePath) {
+    core::WorkerPool* pool = core::GetWorkerPool();
+    if (!pool || started.exchange(true)) {
+        return; // Without a pool WaitForAtlas bakes on the calling thread
+    }
+    pool->Submit([this, cachePath]() {
+        Bake(cachePath);
+    });
+}
+
+void render::FontAtlasCache::Bake(const std::string& cachePath) {
+    core::TraceScope trace("Font atlas bake");
+#ifdef IMGUI_HAS_TEXTURES
+    (void)cachePath;
+#else
+    // No ImGui context exists yet (the render thread waits for us before creating it), so the
+    // atlas allocations are not counted against one
+    const Clock::time_point start = Clock::now();
+    ImFontAtlas* built = IM_NEW(ImFontAtlas)();
+    built->AddFontDefault();
+    const uint64_t configHash = HashAtlasConfig(*built);
+
+    std::vector<uint8_t> file;
+    if (!cachePath.empty() && ReadFile(cachePath, file) && DeserializeAtlas(file, configHash, *built)) {
+        warmUp.fromCache = true;
+        warmUp.cacheBytes = file.size();
+    } else if (built->Build()) {
+        file = SerializeAtlas(*built, configHash);
+        if (!cachePath.empty() && !file.empty()) {
+            if (WriteFile(cachePath, file)) {
+                warmUp.cacheBytes = file.size();
+            } else {
+                LOGWARN("Failed to write font atlas cache", cachePath);
+            }
+        }
+    } else {
+        LOGERROR("Failed to build font atlas", 0);
+        IM_DELETE(built);
+        built = nullptr;
+    }
+
+    if (built) {
+        // Converted here so the render thread only copies rows into the texture
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        const size_t count = static_cast<size_t>(built->TexWidth) * built->TexHeight;
+        if (built->TexPixelsAlpha8) {
+            built->GetTexDataAsAlpha8(&pixels, &width, &height);
+            texels.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                texels[i] = (static_cast<uint32_t>(pixels[i]) << 24) | 0x00FFFFFF;
+            }
+        } else {
+            // Colored glyphs: RGBA bytes to D3DCOLOR
+            built->GetTexDataAsRGBA32(&pixels, &width, &height);
+            texels.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                const uint8_t* rgba = pixels + i * 4;
+                texels[i] = (static_cast<uint32_t>(rgba[3]) << 24) | (static_cast<uint32_t>(rgba[0]) << 16) |
+                    (static_cast<uint32_t>(rgba[1]) << 8) | rgba[2];
+            }
+        }
+
+        warmUp.width = static_cast<uint32_t>(width);
+        warmUp.height = static_cast<uint32_t>(height);
+        warmUp.atlasMs = MillisecondsSince(start);
+        atlas = built;
+        LOGHEX("Font atlas read from cache", warmUp.fromCache);
+        core::GetStartupTimeline().Mark("Startup (ms): font atlas baked");
+    }
+#endif
+    baked.store(true, std::memory_order_release);
+}
+
+ImFontAtlas* render::FontAtlasCache::WaitForAtlas() {
+    if (!started.exchange(true)) {
+        Bake(std::string());
+    }
+
+    const Clock::time_point start = Clock::now();
+    core::WorkerPool* pool = core::GetWorkerPool();
+    while (!baked.load(std::memory_order_acquire)) {
+        // Help out instead of sleeping; if nothing is queued the bake is running elsewhere
+        if (!pool || !pool->RunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+    warmUp.waitMs = MillisecondsSince(start);
+    return atlas;
+}
+
+bool render::FontAtlasCache::CreateTexture(IDirect3DDevice9* device) {
+    if (!device || !atlas || texels.empty() || texture) {
+        return texture != nullptr;
+    }
+
+    const Clock::time_point start = Clock::now();
+    if (FAILED(device->CreateTexture(warmUp.width, warmUp.height, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &texture, nullptr))) {
+        LOGERROR("Failed to create font texture", warmUp.width);
+        texture = nullptr;
+        return false;
+    }
+
+    D3DLOCKED_RECT locked;
+    if (FAILED(texture->LockRect(0, &locked, nullptr, 0))) {
+        LOGERROR("Failed to lock font texture", warmUp.width);
+        texture->Release();
+        texture = nullptr;
+        return false;
+    }
+    for (uint32_t y = 0; y < warmUp.height; y++) {
+        memcpy(static_cast<uint8_t*>(locked.pBits) + static_cast<size_t>(y) * locked.Pitch,
+            texels.data() + static_cast<size_t>(y) * warmUp.width, warmUp.width * sizeof(uint32_t));
+    }
+    texture->UnlockRect(0);
+
+    atlas->SetTexID(reinterpret_cast<ImTextureID>(texture));
+    std::vector<uint32_t>().swap(texels);
+    warmUp.textureMs = MillisecondsSince(start);
+    return true;
+}
+
+void render::FontAtlasCache::Release() {
+    if (texture) {
+        texture->Release();
+        texture = nullptr;
+    }
+    // A bake still running on a worker owns the atlas until it finishes
+    if (atlas && baked.load(std::memory_order_acquire)) {
+        IM_DELETE(atlas);
+        atlas = nullptr;
+    }
+}
+
+render::FontAtlasCache& render::GetFontAtlasCache() {
+    static FontAtlasCache cache;
+    return cache;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <d3d9.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "imgui.h"
+
+// Font atlas baked off the render thread and kept in a managed-pool texture.
+// The atlas is built on a worker while the hooks are installed: read from a binary cache written
+// on the first run (glyph tables and RLE-compressed alpha pixels, keyed by the ImGui version and
+// the font configuration) or rasterized and then cached. The first hkPresent only creates the
+// context around the finished atlas and uploads it once into a D3DPOOL_MANAGED texture, which
+// the runtime restores itself after a device reset; nothing is re-rasterized or re-uploaded.
+// With IMGUI_HAS_TEXTURES (ImGui 1.92+) glyphs are rasterized on demand and the backend owns
+// the textures, so the cache steps aside and ImGui builds its own atlas.
+namespace render {
+    /**
+     * @brief Where the warm-up time went
+     */
+    struct FontWarmUp {
+        bool fromCache = false;     // Atlas read from the cache instead of rasterized
+        double atlasMs = 0.0;       // Load or rasterize (worker thread)
+        double waitMs = 0.0;        // Render thread blocked waiting for the worker
+        double textureMs = 0.0;     // Managed texture creation and upload
+        uint32_t width = 0;
+        uint32_t height = 0;
+        size_t cacheBytes = 0;      // Size of the cache file read or written
+    };
+
+    class FontAtlasCache {
+    public:
+        FontAtlasCache() = default;
+
+        FontAtlasCache(const FontAtlasCache&) = delete;
+        FontAtlasCache& operator=(const FontAtlasCache&) = delete;
+
+        /**
+         * @brief Start baking the atlas on the worker pool
+         * @param cachePath Cache file path (empty: always rasterize, nothing is written)
+         */
+        void BeginWarmUp(const std::string& cachePath);
+
+        /**
+         * @brief Finished atlas to pass to ImGui::CreateContext (bakes inline if BeginWarmUp was not called)
+         * The atlas stays owned by the cache; destroy the context before Release.
+         * @return nullptr when ImGui builds its own atlas (IMGUI_HAS_TEXTURES) or baking failed
+         */
+        ImFontAtlas* WaitForAtlas();
+
+        /**
+         * @brief Upload the atlas into a managed texture and make it the atlas' texture id
+         * @return false if there is no atlas or the texture could not be created (the backend's
+         *         default-pool font texture is used instead)
+         */
+        bool CreateTexture(IDirect3DDevice9* device);
+
+        /**
+         * @brief True while the managed texture is the font texture (no backend texture to rebuild on reset)
+         */
+        bool HasTexture() const { return texture != nullptr; }
+
+        /**
+         * @brief Release the texture and the atlas (after ImGui::DestroyContext)
+         */
+        void Release();
+
+        const FontWarmUp& WarmUp() const { return warmUp; }
+
+    private:
+        void Bake(const std::string& cachePath);
+
+        ImFontAtlas* atlas = nullptr;
+        std::vector<uint32_t> texels;   // ARGB copy of the atlas, dropped after the upload
+        IDirect3DTexture9* texture = nullptr;
+        std::atomic<bool> started{ false };
+        std::atomic<bool> baked{ false };
+        FontWarmUp warmUp;
+    };
+
+    /**
+     * @brief Font atlas of the overlay
+     */
+    FontAtlasCache& GetFontAtlasCache();
+}
\ No newline at end of file
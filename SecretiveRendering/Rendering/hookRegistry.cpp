@@ -0,0 +1,148 @@
+#include "hookRegistry.h"
+#include <chrono>
+#include "../Core/regionMap.h"
+#include "../debugMessage.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // A thread can have jumped into a detour without having counted itself yet; once the hooks
+    // are disabled no new one can, so the count must stay at zero this long
+    constexpr DWORD DETOUR_GRACE_MS = 50;
+
+    double MillisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+bool hooks::HookRegistry::Add(const char* name, void* target, void* detour, void** original) {
+    if (!target || !detour) {
+        LOGERROR("Hook registry: invalid parameters for", name);
+        return false;
+    }
+
+    if (!core::GetRegionMap().IsExecutable(reinterpret_cast<uintptr_t>(target))) {
+        LOGERROR("Hook registry: target is not executable memory", reinterpret_cast<uintptr_t>(target));
+        return false;
+    }
+
+    const Clock::time_point start = Clock::now();
+    MH_STATUS status = MH_CreateHook(target, detour, original);
+    const double createMs = MillisecondsSince(start);
+    if (status != MH_OK) {
+        LOGERROR("Hook registry: MH_CreateHook failed", MH_StatusToString(status));
+        return false;
+    }
+
+    entries.push_back({ name, target, detour, original, false, createMs });
+    LOGHEX("Hook registry: created hook", name);
+    return true;
+}
+
+bool hooks::HookRegistry::Apply(bool enable) {
+    lastTimings = TransactionTimings();
+
+    const Clock::time_point queueStart = Clock::now();
+    bool queued = false;
+    for (HookEntry& entry : entries) {
+        if (entry.enabled == enable) {
+            continue;
+        }
+        MH_STATUS status = enable ? MH_QueueEnableHook(entry.target) : MH_QueueDisableHook(entry.target);
+        if (status != MH_OK) {
+            LOGERROR("Hook registry: failed to queue", entry.name);
+            LOGERROR("Hook registry: status", MH_StatusToString(status));
+            return false;
+        }
+        queued = true;
+    }
+    lastTimings.queueMs = MillisecondsSince(queueStart);
+
+    if (!queued) {
+        return true;
+    }
+
+    // One freeze of every game thread for the whole set
+    const Clock::time_point applyStart = Clock::now();
+    MH_STATUS status = MH_ApplyQueued();
+    lastTimings.applyMs = MillisecondsSince(applyStart);
+    if (status != MH_OK) {
+        LOGERROR("Hook registry: MH_ApplyQueued failed", MH_StatusToString(status));
+        return false;
+    }
+
+    for (HookEntry& entry : entries) {
+        entry.enabled = enable;
+    }
+
+    // MinHook re-protected the patched pages while writing; re-read them
+    for (const HookEntry& entry : entries) {
+        const uintptr_t patched = reinterpret_cast<uintptr_t>(entry.target);
+        core::GetRegionMap().Refresh(patched, patched + 1);
+    }
+    return true;
+}
+
+bool hooks::HookRegistry::EnableAll() {
+    if (Apply(true)) {
+        LOGHEX("Hook registry: hooks enabled", entries.size());
+        LOGHEX("Hook registry: enable freeze (us)", static_cast<int>(lastTimings.applyMs * 1000.0));
+        return true;
+    }
+
+    // Roll back: put every hook back in the disabled state in one more transaction, then remove them
+    const TransactionTimings failed = lastTimings;
+    const Clock::time_point rollbackStart = Clock::now();
+    for (HookEntry& entry : entries) {
+        MH_QueueDisableHook(entry.target);  // State is unknown after a failed apply; disable them all
+        entry.enabled = false;
+    }
+    MH_ApplyQueued();
+    RemoveAll();
+
+    lastTimings = failed;
+    lastTimings.rollbackMs = MillisecondsSince(rollbackStart);
+    LOGERROR("Hook registry: enable failed and was rolled back (us)", static_cast<int>(lastTimings.rollbackMs * 1000.0));
+    return false;
+}
+
+bool hooks::HookRegistry::DisableAll() {
+    if (!Apply(false)) {
+        return false;
+    }
+    LOGHEX("Hook registry: disable freeze (us)", static_cast<int>(lastTimings.applyMs * 1000.0));
+    return true;
+}
+
+void hooks::HookRegistry::RemoveAll() {
+    // Removing an enabled hook freezes threads once per hook; disable them together first
+    for (const HookEntry& entry : entries) {
+        if (entry.enabled) {
+            DisableAll();
+            break;
+        }
+    }
+
+    for (const HookEntry& entry : entries) {
+        MH_RemoveHook(entry.target);
+    }
+    entries.clear();
+}
+
+std::atomic<uint32_t> hooks::DetourCall::inFlight{ 0 };
+
+bool hooks::WaitForDetours(DWORD timeoutMs) {
+    const Clock::time_point start = Clock::now();
+    for (;;) {
+        if (DetourCall::InFlight() == 0) {
+            Sleep(DETOUR_GRACE_MS);
+            if (DetourCall::InFlight() == 0) {
+                return true;
+            }
+        }
+        if (MillisecondsSince(start) >= timeoutMs) {
+            return false;
+        }
+        Sleep(1);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include "MinHook.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <windows.h>
+
+// Installs a set of MinHook hooks as one transaction.
+// Every hook is created first; enabling and disabling are queued and applied with a single
+// MH_ApplyQueued, so game threads are frozen once per transaction instead of once per hook.
+// A failed transaction is rolled back so no hook is left half-installed. Detours count the calls
+// in flight so unloading can wait until no thread still runs (or will return into) this DLL's code.
+namespace hooks {
+    /**
+     * @brief One registered hook
+     */
+    struct HookEntry {
+        const char* name;
+        void* target;
+        void* detour;
+        void** original;
+        bool enabled;
+        double createMs;    // Time spent in MH_CreateHook
+    };
+
+    /**
+     * @brief Timings of the last transaction (milliseconds)
+     */
+    struct TransactionTimings {
+        double queueMs = 0.0;       // MH_QueueEnableHook/MH_QueueDisableHook for every hook
+        double applyMs = 0.0;       // MH_ApplyQueued: the only thread freeze
+        double rollbackMs = 0.0;    // Undoing a failed transaction (0 if it succeeded)
+    };
+
+    class HookRegistry {
+    public:
+        /**
+         * @brief Validate a target and create (but do not enable) its hook
+         * @param name Name for logging (must outlive the registry)
+         * @param target Function to hook; must be in executable memory
+         * @param detour Replacement function
+         * @param original Receives the trampoline to call the original function
+         * @return false if the target is invalid or MH_CreateHook failed
+         */
+        bool Add(const char* name, void* target, void* detour, void** original);
+
+        template<typename T>
+        bool Add(const char* name, void* target, void* detour, T** original) {
+            return Add(name, target, detour, reinterpret_cast<void**>(original));
+        }
+
+        /**
+         * @brief Enable every created hook in one MH_ApplyQueued; rolls back on failure
+         * @return true if all hooks are enabled
+         */
+        bool EnableAll();
+
+        /**
+         * @brief Disable every enabled hook in one MH_ApplyQueued
+         * @return true if all hooks are disabled
+         */
+        bool DisableAll();
+
+        /**
+         * @brief Remove every hook (disable first; MH_RemoveHook on an enabled hook freezes threads)
+         */
+        void RemoveAll();
+
+        size_t Size() const { return entries.size(); }
+        const std::vector<HookEntry>& Entries() const { return entries; }
+        const TransactionTimings& LastTimings() const { return lastTimings; }
+
+    private:
+        bool Apply(bool enable);
+
+        std::vector<HookEntry> entries;
+        TransactionTimings lastTimings;
+    };
+
+    /**
+     * @brief Counts the calling thread as inside a detour for the lifetime of the object
+     * Declare first thing in every detour; one atomic add on entry and one on exit.
+     */
+    class DetourCall {
+    public:
+        DetourCall() { inFlight.fetch_add(1, std::memory_order_acquire); }
+        ~DetourCall() { inFlight.fetch_sub(1, std::memory_order_release); }
+
+        DetourCall(const DetourCall&) = delete;
+        DetourCall& operator=(const DetourCall&) = delete;
+
+        static uint32_t InFlight() { return inFlight.load(std::memory_order_acquire); }
+
+    private:
+        static std::atomic<uint32_t> inFlight;
+    };
+
+    /**
+     * @brief Wait until no thread is inside a detour (after the hooks are disabled)
+     * @param timeoutMs Upper bound; a window procedure can sit in a modal loop for a long time
+     * @return false on timeout
+     */
+    bool WaitForDetours(DWORD timeoutMs);
+}
\ No newline at end of file
@@ -1,9 +1,26 @@
 #include "imguiHook.h"
+#include <atomic>
+#include "../Core/inputEvents.h"
+#include "../Core/traceRecorder.h"
+#include "../debugMessage.h"
+#include "fontAtlasCache.h"
+#include "hookRegistry.h"
+#include "uiThread.h"
 
 WNDPROC oWndProc;
+// Set while hkWndProc is the window procedure; until then fMain polls the exit key itself
+static std::atomic<bool> g_wndProcInstalled{ false };
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 LRESULT STDMETHODCALLTYPE hkWndProc(const HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
+    const hooks::DetourCall call;
+
+    // Overlay and exit keys; recorded even when ImGui consumes the message
+    core::GetInputEvents().OnWindowMessage(uMsg, wParam, lParam);
+
+    // While the UI thread builds the overlay, only it may feed ImGui
+    if (hud::GetUiThread().ForwardMessage(hWnd, uMsg, wParam, lParam))
+        return CallWindowProc(oWndProc, hWnd, uMsg, wParam, lParam);
 
     if (ImGui_ImplWin32_WndProcHandler(hWnd, uMsg, wParam, lParam))
         return true;
@@ -28,7 +45,11 @@ BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM gamePid) {
 }
 
 void imguiHook::InitializeImgui(IDirect3DDevice9* pDevice) {
-    EnumWindows(EnumWindowsProc, GetCurrentProcessId());
+    core::TraceScope trace("InitializeImgui");
+    {
+        core::TraceScope enumTrace("EnumWindows");
+        EnumWindows(EnumWindowsProc, GetCurrentProcessId());
+    }
 
     // Alternative way to get handle of window. This is much easier but I just go with the former.
     //D3DDEVICE_CREATION_PARAMETERS parameters;
@@ -37,8 +58,14 @@ void imguiHook::InitializeImgui(IDirect3DDevice9* pDevice) {
 
     if (window != NULL) {
         oWndProc = reinterpret_cast<WNDPROC>(SetWindowLongPtr(window, GWLP_WNDPROC, LONG_PTR(hkWndProc)));
+        g_wndProcInstalled.store(oWndProc != nullptr, std::memory_order_release);
         IMGUI_CHECKVERSION();
-        ImGui::CreateContext();
+        // Atlas baked on a worker while the hooks were installed (see fontAtlasCache.h)
+        render::FontAtlasCache& fontCache = render::GetFontAtlasCache();
+        {
+            core::TraceScope waitTrace("Wait for font atlas");
+            ImGui::CreateContext(fontCache.WaitForAtlas());
+        }
         // Remove duplicate CreateContext call
         ImGuiIO& io = ImGui::GetIO();
         io.ConfigFlags |= ImGuiConfigFlags_NoMouseCursorChange;
@@ -47,5 +74,27 @@ void imguiHook::InitializeImgui(IDirect3DDevice9* pDevice) {
         // Perform final ImGui setup.
         ImGui_ImplWin32_Init(window);
         ImGui_ImplDX9_Init(pDevice);
+
+        // Managed font texture: the backend's default-pool copy is never created
+        const int64_t textureStart = core::FrameProfiler::Now();
+        const bool managedTexture = fontCache.CreateTexture(pDevice);
+        core::GetTraceRecorder().Complete("Font texture upload", textureStart, core::FrameProfiler::Now());
+        if (managedTexture) {
+            const render::FontWarmUp& warmUp = fontCache.WarmUp();
+            LOGHEX("Font atlas bake (us)", static_cast<uint64_t>(warmUp.atlasMs * 1000.0));
+            LOGHEX("Font atlas wait on first frame (us)", static_cast<uint64_t>(warmUp.waitMs * 1000.0));
+            LOGHEX("Font texture upload (us)", static_cast<uint64_t>(warmUp.textureMs * 1000.0));
+        }
     }
+}
+
+void imguiHook::RestoreWndProc() {
+    // oWndProc stays set: a message already inside hkWndProc still forwards to it
+    if (window != NULL && g_wndProcInstalled.exchange(false, std::memory_order_acq_rel)) {
+        SetWindowLongPtr(window, GWLP_WNDPROC, reinterpret_cast<LONG_PTR>(oWndProc));
+    }
+}
+
+bool imguiHook::WndProcInstalled() {
+    return g_wndProcInstalled.load(std::memory_order_acquire);
 }
\ No newline at end of file
@@ -7,4 +7,15 @@
 
 namespace imguiHook {
     void InitializeImgui(IDirect3DDevice9* pDevice);
+
+    /**
+     * @brief Whether hkWndProc receives the game window's messages (any thread)
+     */
+    bool WndProcInstalled();
+
+    /**
+     * @brief Put the game's window procedure back (before unloading; hkWndProc lives in this DLL)
+     * Any thread; messages already inside hkWndProc finish normally (see hooks::WaitForDetours).
+     */
+    void RestoreWndProc();
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "overlayCallbacks.h"
+#include "retainedHud.h"
+#include "../Core/frameProfiler.h"
+#include "../Core/traceRecorder.h"
+#include "../debugMessage.h"
+#include "imgui_internal.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr float FIRST_WINDOW_X = 420.0f;        // Right of the debug window
+    constexpr float FIRST_WINDOW_Y = 50.0f;
+    constexpr float WINDOW_SPACING = 60.0f;
+
+    /**
+     * @brief ImGui stacks as they were when a callback was called
+     */
+    struct StackState {
+#if IMGUI_VERSION_NUM >= 19150
+        ImGuiErrorRecoveryState recovery;
+#endif
+        ImGuiWindow* window;    // The callback's own window
+    };
+
+    StackState StoreStackState() {
+        StackState state;
+#if IMGUI_VERSION_NUM >= 19150
+        ImGui::ErrorRecoveryStoreState(&state.recovery);
+#endif
+        state.window = ImGui::GetCurrentWindow();
+        return state;
+    }
+
+    /**
+     * @brief Close whatever a throwing callback left open, back to the state stored before it ran
+     */
+    void RecoverStackState(const StackState& state) {
+#if IMGUI_VERSION_NUM >= 19150
+        // Every recovered push is reported as a user error; asserting on them would defeat the catch
+        ImGuiIO& io = ImGui::GetIO();
+        const bool enableAssert = io.ConfigErrorRecoveryEnableAssert;
+        io.ConfigErrorRecoveryEnableAssert = false;
+        ImGui::ErrorRecoveryTryToRecoverState(&state.recovery);
+        io.ConfigErrorRecoveryEnableAssert = enableAssert;
+#else
+        // Same unwinding as ImGui::ErrorCheckEndFrameRecover, stopping at the callback's window
+        ImGuiContext& context = *ImGui::GetCurrentContext();
+        while (context.CurrentWindowStack.Size > 0 && context.CurrentWindow != state.window) {
+            ImGui::ErrorCheckEndWindowRecover(nullptr, nullptr);
+            if (context.CurrentWindow->Flags & ImGuiWindowFlags_ChildWindow) {
+                ImGui::EndChild();
+            } else {
+                ImGui::End();
+            }
+        }
+        ImGui::ErrorCheckEndWindowRecover(nullptr, nullptr);
+#endif
+    }
+
+    bool SameVec(const ImVec2& a, const ImVec2& b) {
+        return a.x == b.x && a.y == b.y;
+    }
+
+    /**
+     * @brief Whether ImGui routes input to the window this frame (hovered, or holding the active item)
+     */
+    bool TakesInput(const ImGuiWindow* window) {
+        const ImGuiContext& context = *ImGui::GetCurrentContext();
+        return (context.HoveredWindow && context.HoveredWindow->RootWindow == window) ||
+            (context.ActiveIdWindow && context.ActiveIdWindow->RootWindow == window);
+    }
+}
+
+const char* hud::CallbackStateName(CallbackState state) {
+    switch (state) {
+    case CallbackState::Active:
+        return "active";
+    case CallbackState::Throttled:
+        return "throttled";
+    case CallbackState::Disabled:
+        return "disabled";
+    }
+    return "unknown";
+}
+
+void hud::CallbackRegistry::Register(const char* name, int priority, double budgetUs, DrawCallback draw, ImGuiWindowFlags windowFlags) {
+    auto callback = std::make_unique<Callback>();
+    callback->name = name;
+    callback->priority = priority;
+    callback->throttle = core::CallbackThrottle(budgetUs);
+    callback->draw = std::move(draw);
+    callback->windowFlags = windowFlags;
+
+    // Stable: equal priorities keep registration order
+    auto position = std::upper_bound(callbacks.begin(), callbacks.end(), priority,
+        [](int value, const std::unique_ptr<Callback>& other) { return value > other->priority; });
+    callbacks.insert(position, std::move(callback));
+    LOGHEX("Overlay callback registered", name);
+}
+
+void hud::CallbackRegistry::Dispatch(bool essentialOnly) {
+    const core::FrameProfiler& clock = core::GetFrameProfiler();
+    core::TraceRecorder& tracer = core::GetTraceRecorder();
+    const int64_t dispatchStart = core::FrameProfiler::Now();
+
+    for (size_t i = 0; i < callbacks.size(); i++) {
+        Callback& callback = *callbacks[i];
+        if (callback.throttle.Disabled()) {
+            continue;
+        }
+        if (essentialOnly && callback.priority < CALLBACK_ESSENTIAL_PRIORITY) {
+            // The window disappears; its next call starts from a fresh replay
+            callback.replayValid = false;
+            continue;
+        }
+
+        const bool due = !callback.replayValid || ++callback.sinceRun >= callback.throttle.Interval();
+        ImGuiWindowFlags flags = callback.windowFlags;
+        ImGui::SetNextWindowPos(ImVec2(FIRST_WINDOW_X, FIRST_WINDOW_Y + WINDOW_SPACING * i), ImGuiCond_FirstUseEver);
+        if (!due) {
+            // Same window as at the last call; its content comes from the replay below
+            ImGui::SetNextWindowSize(callback.size);
+            flags &= ~ImGuiWindowFlags_AlwaysAutoResize;
+        }
+
+        const bool open = ImGui::Begin(callback.name, nullptr, flags);
+        ImGuiWindow* window = ImGui::GetCurrentWindow();
+        if (!open) {
+            // Collapsed: nothing to call, and the replay no longer matches the window
+            ImGui::End();
+            callback.replayValid = false;
+            continue;
+        }
+
+        // A skipped call would drop the window's input, and its replay is only valid where it was drawn
+        const bool run = due || TakesInput(window) || !SameVec(window->Pos, callback.position) ||
+            !SameVec(window->Size, callback.size);
+        if (run) {
+            const StackState stacks = StoreStackState();
+            const int64_t start = core::FrameProfiler::Now();
+            try {
+                callback.draw();
+            }
+            catch (...) {
+                // Pushes, trees, groups and child windows it left open would otherwise leak into every later window
+                RecoverStackState(stacks);
+                callback.throttle.Disable();
+                LOGERROR("Exception in overlay callback, disabled", callback.name);
+            }
+            const int64_t end = core::FrameProfiler::Now();
+            tracer.Complete(callback.name, start, end);
+            switch (callback.throttle.Account(clock.TicksToNanoseconds(end - start) / 1000.0)) {
+            case core::ThrottleChange::Lowered:
+                LOGWARN("Overlay callback over budget, rate lowered", callback.name);
+                break;
+            case core::ThrottleChange::Disabled:
+                LOGWARN("Overlay callback over budget at the lowest rate, disabled", callback.name);
+                break;
+            default:
+                break;
+            }
+        }
+        ImGui::End();
+
+        if (run) {
+            if (!callback.replay) {
+                callback.replay = std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData());
+            }
+            CopyDrawList(*callback.replay, *window->DrawList);
+            callback.replayValid = true;
+            callback.position = window->Pos;
+            callback.size = window->Size;
+            callback.sinceRun = 0;
+        } else {
+            // ImGui::Render collects window draw lists later, so the replay replaces the empty window
+            CopyDrawList(*window->DrawList, *callback.replay);
+        }
+    }
+
+    lastDispatchUs = clock.TicksToNanoseconds(core::FrameProfiler::Now() - dispatchStart) / 1000.0;
+}
+
+void hud::CallbackRegistry::Enable(size_t index) {
+    if (index >= callbacks.size()) {
+        return;
+    }
+    Callback& callback = *callbacks[index];
+    callback.throttle.Reset();
+    callback.sinceRun = 0;
+    callback.replayValid = false;
+}
+
+hud::CallbackStats hud::CallbackRegistry::Stats(size_t index) const {
+    const Callback& callback = *callbacks[index];
+    CallbackStats stats;
+    stats.name = callback.name;
+    stats.priority = callback.priority;
+    stats.budgetUs = callback.throttle.BudgetUs();
+    stats.lastUs = callback.throttle.LastUs();
+    stats.averageUs = callback.throttle.AverageUs();
+    stats.maxUs = callback.throttle.MaxUs();
+    stats.interval = callback.throttle.Interval();
+    stats.runs = callback.throttle.Runs();
+    stats.overruns = callback.throttle.Overruns();
+    stats.state = callback.throttle.Disabled() ? CallbackState::Disabled :
+        callback.throttle.Interval() > 1 ? CallbackState::Throttled : CallbackState::Active;
+    return stats;
+}
+
+void hud::CallbackRegistry::Release() {
+    for (const std::unique_ptr<Callback>& callback : callbacks) {
+        callback->replay.reset();
+        callback->replayValid = false;
+    }
+}
+
+hud::CallbackRegistry& hud::GetCallbackRegistry() {
+    static CallbackRegistry registry;
+    return registry;
+}
\ No newline at end of file
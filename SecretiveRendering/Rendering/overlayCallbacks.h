@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "imgui.h"
+#include "../Core/callbackThrottle.h"
+
+// Overlay content contributed by independent modules.
+// A module registers a draw callback with a priority and a per-call budget in microseconds; each
+// callback gets its own ImGui window in the debug window's layer and is called while that layer is
+// rebuilt, highest priority first. Every call is timed (and traced). A callback that keeps
+// overrunning its budget is called at a lower rate (see Core/callbackThrottle.h); on the builds it
+// skips, its window replays the geometry of its last call. It is still called on every build while
+// its window is hovered, holds the active item, or was moved or resized, so no input is lost and
+// the replay is never drawn where the window was. A callback still over budget at the lowest rate,
+// or one that throws, is disabled until re-enabled from the debug window; whatever a throwing
+// callback left pushed or open in ImGui is unwound back to its own window.
+// Register before the hooks are enabled; everything else runs on the thread that builds the UI.
+namespace hud {
+    constexpr int CALLBACK_ESSENTIAL_PRIORITY = 0;          // Lower priorities are dropped while the overlay is under load
+
+    enum class CallbackState : uint8_t {
+        Active,     // Called on every build
+        Throttled,  // Called every interval builds
+        Disabled
+    };
+
+    /**
+     * @brief Cost and throttling of one callback
+     */
+    struct CallbackStats {
+        const char* name;
+        int priority;
+        double budgetUs;
+        double lastUs;
+        double averageUs;       // Exponential moving average over calls
+        double maxUs;
+        uint32_t interval;      // Builds per call
+        uint64_t runs;
+        uint64_t overruns;
+        CallbackState state;
+    };
+
+    const char* CallbackStateName(CallbackState state);
+
+    class CallbackRegistry {
+    public:
+        /**
+         * @brief Draws the content of the callback's window (ImGui::Begin/End are done by the registry)
+         * Call hud::GetRetainedHud().MarkLive(hud::Layer::Window) from it for content that moves every frame.
+         */
+        using DrawCallback = std::function<void()>;
+
+        CallbackRegistry() = default;
+
+        CallbackRegistry(const CallbackRegistry&) = delete;
+        CallbackRegistry& operator=(const CallbackRegistry&) = delete;
+
+        /**
+         * @brief Add a callback (before the hooks are enabled)
+         * @param name Window title and name in statistics (string literal, unique)
+         * @param priority Higher priorities are called first
+         * @param budgetUs Cost allowed per call
+         * @param draw The callback
+         * @param windowFlags Flags of the callback's window
+         */
+        void Register(const char* name, int priority, double budgetUs, DrawCallback draw,
+            ImGuiWindowFlags windowFlags = ImGuiWindowFlags_AlwaysAutoResize);
+
+        /**
+         * @brief Submit every enabled callback's window (inside an ImGui frame, build thread)
+         * @param essentialOnly Skip callbacks below CALLBACK_ESSENTIAL_PRIORITY
+         */
+        void Dispatch(bool essentialOnly = false);
+
+        /**
+         * @brief Give a disabled callback a fresh start at the full rate
+         * @param index Position in priority order, as in Stats()
+         */
+        void Enable(size_t index);
+
+        size_t Count() const { return callbacks.size(); }
+
+        /**
+         * @param index Position in priority order
+         */
+        CallbackStats Stats(size_t index) const;
+
+        /**
+         * @brief Time of the last Dispatch, callbacks and windows included
+         */
+        double LastDispatchUs() const { return lastDispatchUs; }
+
+        /**
+         * @brief Free the replay geometry (before ImGui::DestroyContext)
+         */
+        void Release();
+
+    private:
+        struct Callback {
+            const char* name;
+            int priority;
+            DrawCallback draw;
+            ImGuiWindowFlags windowFlags;
+            core::CallbackThrottle throttle{ 0.0 };
+
+            std::unique_ptr<ImDrawList> replay;     // Window geometry of the last call
+            bool replayValid = false;
+            ImVec2 position;                        // Window position at the last call
+            ImVec2 size;                            // Window size at the last call
+            uint32_t sinceRun = 0;
+        };
+
+        std::vector<std::unique_ptr<Callback>> callbacks;  // Priority order
+        double lastDispatchUs = 0.0;
+    };
+
+    /**
+     * @brief Callbacks of the overlay
+     */
+    CallbackRegistry& GetCallbackRegistry();
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "overlayRenderer.h"
+
+namespace {
+    // ImGui packs colors as ABGR; the fixed-function pipeline wants D3DCOLOR (ARGB)
+    uint32_t ToArgb(uint32_t abgr) {
+        return (abgr & 0xFF00FF00) | ((abgr & 0x00FF0000) >> 16) | ((abgr & 0x000000FF) << 16);
+    }
+
+    uint32_t NextCapacity(uint32_t capacity, uint32_t needed) {
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+}
+
+render::OverlayRenderer::OverlayRenderer(IRenderDevice& device, uint32_t vertexCapacity, uint32_t indexCapacity)
+    : device(device), vertexCapacity(vertexCapacity ? vertexCapacity : 1), indexCapacity(indexCapacity ? indexCapacity : 1) {
+}
+
+bool render::OverlayRenderer::CreateDeviceObjects() {
+    if (created) {
+        return true;
+    }
+    if (!device.CreateBuffers(vertexCapacity, indexCapacity)) {
+        return false;
+    }
+    if (!device.CreateStateBlocks()) {
+        device.ReleaseBuffers();
+        return false;
+    }
+
+    created = true;
+    vertexCursor = 0;
+    indexCursor = 0;
+    uploadedGeneration = 0;
+    return true;
+}
+
+void render::OverlayRenderer::InvalidateDeviceObjects() {
+    if (!created) {
+        return;
+    }
+    device.ReleaseStateBlocks();
+    device.ReleaseBuffers();
+    created = false;
+    uploadedGeneration = 0;
+    batches.clear();
+}
+
+bool render::OverlayRenderer::Reserve(uint32_t vertexCount, uint32_t indexCount) {
+    if (vertexCount <= vertexCapacity && indexCount <= indexCapacity) {
+        return true;
+    }
+
+    // Past our peak: grow once to the next power of two and keep the new size from then on
+    vertexCapacity = NextCapacity(vertexCapacity, vertexCount);
+    indexCapacity = NextCapacity(indexCapacity, indexCount);
+    vertexCursor = 0;
+    indexCursor = 0;
+    uploadedGeneration = 0;
+    stats.bufferGrowths++;
+    return device.CreateBuffers(vertexCapacity, indexCapacity);
+}
+
+bool render::OverlayRenderer::Upload(const FrameView& frame) {
+    if (!Reserve(frame.totalVertices, frame.totalIndices)) {
+        return false;
+    }
+
+    // Append after the previous frame; wrap (and orphan the buffer) only when it does not fit
+    const bool discardVertices = vertexCursor + frame.totalVertices > vertexCapacity;
+    const bool discardIndices = indexCursor + frame.totalIndices > indexCapacity;
+    if (discardVertices) {
+        vertexCursor = 0;
+        stats.ringWraps++;
+    }
+    if (discardIndices) {
+        indexCursor = 0;
+        stats.ringWraps++;
+    }
+
+    Vertex* vertexOut = device.LockVertices(vertexCursor, frame.totalVertices, discardVertices);
+    if (!vertexOut) {
+        return false;
+    }
+    for (size_t list = 0; list < frame.listCount; list++) {
+        const DrawListView& view = frame.lists[list];
+        for (uint32_t i = 0; i < view.vertexCount; i++) {
+            const SourceVertex& source = view.vertices[i];
+            *vertexOut++ = { source.x, source.y, 0.0f, ToArgb(source.color), source.u, source.v };
+        }
+    }
+    device.UnlockVertices();
+
+    uint16_t* indexOut = device.LockIndices(indexCursor, frame.totalIndices, discardIndices);
+    if (!indexOut) {
+        return false;
+    }
+
+    // When the whole frame is addressable with 16-bit indices, every draw shares one base vertex
+    // and commands can merge across draw lists
+    const bool rebase = frame.totalVertices <= MAX_REBASED_VERTICES;
+    uint32_t listBase = 0;
+    uint32_t written = 0;
+    batches.clear();
+    stats.commands = 0;
+
+    for (size_t list = 0; list < frame.listCount; list++) {
+        const DrawListView& view = frame.lists[list];
+        for (uint32_t c = 0; c < view.commandCount; c++) {
+            const DrawCommand& command = view.commands[c];
+            stats.commands++;
+
+            const ScissorRect scissor = {
+                static_cast<int32_t>(command.clip.left - frame.displayX),
+                static_cast<int32_t>(command.clip.top - frame.displayY),
+                static_cast<int32_t>(command.clip.right - frame.displayX),
+                static_cast<int32_t>(command.clip.bottom - frame.displayY)
+            };
+            if (scissor.right <= scissor.left || scissor.bottom <= scissor.top || command.elementCount == 0) {
+                continue;
+            }
+
+            const uint16_t* source = view.indices + command.indexOffset;
+            uint32_t baseVertex = vertexCursor;
+            uint32_t vertexCount = frame.totalVertices;
+            if (rebase) {
+                const uint32_t offset = listBase + command.vertexOffset;
+                for (uint32_t i = 0; i < command.elementCount; i++) {
+                    indexOut[written + i] = static_cast<uint16_t>(source[i] + offset);
+                }
+            } else {
+                baseVertex = vertexCursor + listBase + command.vertexOffset;
+                vertexCount = view.vertexCount - command.vertexOffset;
+                for (uint32_t i = 0; i < command.elementCount; i++) {
+                    indexOut[written + i] = source[i];
+                }
+            }
+
+            const uint32_t startIndex = indexCursor + written;
+            const uint32_t primitiveCount = command.elementCount / 3;
+            written += command.elementCount;
+
+            // Only neighbours merge: reordering overlapping geometry would change blending
+            if (!batches.empty()) {
+                Batch& last = batches.back();
+                if (last.texture == command.texture && last.scissor == scissor && last.baseVertex == baseVertex &&
+                    last.startIndex + last.primitiveCount * 3 == startIndex) {
+                    last.primitiveCount += primitiveCount;
+                    continue;
+                }
+            }
+            batches.push_back({ command.texture, scissor, baseVertex, vertexCount, startIndex, primitiveCount });
+        }
+        listBase += view.vertexCount;
+    }
+    device.UnlockIndices();
+
+    vertexCursor += frame.totalVertices;
+    indexCursor += written;
+    stats.vertices = frame.totalVertices;
+    stats.indices = written;
+    return true;
+}
+
+void render::OverlayRenderer::Draw() {
+    stats.batches = 0;
+    stats.textureChanges = 0;
+    stats.scissorChanges = 0;
+
+    bool first = true;
+    uint64_t texture = 0;
+    ScissorRect scissor = {};
+    for (const Batch& batch : batches) {
+        if (first || batch.texture != texture) {
+            device.SetTexture(batch.texture);
+            texture = batch.texture;
+            stats.textureChanges++;
+        }
+        if (first || batch.scissor != scissor) {
+            device.SetScissor(batch.scissor);
+            scissor = batch.scissor;
+            stats.scissorChanges++;
+        }
+        first = false;
+
+        device.DrawIndexed(batch.baseVertex, batch.vertexCount, batch.startIndex, batch.primitiveCount);
+        stats.batches++;
+    }
+}
+
+bool render::OverlayRenderer::Render(const FrameView& frame) {
+    if (!created || frame.displayWidth <= 0.0f || frame.displayHeight <= 0.0f) {
+        return false;
+    }
+    if (!frame.listCount || !frame.totalVertices || !frame.totalIndices) {
+        batches.clear();
+        return true;
+    }
+
+    const float display[4] = { frame.displayX, frame.displayY, frame.displayWidth, frame.displayHeight };
+    const bool unchanged = frame.generation != 0 && frame.generation == uploadedGeneration &&
+        display[0] == uploadedDisplay[0] && display[1] == uploadedDisplay[1] &&
+        display[2] == uploadedDisplay[2] && display[3] == uploadedDisplay[3];
+
+    stats.uploaded = !unchanged;
+    if (!unchanged) {
+        if (!Upload(frame)) {
+            uploadedGeneration = 0;
+            batches.clear();
+            return false;
+        }
+        uploadedGeneration = frame.generation;
+        for (size_t i = 0; i < 4; i++) {
+            uploadedDisplay[i] = display[i];
+        }
+    }
+
+    device.BeginOverlay(frame);
+    Draw();
+    device.EndOverlay();
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Renderer for the overlay's draw lists, independent of the graphics API.
+// Geometry is streamed into vertex/index rings that live as long as the device: each frame is
+// appended after the previous one (no-overwrite locks) and the rings only wrap (discard) when
+// full. Consecutive commands with the same texture and clip rectangle are merged into one draw,
+// redundant texture/scissor changes are skipped, and a frame whose content did not change is
+// drawn again from the data already on the GPU. The device behind IRenderDevice owns the API
+// objects (see dx9Renderer.h); a mock device can record the calls instead.
+namespace render {
+    constexpr uint32_t DEFAULT_VERTEX_CAPACITY = 1 << 15;  // Vertices in the ring (several frames of our overlay)
+    constexpr uint32_t DEFAULT_INDEX_CAPACITY = 1 << 16;
+    constexpr uint32_t MAX_REBASED_VERTICES = 1 << 16;     // 16-bit indices can address one frame this large
+
+    /**
+     * @brief Vertex as the device consumes it (D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1)
+     */
+    struct Vertex {
+        float x, y, z;
+        uint32_t color;     // ARGB
+        float u, v;
+    };
+
+    /**
+     * @brief Vertex as ImGui emits it (same layout as ImDrawVert)
+     */
+    struct SourceVertex {
+        float x, y;
+        float u, v;
+        uint32_t color;     // ABGR
+    };
+
+    struct ClipRect {
+        float left, top, right, bottom;
+    };
+
+    struct ScissorRect {
+        int32_t left, top, right, bottom;
+
+        bool operator==(const ScissorRect& other) const {
+            return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+        }
+        bool operator!=(const ScissorRect& other) const { return !(*this == other); }
+    };
+
+    struct DrawCommand {
+        ClipRect clip;
+        uint64_t texture;
+        uint32_t elementCount;
+        uint32_t indexOffset;
+        uint32_t vertexOffset;
+    };
+
+    struct DrawListView {
+        const SourceVertex* vertices;
+        uint32_t vertexCount;
+        const uint16_t* indices;
+        uint32_t indexCount;
+        const DrawCommand* commands;
+        uint32_t commandCount;
+    };
+
+    /**
+     * @brief One frame of draw lists
+     */
+    struct FrameView {
+        float displayX = 0.0f;
+        float displayY = 0.0f;
+        float displayWidth = 0.0f;
+        float displayHeight = 0.0f;
+        const DrawListView* lists = nullptr;
+        size_t listCount = 0;
+        uint32_t totalVertices = 0;
+        uint32_t totalIndices = 0;
+        uint64_t generation = 0;    // Non-zero and unchanged: same geometry as the previous frame
+    };
+
+    /**
+     * @brief One merged draw
+     */
+    struct Batch {
+        uint64_t texture;
+        ScissorRect scissor;
+        uint32_t baseVertex;
+        uint32_t vertexCount;
+        uint32_t startIndex;
+        uint32_t primitiveCount;
+    };
+
+    struct RenderStats {
+        uint32_t commands = 0;          // Draw commands submitted by ImGui
+        uint32_t batches = 0;           // Draws issued
+        uint32_t textureChanges = 0;
+        uint32_t scissorChanges = 0;
+        uint32_t vertices = 0;
+        uint32_t indices = 0;
+        bool uploaded = false;          // false: the previous frame's GPU data was reused
+        uint64_t ringWraps = 0;         // Discarding locks since the buffers were created
+        uint64_t bufferGrowths = 0;
+    };
+
+    /**
+     * @brief Graphics API operations used by the renderer
+     */
+    class IRenderDevice {
+    public:
+        virtual ~IRenderDevice() = default;
+
+        /**
+         * @brief Create the dynamic vertex and index buffers (replacing existing ones)
+         */
+        virtual bool CreateBuffers(uint32_t vertexCapacity, uint32_t indexCapacity) = 0;
+        virtual void ReleaseBuffers() = 0;
+
+        /**
+         * @brief Record the overlay's fixed render states once
+         */
+        virtual bool CreateStateBlocks() = 0;
+        virtual void ReleaseStateBlocks() = 0;
+
+        /**
+         * @brief Lock part of a ring
+         * @param discard true to orphan the whole buffer (ring wrap), false for a no-overwrite lock
+         * @return Write pointer, or nullptr on failure
+         */
+        virtual Vertex* LockVertices(uint32_t first, uint32_t count, bool discard) = 0;
+        virtual void UnlockVertices() = 0;
+        virtual uint16_t* LockIndices(uint32_t first, uint32_t count, bool discard) = 0;
+        virtual void UnlockIndices() = 0;
+
+        /**
+         * @brief Save the game's state and apply the overlay's
+         */
+        virtual void BeginOverlay(const FrameView& frame) = 0;
+
+        /**
+         * @brief Restore the game's state
+         */
+        virtual void EndOverlay() = 0;
+
+        virtual void SetTexture(uint64_t texture) = 0;
+        virtual void SetScissor(const ScissorRect& scissor) = 0;
+        virtual void DrawIndexed(uint32_t baseVertex, uint32_t vertexCount, uint32_t startIndex, uint32_t primitiveCount) = 0;
+    };
+
+    class OverlayRenderer {
+    public:
+        explicit OverlayRenderer(IRenderDevice& device,
+            uint32_t vertexCapacity = DEFAULT_VERTEX_CAPACITY, uint32_t indexCapacity = DEFAULT_INDEX_CAPACITY);
+
+        /**
+         * @brief Create buffers and state blocks (initialization and after a device reset)
+         */
+        bool CreateDeviceObjects();
+
+        /**
+         * @brief Release everything the device owns (before a device reset or shutdown)
+         */
+        void InvalidateDeviceObjects();
+
+        /**
+         * @brief Upload (unless unchanged) and draw one frame
+         * @return false if the frame could not be drawn
+         */
+        bool Render(const FrameView& frame);
+
+        const RenderStats& LastStats() const { return stats; }
+        const std::vector<Batch>& Batches() const { return batches; }
+        uint32_t VertexCapacity() const { return vertexCapacity; }
+        uint32_t IndexCapacity() const { return indexCapacity; }
+
+    private:
+        bool Reserve(uint32_t vertexCount, uint32_t indexCount);
+        bool Upload(const FrameView& frame);
+        void Draw();
+
+        IRenderDevice& device;
+        uint32_t vertexCapacity;
+        uint32_t indexCapacity;
+        bool created = false;
+
+        uint32_t vertexCursor = 0;
+        uint32_t indexCursor = 0;
+
+        std::vector<Batch> batches;
+        uint64_t uploadedGeneration = 0;    // 0: nothing reusable on the GPU
+        float uploadedDisplay[4] = {};
+        RenderStats stats;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "retainedHud.h"
+#include <cstring>
+#include "../Core/inputEvents.h"
+
+namespace {
+    template<typename T>
+    void CopyVector(ImVector<T>& destination, const ImVector<T>& source) {
+        // resize() keeps the capacity, so steady-state copies never allocate (operator= frees first)
+        destination.resize(source.Size);
+        if (source.Size) {
+            memcpy(destination.Data, source.Data, static_cast<size_t>(source.Size) * sizeof(T));
+        }
+    }
+
+    bool Contains(const ImRect& rect, int x, int y) {
+        return rect.Contains(ImVec2(static_cast<float>(x), static_cast<float>(y)));
+    }
+}
+
+void hud::FrameRateMeter::Tick(double intervalMs) {
+    if (intervalMs <= 0.0) {
+        return;
+    }
+
+    intervalSum += intervalMs - intervals[next];
+    intervals[next] = intervalMs;
+    next = (next + 1) % FRAME_RATE_WINDOW;
+    if (filled < FRAME_RATE_WINDOW) {
+        filled++;
+    }
+}
+
+uint64_t hud::HashText(const char* text, uint64_t seed) {
+    uint64_t hash = seed;
+    for (; *text; text++) {
+        hash ^= static_cast<uint8_t>(*text);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void hud::CopyDrawList(ImDrawList& destination, const ImDrawList& source) {
+    CopyVector(destination.CmdBuffer, source.CmdBuffer);
+    CopyVector(destination.IdxBuffer, source.IdxBuffer);
+    CopyVector(destination.VtxBuffer, source.VtxBuffer);
+    destination.Flags = source.Flags;
+
+    // ImDrawData::AddDrawList checks these against the buffers
+    destination._VtxCurrentIdx = source._VtxCurrentIdx;
+    destination._VtxWritePtr = destination.VtxBuffer.Data + destination.VtxBuffer.Size;
+    destination._IdxWritePtr = destination.IdxBuffer.Data + destination.IdxBuffer.Size;
+}
+
+bool hud::RetainedHud::InputAffects(const CachedLayer& layer, int cursorX, int cursorY, bool cursorKnown) const {
+    if (!cursorKnown || (cursorX == lastCursorX && cursorY == lastCursorY)) {
+        return false;
+    }
+    // Entering, moving inside or leaving one of the layer's windows changes hover state
+    for (const ImRect& rect : layer.rects) {
+        if (Contains(rect, cursorX, cursorY) || Contains(rect, lastCursorX, lastCursorY)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hud::RetainedHud::Prepare(const uint64_t* keys, double elapsedMs) {
+    if (invalidateRequested.load(std::memory_order_relaxed) && invalidateRequested.exchange(false, std::memory_order_acquire)) {
+        Invalidate();
+    }
+
+    const core::InputEvents& input = core::GetInputEvents();
+    const uint32_t currentInput = input.InputGeneration();
+    int cursorX = 0;
+    int cursorY = 0;
+    const bool cursorKnown = input.CursorPosition(cursorX, cursorY);
+
+    bool rebuild = false;
+    for (size_t index = 0; index < LAYER_COUNT; index++) {
+        CachedLayer& layer = layers[index];
+        layer.ageMs += elapsedMs;
+        layer.pendingKey = keys[index];
+        layer.dirty = !layer.valid || layer.live || layer.key != keys[index] || layer.ageMs >= MAX_LAYER_AGE_MS;
+
+        // Only the debug window takes input; the HUD looks the same whatever the mouse does
+        if (!layer.dirty && static_cast<Layer>(index) == Layer::Window) {
+            layer.dirty = (currentInput != inputGeneration && wantedInput) || inputQueued || InputAffects(layer, cursorX, cursorY, cursorKnown);
+        }
+        if (layer.dirty) {
+            layer.liveBuilt = false;
+        }
+        rebuild |= layer.dirty;
+    }
+
+    inputGeneration = currentInput;
+    if (cursorKnown) {
+        lastCursorX = cursorX;
+        lastCursorY = cursorY;
+    }
+
+    if (rebuild) {
+        rebuiltFrames++;
+    } else {
+        replayedFrames++;
+    }
+    return rebuild;
+}
+
+void hud::RetainedHud::Store(CachedLayer& layer, const ImDrawList* source) {
+    if (layer.used == layer.lists.size()) {
+        layer.lists.push_back(std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+    }
+
+    CopyDrawList(*layer.lists[layer.used++], *source);
+}
+
+void hud::RetainedHud::Capture(ImDrawData* drawData, const char* hudWindow) {
+    if (!drawData || !drawData->Valid) {
+        return;
+    }
+
+    displayPos = drawData->DisplayPos;
+    displaySize = drawData->DisplaySize;
+    framebufferScale = drawData->FramebufferScale;
+#ifdef IMGUI_HAS_TEXTURES
+    pendingTextures = drawData->Textures;
+#endif
+
+    ImGuiWindow* hudWindowState = ImGui::FindWindowByName(hudWindow);
+    const ImDrawList* hudList = hudWindowState ? hudWindowState->DrawList : nullptr;
+
+    CachedLayer& window = layers[static_cast<size_t>(Layer::Window)];
+    CachedLayer& hud = layers[static_cast<size_t>(Layer::Hud)];
+    if (window.dirty) {
+        window.used = 0;
+    }
+    if (hud.dirty) {
+        hud.used = 0;
+    }
+
+    for (int i = 0; i < drawData->CmdListsCount; i++) {
+        const ImDrawList* list = drawData->CmdLists[i];
+        CachedLayer& layer = list == hudList ? hud : window;
+        if (layer.dirty) {
+            Store(layer, list);
+        }
+    }
+
+    if (window.dirty) {
+        // Hover tests for the next frames use the rectangles of everything but the HUD
+        ImGuiContext& context = *ImGui::GetCurrentContext();
+        window.rects.clear();
+        for (ImGuiWindow* candidate : context.Windows) {
+            if (candidate->Active && !candidate->Hidden && candidate != hudWindowState) {
+                window.rects.push_back(candidate->Rect());
+            }
+        }
+
+        const ImGuiIO& io = ImGui::GetIO();
+        wantedInput = io.WantCaptureMouse || io.WantCaptureKeyboard || io.WantTextInput ||
+            (context.NavWindow && context.NavWindow != hudWindowState);
+    }
+
+    // ImGui applies at most one button transition per NewFrame; the rest (the release of a click)
+    // waits in its queue with no new message to bump the input generation, so rebuild until drained
+    inputQueued = ImGui::GetCurrentContext()->InputEventsQueue.Size > 0;
+
+    generation++;
+    for (CachedLayer& layer : layers) {
+        if (layer.dirty) {
+            layer.key = layer.pendingKey;
+            layer.valid = true;
+            layer.live = layer.liveBuilt;
+            layer.ageMs = 0.0;
+            layer.dirty = false;
+        }
+    }
+}
+
+ImDrawData* hud::RetainedHud::Replay() {
+    replay.Clear();
+    replay.Valid = true;
+    replay.DisplayPos = displayPos;
+    replay.DisplaySize = displaySize;
+    replay.FramebufferScale = framebufferScale;
+#ifdef IMGUI_HAS_TEXTURES
+    // Texture creation/updates only come with a real ImGui frame; hand them over once
+    replay.Textures = pendingTextures;
+    pendingTextures = nullptr;
+#endif
+
+    // Same order ImGui submitted them in: debug window (and its popups) below the HUD
+    for (CachedLayer& layer : layers) {
+        if (!layer.valid) {
+            continue;
+        }
+        for (size_t i = 0; i < layer.used; i++) {
+            replay.AddDrawList(layer.lists[i].get());
+        }
+    }
+
+    return &replay;
+}
+
+void hud::RetainedHud::Invalidate() {
+    generation++;
+    for (CachedLayer& layer : layers) {
+        layer.valid = false;
+        layer.used = 0;
+    }
+#ifdef IMGUI_HAS_TEXTURES
+    pendingTextures = nullptr;
+#endif
+}
+
+void hud::RetainedHud::Release() {
+    Invalidate();
+    replay.Clear();
+    for (CachedLayer& layer : layers) {
+        layer.lists.clear();
+        layer.rects.clear();
+    }
+}
+
+hud::RetainedHud& hud::GetRetainedHud() {
+    static RetainedHud retainedHud;
+    return retainedHud;
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "../Core/overlayHeap.h"
+
+// Retained rendering of the overlay windows.
+// The overlay is split into layers (the interactive debug window with its popups, and the HUD).
+// Each layer's ImDrawList output is copied into persistent lists when it is built; a layer is
+// only rebuilt when its key (a hash of the text it displays, quantised to the displayed
+// precision) changes, when ImGui could have seen input for it or still has input queued, or when
+// it is marked live.
+// Frames where nothing changed skip ImGui entirely and replay the cached geometry. Frames that
+// run ImGui submit every window, so none loses its focus or hover state; Capture copies only the
+// dirty layers.
+namespace hud {
+    constexpr double MAX_LAYER_AGE_MS = 500.0;  // Rebuild at least this often (drains ImGui's input queue)
+    constexpr size_t FRAME_RATE_WINDOW = 60;    // Frames averaged, like ImGuiIO::Framerate
+
+    enum class Layer : uint8_t {
+        Window,     // "TF2 Secretive Rendering" and any popup/tooltip it opens
+        Hud,        // "TF2 HUD"
+        Count
+    };
+
+    constexpr size_t LAYER_COUNT = static_cast<size_t>(Layer::Count);
+
+    /**
+     * @brief Frame rate measured from Present calls
+     * ImGuiIO::Framerate only advances in ImGui::NewFrame, which replayed frames skip.
+     */
+    class FrameRateMeter {
+    public:
+        /**
+         * @brief Record one Present
+         * @param intervalMs Milliseconds since the previous Present
+         */
+        void Tick(double intervalMs);
+
+        /**
+         * @brief Latch the current average for display (called by a scheduled provider)
+         */
+        void Sample() {
+            if (intervalSum > 0.0) {
+                displayedFps = 1000.0 * filled / intervalSum;
+            }
+        }
+
+        /**
+         * @brief Frame rate for display; only changes when Sample is called
+         */
+        double DisplayedFps() const { return displayedFps; }
+
+    private:
+        double intervals[FRAME_RATE_WINDOW] = {};
+        double intervalSum = 0.0;
+        size_t next = 0;
+        size_t filled = 0;
+        double displayedFps = 0.0;
+    };
+
+    /**
+     * @brief FNV-1a of a string, used to build layer keys from the text a layer shows
+     */
+    uint64_t HashText(const char* text, uint64_t seed = 14695981039346656037ull);
+
+    /**
+     * @brief Copy a draw list's commands and geometry, reusing the destination's capacity
+     */
+    void CopyDrawList(ImDrawList& destination, const ImDrawList& source);
+
+    class RetainedHud {
+    public:
+        /**
+         * @brief Decide which layers must be rebuilt this frame
+         * @param keys Key of each layer, indexed by Layer
+         * @param elapsedMs Milliseconds since the previous call
+         * @return true if any layer must be rebuilt (run an ImGui frame)
+         */
+        bool Prepare(const uint64_t* keys, double elapsedMs);
+
+        /**
+         * @brief Whether Capture will replace a layer's cached geometry with this ImGui frame's
+         */
+        bool IsDirty(Layer layer) const { return layers[static_cast<size_t>(layer)].dirty; }
+
+        /**
+         * @brief The layer shows something that changes every frame (e.g. a live graph)
+         * Call while building; it is rebuilt every frame for as long as it keeps calling this.
+         */
+        void MarkLive(Layer layer) { layers[static_cast<size_t>(layer)].liveBuilt = true; }
+
+        /**
+         * @brief Copy the output of the ImGui frame that rebuilt the dirty layers
+         * @param drawData ImGui::GetDrawData() after ImGui::Render()
+         * @param hudWindow Name of the window that makes up the Hud layer
+         */
+        void Capture(ImDrawData* drawData, const char* hudWindow);
+
+        /**
+         * @brief Draw data of every layer from the cache
+         */
+        ImDrawData* Replay();
+
+        /**
+         * @brief Changes whenever the cached geometry does (lets the renderer skip the upload)
+         */
+        uint64_t Generation() const { return generation; }
+
+        /**
+         * @brief Drop cached geometry (device reset: texture ids change; overlay shown again)
+         */
+        void Invalidate();
+
+        /**
+         * @brief Invalidate at the next Prepare (from any thread; the HUD may be built on the UI thread)
+         */
+        void RequestInvalidate() { invalidateRequested.store(true, std::memory_order_release); }
+
+        /**
+         * @brief Release the cached draw lists (before ImGui::DestroyContext)
+         */
+        void Release();
+
+        uint64_t RebuiltFrames() const { return rebuiltFrames; }
+        uint64_t ReplayedFrames() const { return replayedFrames; }
+
+    private:
+        struct CachedLayer {
+            std::vector<std::unique_ptr<ImDrawList>> lists;
+            size_t used = 0;
+            core::HeapVector<ImRect> rects;      // Screen rectangles of the layer's windows (hover tests)
+            uint64_t key = 0;
+            uint64_t pendingKey = 0;        // Key of the build in progress
+            double ageMs = 0.0;
+            bool valid = false;
+            bool live = false;              // Rebuilt every frame
+            bool liveBuilt = false;         // MarkLive called during the current build
+            bool dirty = false;
+        };
+
+        void Store(CachedLayer& layer, const ImDrawList* source);
+        bool InputAffects(const CachedLayer& layer, int cursorX, int cursorY, bool cursorKnown) const;
+
+        CachedLayer layers[LAYER_COUNT];
+        ImDrawData replay;
+        ImVec2 displayPos = ImVec2(0, 0);
+        ImVec2 displaySize = ImVec2(0, 0);
+        ImVec2 framebufferScale = ImVec2(1, 1);
+#ifdef IMGUI_HAS_TEXTURES
+        ImVector<ImTextureData*>* pendingTextures = nullptr;   // Texture updates of the last ImGui frame
+#endif
+
+        uint32_t inputGeneration = 0;
+        bool wantedInput = false;           // ImGui wanted mouse/keyboard or had a focused window
+        bool inputQueued = false;           // Events ImGui trickled to a later frame (a click's release)
+        int lastCursorX = -1;
+        int lastCursorY = -1;
+
+        std::atomic<bool> invalidateRequested{ false };
+        uint64_t generation = 1;
+        uint64_t rebuiltFrames = 0;
+        uint64_t replayedFrames = 0;
+    };
+
+    /**
+     * @brief Retained layers of the overlay (only touched by the thread that builds the UI)
+     */
+    RetainedHud& GetRetainedHud();
+}
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "uiThread.h"
+#include "imgui_impl_win32.h"
+#include "retainedHud.h"
+#include "../Core/traceRecorder.h"
+#include "../debugMessage.h"
+#include "imgui_internal.h"
+
+#include <algorithm>
+#include <chrono>
+
+extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint8_t MODIFIER_CTRL = 1 << 0;
+    constexpr uint8_t MODIFIER_SHIFT = 1 << 1;
+    constexpr uint8_t MODIFIER_ALT = 1 << 2;
+    constexpr uint8_t MODIFIER_SUPER = 1 << 3;
+
+    /**
+     * @brief Messages the Win32 backend turns into ImGui input
+     */
+    bool IsImGuiMessage(UINT message) {
+        return (message >= WM_MOUSEFIRST && message <= WM_MOUSELAST) || (message >= WM_KEYFIRST && message <= WM_KEYLAST) ||
+            message == WM_MOUSELEAVE || message == WM_SETFOCUS || message == WM_KILLFOCUS ||
+            message == WM_INPUTLANGCHANGE || message == WM_DEVICECHANGE;
+    }
+
+    bool IsKeyMessage(UINT message) {
+        return message == WM_KEYDOWN || message == WM_KEYUP || message == WM_SYSKEYDOWN || message == WM_SYSKEYUP;
+    }
+
+    /**
+     * @brief Messages that end a press; dropping one leaves a key or button down in ImGui
+     */
+    bool IsReleaseMessage(UINT message) {
+        return message == WM_LBUTTONUP || message == WM_RBUTTONUP || message == WM_MBUTTONUP || message == WM_XBUTTONUP ||
+            message == WM_KEYUP || message == WM_SYSKEYUP || message == WM_KILLFOCUS;
+    }
+
+    bool IsVkDown(int key) {
+        return (GetKeyState(key) & 0x8000) != 0;
+    }
+
+    /**
+     * @brief Modifier keys down as seen by the calling thread (the window thread)
+     */
+    uint8_t CaptureModifiers() {
+        uint8_t modifiers = 0;
+        modifiers |= IsVkDown(VK_CONTROL) ? MODIFIER_CTRL : 0;
+        modifiers |= IsVkDown(VK_SHIFT) ? MODIFIER_SHIFT : 0;
+        modifiers |= IsVkDown(VK_MENU) ? MODIFIER_ALT : 0;
+        modifiers |= IsVkDown(VK_LWIN) || IsVkDown(VK_RWIN) ? MODIFIER_SUPER : 0;
+        return modifiers;
+    }
+
+    bool ModifierDown(uint8_t modifiers, ImGuiKey key) {
+        switch (key) {
+        case ImGuiMod_Ctrl:
+            return (modifiers & MODIFIER_CTRL) != 0;
+        case ImGuiMod_Shift:
+            return (modifiers & MODIFIER_SHIFT) != 0;
+        case ImGuiMod_Alt:
+            return (modifiers & MODIFIER_ALT) != 0;
+        default:
+            return (modifiers & MODIFIER_SUPER) != 0;
+        }
+    }
+
+    /**
+     * @brief Feed a key message to the backend with the modifiers captured on the window thread
+     * The backend adds modifier events from GetKeyState, which reads all up on this thread: the
+     * captured state goes in before the handler (in case the backend adds nothing) and overwrites
+     * whatever the handler added.
+     */
+    void ForwardKeyMessage(HWND window, UINT message, WPARAM wParam, LPARAM lParam, uint8_t modifiers) {
+        ImGuiIO& io = ImGui::GetIO();
+        const ImGuiKey keys[] = { ImGuiMod_Ctrl, ImGuiMod_Shift, ImGuiMod_Alt, ImGuiMod_Super };
+        for (ImGuiKey key : keys) {
+            io.AddKeyEvent(key, ModifierDown(modifiers, key));
+        }
+
+        ImVector<ImGuiInputEvent>& events = ImGui::GetCurrentContext()->InputEventsQueue;
+        const int first = events.Size;
+        ImGui_ImplWin32_WndProcHandler(window, message, wParam, lParam);
+        for (int i = first; i < events.Size; i++) {
+            ImGuiInputEvent& event = events[i];
+            if (event.Type == ImGuiInputEventType_Key && (event.Key.Key & ImGuiMod_Mask_)) {
+                event.Key.Down = ModifierDown(modifiers, event.Key.Key);
+            }
+        }
+    }
+}
+
+void hud::DrawSnapshot::CopyFrom(const ImDrawData& source, uint64_t sourceGeneration) {
+    drawData.Clear();
+    for (int i = 0; i < source.CmdListsCount; i++) {
+        if (lists.size() <= static_cast<size_t>(i)) {
+            lists.push_back(std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+        }
+        CopyDrawList(*lists[i], *source.CmdLists[i]);
+        drawData.AddDrawList(lists[i].get());
+    }
+    drawData.Valid = source.Valid;
+    drawData.DisplayPos = source.DisplayPos;
+    drawData.DisplaySize = source.DisplaySize;
+    drawData.FramebufferScale = source.FramebufferScale;
+    generation = sourceGeneration;
+}
+
+hud::UiThread::~UiThread() {
+    // Only reached at DLL unload; a thread still running there cannot be joined under the loader lock
+    if (thread.joinable()) {
+        thread.detach();
+    }
+}
+
+void hud::UiThread::Start(BuildFunction buildFunction) {
+    if (thread.joinable()) {
+        return;
+    }
+    build = std::move(buildFunction);
+    stopping = false;
+    pendingMessages.reserve(INPUT_QUEUE_CAPACITY);
+    drainingMessages.reserve(INPUT_QUEUE_CAPACITY);
+    // Set first: messages arriving from now on are queued rather than handed to ImGui directly
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&UiThread::Loop, this);
+    LOGHEX("Overlay UI thread started", 0);
+}
+
+void hud::UiThread::Stop() {
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    running.store(false, std::memory_order_release);
+}
+
+bool hud::UiThread::ForwardMessage(HWND window, UINT message, WPARAM wParam, LPARAM lParam) {
+    if (!Running()) {
+        return false;
+    }
+    if (!IsImGuiMessage(message)) {
+        return true;
+    }
+
+    const bool accept = acceptInput.load(std::memory_order_acquire);
+    const uint8_t modifiers = IsKeyMessage(message) ? CaptureModifiers() : 0;
+    std::lock_guard<std::mutex> guard(inputLock);
+    if (accept != accepting) {
+        accepting = accept;
+        // Hidden: ImGui loses focus, which releases whatever it holds down; shown: focus comes back if the window has it
+        if (!accept) {
+            Enqueue({ window, WM_KILLFOCUS, 0, 0, 0 });
+        } else if (GetFocus() == window) {
+            Enqueue({ window, WM_SETFOCUS, 0, 0, 0 });
+        }
+    }
+    if (accept) {
+        Enqueue({ window, message, wParam, lParam, modifiers });
+    }
+    return true;
+}
+
+void hud::UiThread::Enqueue(const WindowMessage& queued) {
+    // Only the newest position matters between two other messages
+    if (queued.message == WM_MOUSEMOVE && !pendingMessages.empty() && pendingMessages.back().message == WM_MOUSEMOVE) {
+        pendingMessages.back() = queued;
+        return;
+    }
+    if (pendingMessages.size() >= INPUT_QUEUE_CAPACITY) {
+        auto move = std::find_if(pendingMessages.begin(), pendingMessages.end(),
+            [](const WindowMessage& pending) { return pending.message == WM_MOUSEMOVE; });
+        if (move != pendingMessages.end()) {
+            pendingMessages.erase(move);
+            droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        } else if (!IsReleaseMessage(queued.message)) {
+            droppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    pendingMessages.push_back(queued);
+}
+
+void hud::UiThread::DrainMessages() {
+    {
+        std::lock_guard<std::mutex> guard(inputLock);
+        drainingMessages.swap(pendingMessages);
+    }
+    for (const WindowMessage& queued : drainingMessages) {
+        if (IsKeyMessage(queued.message)) {
+            ForwardKeyMessage(queued.window, queued.message, queued.wParam, queued.lParam, queued.modifiers);
+        } else {
+            ImGui_ImplWin32_WndProcHandler(queued.window, queued.message, queued.wParam, queued.lParam);
+        }
+    }
+    drainingMessages.clear();
+}
+
+void hud::UiThread::NotifyPresent() {
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        presents++;
+    }
+    wakeUp.notify_one();
+}
+
+hud::DrawSnapshot* hud::UiThread::Latest() {
+    if (snapshots.Acquire()) {
+        latest = &snapshots.ReadBuffer();
+    }
+    return latest;
+}
+
+void hud::UiThread::Loop() {
+    core::TraceRecorder& tracer = core::GetTraceRecorder();
+    tracer.NameThread("Overlay UI");
+    uint64_t seen = 0;
+    Clock::time_point previous = Clock::now();
+
+    std::unique_lock<std::mutex> guard(wakeLock);
+    for (;;) {
+        wakeUp.wait(guard, [&]() { return stopping || presents != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = presents;
+        guard.unlock();
+
+        const Clock::time_point start = Clock::now();
+        const int64_t traceStart = core::FrameProfiler::Now();
+        const double elapsedMs = std::chrono::duration<double, std::milli>(start - previous).count();
+        previous = start;
+
+        DrainMessages();
+        uint64_t generation = 0;
+        if (ImDrawData* drawData = build(elapsedMs, generation)) {
+            snapshots.WriteBuffer().CopyFrom(*drawData, generation);
+            if (snapshots.Publish()) {
+                skipped.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            const int64_t costNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            frames.fetch_add(1, std::memory_order_relaxed);
+            lastBuildNs.store(costNs, std::memory_order_relaxed);
+            if (costNs > maxBuildNs.load(std::memory_order_relaxed)) {
+                maxBuildNs.store(costNs, std::memory_order_relaxed);
+            }
+            tracer.Complete("UI build", traceStart, core::FrameProfiler::Now());
+        }
+
+        guard.lock();
+    }
+}
+
+hud::UiThreadStats hud::UiThread::Stats() const {
+    UiThreadStats stats;
+    stats.frames = frames.load(std::memory_order_relaxed);
+    stats.skipped = skipped.load(std::memory_order_relaxed);
+    stats.droppedMessages = droppedMessages.load(std::memory_order_relaxed);
+    stats.lastBuildUs = lastBuildNs.load(std::memory_order_relaxed) / 1000.0;
+    stats.maxBuildUs = maxBuildNs.load(std::memory_order_relaxed) / 1000.0;
+    return stats;
+}
+
+void hud::UiThread::Release() {
+    latest = nullptr;
+    snapshots.Reset();
+}
+
+hud::UiThread& hud::GetUiThread() {
+    static UiThread uiThread;
+    return uiThread;
+}
\ No newline at end of file
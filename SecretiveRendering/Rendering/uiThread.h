@@ -0,0 +1,156 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "imgui.h"
+#include "../Core/tripleBuffer.h"
+
+// Builds the overlay's ImGui frames on a dedicated thread instead of inside hkPresent.
+// hkPresent wakes the UI thread once per Present and draws the newest finished frame: a deep
+// copy of the draw data handed over through a triple buffer, so neither side waits for the
+// other and the overlay runs at most one frame behind. While the thread runs it is the only
+// thread touching the ImGui context: hkWndProc queues window messages for it instead of calling
+// the Win32 backend, and the UI thread feeds them to the backend before each frame. Messages are
+// only queued while the overlay is shown; hiding it queues a focus loss, so keys and buttons held
+// at that point are released rather than stuck when it comes back. A full queue makes room by
+// dropping its oldest mouse move and never drops a release. The backend reads the modifier keys
+// with GetKeyState, which knows nothing on the UI thread, so each key message carries the
+// modifiers captured on the window thread. Mouse capture and leave tracking still only work on
+// the window's own thread and quietly do nothing there. Start/Stop like the other threads: never
+// from DllMain.
+namespace hud {
+    constexpr size_t INPUT_QUEUE_CAPACITY = 256;    // Window messages between two UI frames (releases may exceed it)
+
+    /**
+     * @brief Deep copy of one frame's draw data, owned by a triple buffer slot
+     */
+    struct DrawSnapshot {
+        std::vector<std::unique_ptr<ImDrawList>> lists;
+        ImDrawData drawData;
+        uint64_t generation = 0;    // Retained HUD generation the copy was made from
+
+        /**
+         * @brief Copy draw data into this snapshot's own lists (UI thread, ImGui context current)
+         */
+        void CopyFrom(const ImDrawData& source, uint64_t sourceGeneration);
+    };
+
+    struct UiThreadStats {
+        uint64_t frames = 0;            // Frames published
+        uint64_t skipped = 0;           // Published frames replaced before hkPresent picked them up
+        uint64_t droppedMessages = 0;   // Window messages lost to a full queue
+        double lastBuildUs = 0.0;       // Build and copy of the last published frame
+        double maxBuildUs = 0.0;
+    };
+
+    class UiThread {
+    public:
+        /**
+         * @brief Builds one frame on the UI thread
+         * @param elapsedMs Time since the previous call
+         * @param generation Receives the generation of the returned draw data
+         * @return Draw data to publish, or nullptr if the previous frame is still current
+         */
+        using BuildFunction = std::function<ImDrawData*(double elapsedMs, uint64_t& generation)>;
+
+        UiThread() = default;
+        ~UiThread();
+
+        UiThread(const UiThread&) = delete;
+        UiThread& operator=(const UiThread&) = delete;
+
+        /**
+         * @brief Start the UI thread; from here on only it may touch the ImGui context
+         */
+        void Start(BuildFunction build);
+
+        /**
+         * @brief Stop and join the UI thread; the ImGui context belongs to the caller again
+         */
+        void Stop();
+
+        bool Running() const { return running.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Queue a window message for the UI thread (window thread)
+         * @return false if the thread is not running and ImGui must see the message directly
+         */
+        bool ForwardMessage(HWND window, UINT message, WPARAM wParam, LPARAM lParam);
+
+        /**
+         * @brief Queue input only while the overlay is shown (render thread)
+         */
+        void AcceptInput(bool accept) { acceptInput.store(accept, std::memory_order_release); }
+
+        /**
+         * @brief Let the UI thread build the next frame (render thread, once per Present)
+         */
+        void NotifyPresent();
+
+        /**
+         * @brief Newest finished frame (render thread)
+         * @return nullptr until the first frame is published
+         */
+        DrawSnapshot* Latest();
+
+        UiThreadStats Stats() const;
+
+        /**
+         * @brief Free the snapshots (stopped thread, before ImGui::DestroyContext)
+         */
+        void Release();
+
+    private:
+        struct WindowMessage {
+            HWND window;
+            UINT message;
+            WPARAM wParam;
+            LPARAM lParam;
+            uint8_t modifiers;      // MODIFIER_* bits down when the message arrived
+        };
+
+        void Loop();
+
+        /**
+         * @brief Append a message, making room in a full queue (inputLock held)
+         */
+        void Enqueue(const WindowMessage& queued);
+        void DrainMessages();
+
+        BuildFunction build;
+        core::TripleBuffer<DrawSnapshot> snapshots;
+        DrawSnapshot* latest = nullptr;             // Render thread
+
+        // hkWndProc appends under the lock; the UI thread swaps the whole batch out
+        std::mutex inputLock;
+        std::vector<WindowMessage> pendingMessages;
+        std::vector<WindowMessage> drainingMessages;    // UI thread
+        bool accepting = true;                          // Window thread, under inputLock
+        std::atomic<bool> acceptInput{ true };
+
+        std::thread thread;
+        std::mutex wakeLock;
+        std::condition_variable wakeUp;
+        uint64_t presents = 0;
+        bool stopping = false;
+        std::atomic<bool> running{ false };
+
+        std::atomic<uint64_t> frames{ 0 };
+        std::atomic<uint64_t> skipped{ 0 };
+        std::atomic<uint64_t> droppedMessages{ 0 };
+        std::atomic<int64_t> lastBuildNs{ 0 };
+        std::atomic<int64_t> maxBuildNs{ 0 };
+    };
+
+    /**
+     * @brief UI thread of the overlay
+     */
+    UiThread& GetUiThread();
+}
\ No newline at end of file
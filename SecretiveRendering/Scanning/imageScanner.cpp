@@ -0,0 +1,48 @@
+#include "imageScanner.h"
+#include "parallelScanner.h"
+
+const uint8_t* scanner::ScanImage(const uint8_t* image, const pe::ImageInfo& info, const Pattern& pattern, uint32_t sections, core::WorkerPool& pool) {
+    if (!image || !pattern.valid) {
+        return nullptr;
+    }
+
+    // Ranges are sorted, so the first range with a match holds the lowest-address match
+    for (const pe::RvaRange& range : pe::SectionRanges(info, sections)) {
+        const uint8_t* match = ScanParallel(image + range.begin, image + range.end, pattern, pool);
+        if (match) {
+            return match;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<scanner::SignatureHits> scanner::ScanImageAll(const uint8_t* image, const pe::ImageInfo& info, const SignatureSet& signatures, core::WorkerPool& pool) {
+    std::vector<SignatureHits> results = signatures.ScanAll(nullptr, nullptr);
+    if (!image) {
+        return results;
+    }
+
+    for (const pe::RvaRange& range : pe::SectionRanges(info, signatures.CombinedSections())) {
+        std::vector<SignatureHits> rangeHits = ScanAllParallel(image + range.begin, image + range.end, signatures, pool);
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const uint32_t targets = signatures.SectionsAt(i);
+            for (const uint8_t* hit : rangeHits[i].hits) {
+                // Merged ranges can span several kinds of section; keep only hits in targeted ones
+                const pe::Section* section = pe::FindSection(info, static_cast<uint32_t>(hit - image));
+                if (section && (pe::SectionTarget(*section) & targets)) {
+                    results[i].hits.push_back(hit);
+                }
+            }
+        }
+    }
+    return results;
+}
+
+size_t scanner::ScannedBytes(const pe::ImageInfo& info, uint32_t sections) {
+    size_t total = 0;
+    for (const pe::RvaRange& range : pe::SectionRanges(info, sections)) {
+        total += range.end - range.begin;
+    }
+    return total;
+}
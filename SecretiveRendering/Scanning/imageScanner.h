@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "patternScanner.h"
+#include "multiPatternScanner.h"
+#include "peImage.h"
+#include "../Core/workerPool.h"
+
+// Section-aware scanning of a mapped PE image.
+// Only the sections a signature targets are read (code-only by default), which skips headers,
+// .rdata/.data and relocation pages and keeps data bytes from producing false positives.
+namespace scanner {
+    /**
+     * @brief Scan the sections of a mapped image that match a target mask
+     * @param image Image base (loaded module or a buffer in virtual layout)
+     * @param info Headers parsed from the same image
+     * @param pattern Compiled pattern
+     * @param sections pe::TARGET_* mask
+     * @param pool Worker pool for chunked scanning
+     * @return Lowest-address match, or nullptr
+     */
+    const uint8_t* ScanImage(const uint8_t* image, const pe::ImageInfo& info, const Pattern& pattern, uint32_t sections, core::WorkerPool& pool);
+
+    /**
+     * @brief Multi-signature scan restricted to each signature's declared sections
+     * @return One entry per signature, hits in ascending address order
+     */
+    std::vector<SignatureHits> ScanImageAll(const uint8_t* image, const pe::ImageInfo& info, const SignatureSet& signatures, core::WorkerPool& pool);
+
+    /**
+     * @brief Total bytes a scan with this target mask reads
+     */
+    size_t ScannedBytes(const pe::ImageInfo& info, uint32_t sections);
+}
@@ -0,0 +1,38 @@
+#include "leaResolver.h"
+
+scanner::Resolution scanner::ResolveFromHits(const uint8_t* image, const pe::ImageInfo& info, const SignatureHits& signature, uint32_t kinds) {
+    Resolution resolution;
+    if (!image) {
+        return resolution;
+    }
+
+    for (const uint8_t* hit : signature.hits) {
+        const uint32_t hitRva = static_cast<uint32_t>(hit - image);
+
+        // Never walk back out of the section holding the hit
+        const pe::Section* hitSection = pe::FindSection(info, hitRva);
+        const uint8_t* lowerBound = hitSection ? image + hitSection->virtualAddress : image;
+
+        x64::Reference reference;
+        if (!x64::FindReferenceBefore(hit, lowerBound, kinds, reference)) {
+            continue;
+        }
+
+        // Offline stand-in for IsValidExecutableAddress: the target must be inside a code section
+        const intptr_t target = static_cast<intptr_t>(reference.target - reinterpret_cast<uintptr_t>(image));
+        if (target <= 0 || target >= static_cast<intptr_t>(info.sizeOfImage)) {
+            continue;
+        }
+        const pe::Section* targetSection = pe::FindSection(info, static_cast<uint32_t>(target));
+        if (!targetSection || !(pe::SectionTarget(*targetSection) & pe::TARGET_CODE)) {
+            continue;
+        }
+
+        resolution.resolved = true;
+        resolution.patternRva = hitRva;
+        resolution.instructionOffset = reference.offset;
+        resolution.functionRva = static_cast<uint32_t>(target);
+        return resolution;
+    }
+    return resolution;
+}
\ No newline at end of file
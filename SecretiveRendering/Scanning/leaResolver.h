@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "multiPatternScanner.h"
+#include "peImage.h"
+#include "x64Decoder.h"
+
+// Platform-neutral counterpart of the in-process LEA resolution for images laid out in memory
+// (a loaded module or a pe::MappedImage). Works purely on RVAs, so results from an offline
+// scan can be compared directly with, or seeded into, the in-process signature cache.
+namespace scanner {
+    /**
+     * @brief Resolution of one signature against an image
+     */
+    struct Resolution {
+        bool resolved = false;
+        uint32_t patternRva = 0;        // Hit the function was resolved from
+        int32_t instructionOffset = 0;  // Referencing instruction's offset relative to the hit
+        uint32_t functionRva = 0;
+    };
+
+    /**
+     * @brief Resolve a signature from its scan hits, same search as the in-process hook
+     * Hits are tried in address order; for each, x64::FindReferenceBefore walks back to the nearest
+     * RIP-relative reference of a wanted kind, and the first one targeting a code section wins.
+     * @param kinds x64::REFERENCE_* mask (overlay signatures reference their handler with a LEA)
+     */
+    Resolution ResolveFromHits(const uint8_t* image, const pe::ImageInfo& info, const SignatureHits& signature,
+        uint32_t kinds = x64::REFERENCE_LEA);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "mappedImage.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Cap on SizeOfImage we are willing to allocate; real overlay builds are a few MB
+    constexpr uint32_t MAX_IMAGE_SIZE = 512u * 1024 * 1024;
+
+    /**
+     * @brief Read-only view of a whole file, unmapped on destruction
+     */
+    class FileView {
+    public:
+        explicit FileView(const char* path) {
+#ifdef _WIN32
+            file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                return;
+            }
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+                return;
+            }
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) {
+                return;
+            }
+            data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            size = data ? static_cast<size_t>(fileSize.QuadPart) : 0;
+#else
+            descriptor = open(path, O_RDONLY);
+            if (descriptor < 0) {
+                return;
+            }
+            struct stat status;
+            if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+                return;
+            }
+            void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (view == MAP_FAILED) {
+                return;
+            }
+            data = static_cast<const uint8_t*>(view);
+            size = static_cast<size_t>(status.st_size);
+#endif
+        }
+
+        ~FileView() {
+#ifdef _WIN32
+            if (data) UnmapViewOfFile(data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+            if (data) munmap(const_cast<uint8_t*>(data), size);
+            if (descriptor >= 0) close(descriptor);
+#endif
+        }
+
+        FileView(const FileView&) = delete;
+        FileView& operator=(const FileView&) = delete;
+
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+    private:
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#else
+        int descriptor = -1;
+#endif
+    };
+}
+
+bool pe::MappedImage::Load(const char* path) {
+    image.clear();
+    info = ImageInfo();
+    fileSize = 0;
+    if (!path) {
+        return false;
+    }
+
+    FileView view(path);
+    return view.data && LoadFromFile(view.data, view.size);
+}
+
+bool pe::MappedImage::LoadFromFile(const uint8_t* fileData, size_t size) {
+    image.clear();
+    fileSize = 0;
+    if (!ParseImage(fileData, size, info) || !info.sizeOfImage || info.sizeOfImage > MAX_IMAGE_SIZE) {
+        info = ImageInfo();
+        return false;
+    }
+
+    // Unmapped gaps and the tail of each section past its raw data read as zero, as in memory
+    image.assign(info.sizeOfImage, 0);
+
+    const size_t headerSize = (std::min)({ static_cast<size_t>(info.sizeOfHeaders), size, image.size() });
+    memcpy(image.data(), fileData, headerSize);
+
+    for (const Section& section : info.sections) {
+        if (section.virtualAddress >= image.size() || section.rawOffset >= size) {
+            continue;
+        }
+
+        size_t copySize = (std::min)(section.rawSize, MappedSize(section));
+        copySize = (std::min)(copySize, size - section.rawOffset);
+        copySize = (std::min)(copySize, image.size() - section.virtualAddress);
+        memcpy(image.data() + section.virtualAddress, fileData + section.rawOffset, copySize);
+    }
+
+    fileSize = size;
+    return true;
+}
\ No newline at end of file
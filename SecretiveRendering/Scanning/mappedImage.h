@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "peImage.h"
+
+// PE file from disk laid out the way the Windows loader would map it.
+// The file is memory-mapped read-only and each section is placed at its RVA in a SizeOfImage
+// buffer, so offsets found here are the same RVAs the in-process scan reports. No relocations
+// or imports are applied; code that only follows RIP-relative references does not need them.
+namespace pe {
+    class MappedImage {
+    public:
+        MappedImage() = default;
+        MappedImage(const MappedImage&) = delete;
+        MappedImage& operator=(const MappedImage&) = delete;
+
+        /**
+         * @brief Map a PE file and build its virtual layout
+         * @param path File path (e.g., a copy of gameoverlayrenderer64.dll)
+         * @return false if the file cannot be mapped or is not a well-formed PE image
+         */
+        bool Load(const char* path);
+
+        /**
+         * @brief Build the virtual layout from a file already held in memory
+         * @return false if the buffer is not a well-formed PE image
+         */
+        bool LoadFromFile(const uint8_t* fileData, size_t fileSize);
+
+        const uint8_t* Data() const { return image.data(); }
+        size_t Size() const { return image.size(); }
+        const ImageInfo& Info() const { return info; }
+
+        /**
+         * @brief Size of the file on disk the image was built from
+         */
+        size_t FileSize() const { return fileSize; }
+
+    private:
+        std::vector<uint8_t> image;
+        ImageInfo info;
+        size_t fileSize = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "multiPatternScanner.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MULTISCAN_HAS_X64_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define MULTISCAN_HAS_X64_SIMD 0
+#endif
+
+#if MULTISCAN_HAS_X64_SIMD && !defined(_MSC_VER)
+#define MULTISCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MULTISCAN_TARGET_AVX2
+#endif
+
+namespace {
+    using scanner::MAX_VECTOR_PREFILTER_BYTES;
+    using scanner::PREFILTER_BUCKETS;
+    using scanner::PREFILTER_WIDTH;
+
+    /**
+     * @brief Nibble sets of one prefilter bucket: low and high nibble of each tested byte
+     */
+    struct NibbleSets {
+        uint16_t sets[PREFILTER_WIDTH * 2] = {};
+
+        void Add(const NibbleSets& other) {
+            for (size_t i = 0; i < PREFILTER_WIDTH * 2; i++) {
+                sets[i] |= other.sets[i];
+            }
+        }
+    };
+
+    /**
+     * @brief Share of code bytes (weighted by ByteCommonness) whose low and high nibble are both in the sets
+     */
+    double NibbleCoverage(uint16_t lowSet, uint16_t highSet) {
+        double covered = 0.0;
+        double total = 0.0;
+        for (uint32_t value = 0; value < 256; value++) {
+            const double weight = scanner::ByteCommonness(static_cast<uint8_t>(value));
+            total += weight;
+            if ((lowSet >> (value & 0xF) & 1) && (highSet >> (value >> 4) & 1)) {
+                covered += weight;
+            }
+        }
+        return covered / total;
+    }
+
+    /**
+     * @brief Expected share of positions a bucket lets through the prefilter
+     */
+    double PassRate(const NibbleSets& bucket) {
+        double rate = 1.0;
+        for (size_t side = 0; side < PREFILTER_WIDTH; side++) {
+            rate *= NibbleCoverage(bucket.sets[side * 2], bucket.sets[side * 2 + 1]);
+        }
+        return rate;
+    }
+
+    inline unsigned LowestSetBit(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+    }
+
+    inline uint32_t PairKey(const uint8_t* position) {
+        return static_cast<uint32_t>(position[0]) | static_cast<uint32_t>(position[1]) << 8;
+    }
+
+#if MULTISCAN_HAS_X64_SIMD
+    /**
+     * @brief Nibble lookup tables of the prefilter, broadcast to both lanes (low, high per tested byte)
+     */
+    struct PrefilterMasks {
+        __m256i nibbles[PREFILTER_WIDTH * 2];
+    };
+
+    /**
+     * @brief Buckets holding the byte at each position of a 32-byte block
+     */
+    MULTISCAN_TARGET_AVX2
+    inline __m256i BucketsOf(const uint8_t* block, __m256i lowTable, __m256i highTable) {
+        const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        return _mm256_and_si256(
+            _mm256_shuffle_epi8(lowTable, _mm256_and_si256(bytes, lowNibble)),
+            _mm256_shuffle_epi8(highTable, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), lowNibble)));
+    }
+
+    /**
+     * @brief Per position of a 32-byte block: buckets holding all of its tested bytes
+     */
+    MULTISCAN_TARGET_AVX2
+    inline __m256i PrefilterBlock(const uint8_t* block, const PrefilterMasks& masks) {
+        __m256i buckets = BucketsOf(block, masks.nibbles[0], masks.nibbles[1]);
+        for (size_t side = 1; side < PREFILTER_WIDTH; side++) {
+            buckets = _mm256_and_si256(buckets, BucketsOf(block + side, masks.nibbles[side * 2], masks.nibbles[side * 2 + 1]));
+        }
+        return buckets;
+    }
+
+    MULTISCAN_TARGET_AVX2
+    inline uint32_t CandidateBits(__m256i buckets) {
+        return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(buckets, _mm256_setzero_si256())));
+    }
+
+    /**
+     * @brief Nibble-table prefilter over 64 positions at a time (Teddy-style)
+     * A position survives when some bucket contains every byte tested from it on.
+     * Survivors are handed to checkPosition, which does the exact bitmap/bucket lookup.
+     * @return First position not covered by a full vector block
+     */
+    template<typename Callback>
+    MULTISCAN_TARGET_AVX2
+    const uint8_t* PrefilterAVX2(const uint8_t* position, const uint8_t* end, const uint8_t (&tables)[PREFILTER_WIDTH * 2][16], Callback& checkPosition) {
+        PrefilterMasks masks;
+        for (size_t table = 0; table < PREFILTER_WIDTH * 2; table++) {
+            masks.nibbles[table] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[table])));
+        }
+
+        // Every load must stay inside [position, end): a block reads PREFILTER_WIDTH - 1 bytes past its 32.
+        // Nearly every pair of blocks has no candidate and costs a single test.
+        constexpr ptrdiff_t BLOCK_READ = 32 + PREFILTER_WIDTH - 1;
+        for (; end - position >= 32 + BLOCK_READ; position += 64) {
+            const __m256i low = PrefilterBlock(position, masks);
+            const __m256i high = PrefilterBlock(position + 32, masks);
+            const __m256i any = _mm256_or_si256(low, high);
+            if (_mm256_testz_si256(any, any)) {
+                continue;
+            }
+            for (uint32_t candidates = CandidateBits(low); candidates; candidates &= candidates - 1) {
+                checkPosition(position + LowestSetBit(candidates));
+            }
+            for (uint32_t candidates = CandidateBits(high); candidates; candidates &= candidates - 1) {
+                checkPosition(position + 32 + LowestSetBit(candidates));
+            }
+        }
+        if (end - position >= BLOCK_READ) {
+            for (uint32_t candidates = CandidateBits(PrefilterBlock(position, masks)); candidates; candidates &= candidates - 1) {
+                checkPosition(position + LowestSetBit(candidates));
+            }
+            position += 32;
+        }
+        return position;
+    }
+#endif
+
+    /**
+     * @brief Offset of the rarest adjacent fixed byte pair, or of the pair around the anchor
+     * byte when a signature has no two fixed bytes in a row
+     * The byte after the pair counts too, as the prefilter tests it: a wildcard there scores
+     * worse than any fixed byte.
+     */
+    size_t ChooseAnchorPair(const scanner::Pattern& pattern) {
+        size_t best = pattern.length;
+        unsigned bestScore = ~0u;
+        for (size_t i = 0; i + 1 < pattern.length; i++) {
+            if (!pattern.mask[i] || !pattern.mask[i + 1]) {
+                continue;
+            }
+            const bool nextFixed = i + 2 < pattern.length && pattern.mask[i + 2];
+            const unsigned score = scanner::ByteCommonness(pattern.bytes[i]) + scanner::ByteCommonness(pattern.bytes[i + 1]) +
+                (nextFixed ? scanner::ByteCommonness(pattern.bytes[i + 2]) : 256u);
+            if (score < bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+
+        if (best != pattern.length) {
+            return best;
+        }
+        return pattern.anchor + 1 < pattern.length ? pattern.anchor : pattern.anchor - 1;
+    }
+}
+
+bool scanner::SignatureSet::Add(const char* name, const char* text, uint32_t sections) {
+    Pattern pattern;
+    if (!CompilePattern(text, pattern)) {
+        return false;
+    }
+    return Add(name, pattern, sections);
+}
+
+bool scanner::SignatureSet::Add(const char* name, const Pattern& pattern, uint32_t sections) {
+    // Anchors are byte pairs, so a signature needs at least two bytes
+    if (!pattern.valid || pattern.length < 2) {
+        return false;
+    }
+
+    names.push_back(name);
+    patterns.push_back(pattern);
+    anchorOffsets.push_back(ChooseAnchorPair(pattern));
+    sectionTargets.push_back(sections);
+    if (pattern.length > maxLength) {
+        maxLength = pattern.length;
+    }
+
+    // Tables are rebuilt once, by the next scan
+    built.store(false, std::memory_order_release);
+    return true;
+}
+
+int scanner::SignatureSet::IndexOf(const char* name) const {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (name && names[i] && strcmp(names[i], name) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+uint32_t scanner::SignatureSet::CombinedSections() const {
+    uint32_t combined = 0;
+    for (uint32_t sections : sectionTargets) {
+        combined |= sections;
+    }
+    return combined;
+}
+
+void scanner::SignatureSet::Prepare() const {
+    if (built.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(buildLock);
+    if (!built.load(std::memory_order_relaxed)) {
+        Rebuild();
+        built.store(true, std::memory_order_release);
+    }
+}
+
+void scanner::SignatureSet::Rebuild() const {
+    // Expand each signature's anchor into the concrete pair keys it can match
+    std::vector<uint32_t> counts(65536, 0);
+    std::vector<std::pair<uint32_t, AnchorEntry>> expanded;
+
+    for (size_t i = 0; i < patterns.size(); i++) {
+        const Pattern& pattern = patterns[i];
+        const size_t offset = anchorOffsets[i];
+        const bool lowFixed = pattern.mask[offset] != 0;
+        const bool highFixed = pattern.mask[offset + 1] != 0;
+
+        for (uint32_t low = 0; low < 256; low++) {
+            if (lowFixed && low != pattern.bytes[offset]) {
+                continue;
+            }
+            for (uint32_t high = 0; high < 256; high++) {
+                if (highFixed && high != pattern.bytes[offset + 1]) {
+                    continue;
+                }
+                const uint32_t key = low | high << 8;
+                expanded.push_back({ key, { static_cast<uint32_t>(i), static_cast<uint32_t>(offset) } });
+                counts[key]++;
+            }
+        }
+    }
+
+    pairBitmap.assign(65536 / 64, 0);
+    bucketStart.assign(65537, 0);
+    for (uint32_t key = 0; key < 65536; key++) {
+        bucketStart[key + 1] = bucketStart[key] + counts[key];
+        if (counts[key]) {
+            pairBitmap[key >> 6] |= 1ull << (key & 63);
+        }
+    }
+
+    // Each anchor joins the prefilter bucket whose pass rate it raises the least; hashing by the
+    // leading byte instead piles common nibbles into the same buckets as signatures are added
+    NibbleSets buckets[PREFILTER_BUCKETS];
+    for (size_t i = 0; i < patterns.size(); i++) {
+        const Pattern& pattern = patterns[i];
+        const size_t offset = anchorOffsets[i];
+        NibbleSets anchor;
+        for (size_t side = 0; side < PREFILTER_WIDTH; side++) {
+            const bool fixed = offset + side < pattern.length && pattern.mask[offset + side] != 0;
+            const uint8_t value = pattern.bytes[offset + side];
+            anchor.sets[side * 2] = fixed ? static_cast<uint16_t>(1u << (value & 0xF)) : 0xFFFF;
+            anchor.sets[side * 2 + 1] = fixed ? static_cast<uint16_t>(1u << (value >> 4)) : 0xFFFF;
+        }
+
+        size_t best = 0;
+        double bestIncrease = 2.0;
+        for (size_t bucket = 0; bucket < PREFILTER_BUCKETS; bucket++) {
+            NibbleSets merged = buckets[bucket];
+            merged.Add(anchor);
+            const double increase = PassRate(merged) - PassRate(buckets[bucket]);
+            if (increase < bestIncrease) {
+                bestIncrease = increase;
+                best = bucket;
+            }
+        }
+        buckets[best].Add(anchor);
+    }
+
+    memset(prefilterTables, 0, sizeof(prefilterTables));
+    for (size_t bucket = 0; bucket < PREFILTER_BUCKETS; bucket++) {
+        for (size_t table = 0; table < PREFILTER_WIDTH * 2; table++) {
+            for (uint32_t nibble = 0; nibble < 16; nibble++) {
+                if (buckets[bucket].sets[table] >> nibble & 1) {
+                    prefilterTables[table][nibble] |= static_cast<uint8_t>(1u << bucket);
+                }
+            }
+        }
+    }
+
+    // Distinct leading bytes of all anchor pairs
+    leadingCount = 0;
+    for (uint32_t key = 0; key < 65536 && leadingCount <= MAX_VECTOR_PREFILTER_BYTES; key++) {
+        const uint8_t low = static_cast<uint8_t>(key & 0xFF);
+        if (!counts[key] || memchr(leadingBytes, low, (std::min)(leadingCount, MAX_VECTOR_PREFILTER_BYTES))) {
+            continue;
+        }
+        if (leadingCount < MAX_VECTOR_PREFILTER_BYTES) {
+            leadingBytes[leadingCount] = low;
+        }
+        leadingCount++;
+    }
+
+    entries.assign(expanded.size(), AnchorEntry{ 0, 0 });
+    std::vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (const auto& item : expanded) {
+        entries[fill[item.first]++] = item.second;
+    }
+}
+
+std::vector<scanner::SignatureHits> scanner::SignatureSet::ScanAll(const uint8_t* begin, const uint8_t* end) const {
+    std::vector<SignatureHits> results(patterns.size());
+    for (size_t i = 0; i < patterns.size(); i++) {
+        results[i].name = names[i];
+    }
+
+    if (patterns.empty() || !begin || !end || end - begin < 2) {
+        return results;
+    }
+    Prepare();
+
+    const uint64_t* bitmap = pairBitmap.data();
+    const uint8_t* last = end - 1; // Last position whose byte pair is fully readable
+
+    auto checkPosition = [&](const uint8_t* position) {
+        const uint32_t key = PairKey(position);
+        if (!(bitmap[key >> 6] >> (key & 63) & 1)) {
+            return;
+        }
+
+        for (uint32_t e = bucketStart[key]; e < bucketStart[key + 1]; e++) {
+            const AnchorEntry& entry = entries[e];
+            const Pattern& pattern = patterns[entry.signature];
+            if (static_cast<size_t>(position - begin) < entry.offset) {
+                continue;
+            }
+            const uint8_t* start = position - entry.offset;
+            if (static_cast<size_t>(end - start) < pattern.length) {
+                continue;
+            }
+            if (MatchesAt(start, pattern)) {
+                results[entry.signature].hits.push_back(start);
+            }
+        }
+    };
+
+    const uint8_t* position = begin;
+
+#if MULTISCAN_HAS_X64_SIMD
+    if (GetActiveBackend() == ScanBackend::AVX2) {
+        position = PrefilterAVX2(position, end, prefilterTables, checkPosition);
+    }
+    else if (leadingCount <= MAX_VECTOR_PREFILTER_BYTES) {
+        __m128i needles[MAX_VECTOR_PREFILTER_BYTES];
+        for (size_t i = 0; i < leadingCount; i++) {
+            needles[i] = _mm_set1_epi8(static_cast<char>(leadingBytes[i]));
+        }
+
+        for (; last - position >= 16; position += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+            __m128i hit = _mm_cmpeq_epi8(block, needles[0]);
+            for (size_t i = 1; i < leadingCount; i++) {
+                hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[i]));
+            }
+
+            for (uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(hit)); bits; bits &= bits - 1) {
+                checkPosition(position + LowestSetBit(bits));
+            }
+        }
+    }
+#endif
+
+    for (; position < last; position++) {
+        checkPosition(position);
+    }
+
+    return results;
+}
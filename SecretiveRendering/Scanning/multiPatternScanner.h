@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "patternScanner.h"
+#include "peImage.h"
+
+// Single-pass scanning for many wildcard signatures at once.
+// Each signature contributes one two-byte anchor to a 64K-entry table; the scan reads every
+// byte pair once (with a vector prefilter in front), so its cost stays flat as signatures are added.
+// The prefilter tests the anchor pair and the byte after it against 8 nibble buckets; each
+// signature joins the bucket whose share of passing code bytes it raises the least. Tables are
+// built once, by the first scan after signatures were added; add every signature before scanning
+// from several threads.
+namespace scanner {
+    // Without AVX2, candidates are found with SSE2 compares when the anchors have this many
+    // distinct leading bytes or fewer
+    constexpr size_t MAX_VECTOR_PREFILTER_BYTES = 4;
+    constexpr size_t PREFILTER_BUCKETS = 8;     // Bits of a nibble table entry
+    constexpr size_t PREFILTER_WIDTH = 3;       // Bytes tested from the anchor pair on
+
+    /**
+     * @brief Every match of one signature, in ascending address order
+     */
+    struct SignatureHits {
+        const char* name;
+        std::vector<const uint8_t*> hits;
+    };
+
+    /**
+     * @brief Set of named signatures scanned together in a single pass
+     */
+    class SignatureSet {
+    public:
+        /**
+         * @brief Compile and add a named signature
+         * @param name Name for logging and lookup (must outlive the set)
+         * @param text Pattern string (e.g., "48 8B ? 88 00 00 00 E8")
+         * @param sections pe::TARGET_* kinds of section the signature may match in (image scans only)
+         * @return true if the pattern compiled and was added
+         */
+        bool Add(const char* name, const char* text, uint32_t sections = pe::TARGET_CODE);
+
+        /**
+         * @brief Add an already compiled signature
+         * @return true if the pattern is valid and was added
+         */
+        bool Add(const char* name, const Pattern& pattern, uint32_t sections = pe::TARGET_CODE);
+
+        /**
+         * @brief Find every match of every signature in [begin, end)
+         * @return One entry per signature, in insertion order
+         */
+        std::vector<SignatureHits> ScanAll(const uint8_t* begin, const uint8_t* end) const;
+
+        /**
+         * @brief Index of a signature by name, or -1 if not present
+         */
+        int IndexOf(const char* name) const;
+
+        size_t Size() const { return patterns.size(); }
+        size_t MaxLength() const { return maxLength; }
+        const char* NameAt(size_t index) const { return names[index]; }
+        const Pattern& PatternAt(size_t index) const { return patterns[index]; }
+        uint32_t SectionsAt(size_t index) const { return sectionTargets[index]; }
+
+        /**
+         * @brief Union of the section targets of every signature
+         */
+        uint32_t CombinedSections() const;
+
+    private:
+        struct AnchorEntry {
+            uint32_t signature;
+            uint32_t offset;    // Offset of the anchor pair inside the signature
+        };
+
+        /**
+         * @brief Build the tables below if signatures were added since (any thread)
+         */
+        void Prepare() const;
+        void Rebuild() const;
+
+        std::vector<const char*> names;
+        std::vector<Pattern> patterns;
+        std::vector<size_t> anchorOffsets;
+        std::vector<uint32_t> sectionTargets;
+        size_t maxLength = 0;
+
+        // Built by Prepare from the signatures above
+        mutable std::mutex buildLock;
+        mutable std::atomic<bool> built{ false };
+
+        // Bitmap over all 65536 little-endian byte pairs, plus CSR buckets of anchor entries
+        mutable std::vector<uint64_t> pairBitmap;
+        mutable std::vector<uint32_t> bucketStart;
+        mutable std::vector<AnchorEntry> entries;
+
+        // Nibble lookup tables (low/high nibble of each tested byte) for the vector prefilter
+        mutable uint8_t prefilterTables[PREFILTER_WIDTH * 2][16] = {};
+
+        // Distinct leading bytes of the anchor pairs, for the SSE2 prefilter (count may exceed the array)
+        mutable uint8_t leadingBytes[MAX_VECTOR_PREFILTER_BYTES] = {};
+        mutable size_t leadingCount = 0;
+    };
+}
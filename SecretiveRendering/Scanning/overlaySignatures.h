@@ -0,0 +1,14 @@
+#pragma once
+
+#include "signature.h"
+
+// Steam overlay (gameoverlayrenderer64.dll) signatures.
+// Each one matches the call that registers a D3D9 hook; the LEA just before it loads the
+// address of the overlay's own Present/Reset handler.
+namespace overlaySignatures {
+    DECLARE_SIGNATURE(PRESENT, "Present", "48 8B ? 88 00 00 00 E8");
+    DECLARE_SIGNATURE(RESET, "Reset", "48 8B ? 80 00 00 00 E8");
+
+    // Every signature resolved at startup, in resolution order
+    inline constexpr const scanner::Signature* ALL[] = { &PRESENT, &RESET };
+}
\ No newline at end of file
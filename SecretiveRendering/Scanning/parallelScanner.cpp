@@ -0,0 +1,112 @@
+#include "parallelScanner.h"
+
+#include <atomic>
+
+namespace {
+    struct ChunkLayout {
+        size_t count;
+        size_t overlap;
+    };
+
+    ChunkLayout LayoutChunks(const uint8_t* begin, const uint8_t* end, size_t longestPattern) {
+        const size_t size = static_cast<size_t>(end - begin);
+        return { (size + scanner::PARALLEL_CHUNK_SIZE - 1) / scanner::PARALLEL_CHUNK_SIZE,
+                 longestPattern ? longestPattern - 1 : 0 };
+    }
+
+    /**
+     * @brief Start positions owned by a chunk, and the extended window it has to read
+     */
+    void ChunkBounds(const uint8_t* begin, const uint8_t* end, size_t index, size_t overlap,
+                     const uint8_t*& chunkBegin, const uint8_t*& ownedEnd, const uint8_t*& windowEnd) {
+        const size_t size = static_cast<size_t>(end - begin);
+        const size_t offset = index * scanner::PARALLEL_CHUNK_SIZE;
+        const size_t ownedSize = size - offset < scanner::PARALLEL_CHUNK_SIZE ? size - offset : scanner::PARALLEL_CHUNK_SIZE;
+
+        chunkBegin = begin + offset;
+        ownedEnd = chunkBegin + ownedSize;
+        windowEnd = static_cast<size_t>(end - ownedEnd) < overlap ? end : ownedEnd + overlap;
+    }
+}
+
+const uint8_t* scanner::ScanParallel(const uint8_t* begin, const uint8_t* end, const Pattern& pattern, core::WorkerPool& pool) {
+    if (!begin || !end || begin >= end || !pattern.valid) {
+        return nullptr;
+    }
+
+    const ChunkLayout layout = LayoutChunks(begin, end, pattern.length);
+    if (layout.count < 2) {
+        return Scan(begin, end, pattern);
+    }
+
+    std::vector<const uint8_t*> chunkMatches(layout.count, nullptr);
+    std::atomic<size_t> firstMatchingChunk{ layout.count };
+
+    core::ParallelFor(pool, layout.count, [&](size_t index) {
+        // A lower chunk already matched, so nothing here can be the lowest-address result
+        if (index > firstMatchingChunk.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const uint8_t* chunkBegin;
+        const uint8_t* ownedEnd;
+        const uint8_t* windowEnd;
+        ChunkBounds(begin, end, index, layout.overlap, chunkBegin, ownedEnd, windowEnd);
+
+        const uint8_t* match = Scan(chunkBegin, windowEnd, pattern);
+        if (!match) {
+            return;
+        }
+
+        chunkMatches[index] = match;
+        size_t current = firstMatchingChunk.load(std::memory_order_relaxed);
+        while (index < current && !firstMatchingChunk.compare_exchange_weak(current, index, std::memory_order_relaxed)) {
+        }
+    });
+
+    for (const uint8_t* match : chunkMatches) {
+        if (match) {
+            return match;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<scanner::SignatureHits> scanner::ScanAllParallel(const uint8_t* begin, const uint8_t* end, const SignatureSet& signatures, core::WorkerPool& pool) {
+    if (!begin || !end || begin >= end) {
+        return signatures.ScanAll(nullptr, nullptr);
+    }
+
+    const ChunkLayout layout = LayoutChunks(begin, end, signatures.MaxLength());
+    if (layout.count < 2) {
+        return signatures.ScanAll(begin, end);
+    }
+
+    std::vector<std::vector<SignatureHits>> chunkResults(layout.count);
+
+    core::ParallelFor(pool, layout.count, [&](size_t index) {
+        const uint8_t* chunkBegin;
+        const uint8_t* ownedEnd;
+        const uint8_t* windowEnd;
+        ChunkBounds(begin, end, index, layout.overlap, chunkBegin, ownedEnd, windowEnd);
+
+        std::vector<SignatureHits> hits = signatures.ScanAll(chunkBegin, windowEnd);
+
+        // Matches starting in the overlap belong to the next chunk
+        for (SignatureHits& signature : hits) {
+            while (!signature.hits.empty() && signature.hits.back() >= ownedEnd) {
+                signature.hits.pop_back();
+            }
+        }
+        chunkResults[index] = std::move(hits);
+    });
+
+    // Concatenate in chunk order so hits stay in ascending address order
+    std::vector<SignatureHits> results = signatures.ScanAll(nullptr, nullptr);
+    for (const auto& chunk : chunkResults) {
+        for (size_t i = 0; i < results.size(); i++) {
+            results[i].hits.insert(results[i].hits.end(), chunk[i].hits.begin(), chunk[i].hits.end());
+        }
+    }
+    return results;
+}
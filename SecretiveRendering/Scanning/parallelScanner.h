@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "patternScanner.h"
+#include "multiPatternScanner.h"
+#include "../Core/workerPool.h"
+
+// Chunked parallel scanning on the shared worker pool.
+// Each chunk owns the match start positions inside it and reads (longest pattern - 1) bytes
+// past its end, so a match straddling a chunk boundary is found exactly once.
+namespace scanner {
+    constexpr size_t PARALLEL_CHUNK_SIZE = 1024 * 1024;
+
+    /**
+     * @brief Parallel single-pattern scan
+     * Deterministic: returns the lowest-address match, the same result as Scan().
+     * Ranges smaller than two chunks are scanned serially on the calling thread.
+     * @return First match in [begin, end), or nullptr if not found
+     */
+    const uint8_t* ScanParallel(const uint8_t* begin, const uint8_t* end, const Pattern& pattern, core::WorkerPool& pool);
+
+    /**
+     * @brief Parallel multi-signature scan
+     * @return Same result as SignatureSet::ScanAll (every hit, ascending, per signature)
+     */
+    std::vector<SignatureHits> ScanAllParallel(const uint8_t* begin, const uint8_t* end, const SignatureSet& signatures, core::WorkerPool& pool);
+}
@@ -0,0 +1,323 @@
+#include "patternScanner.h"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SCANNER_HAS_X64_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define SCANNER_HAS_X64_SIMD 0
+#endif
+
+// MSVC emits AVX2 intrinsics without per-function opt-in; GCC/Clang need a target attribute
+#if SCANNER_HAS_X64_SIMD && !defined(_MSC_VER)
+#define SCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SCANNER_TARGET_AVX2
+#endif
+
+namespace {
+    /**
+     * @brief Last valid start position for a match, or nullptr if the range is too short
+     */
+    const uint8_t* LastCandidate(const uint8_t* begin, const uint8_t* end, const scanner::Pattern& pattern) {
+        if (!begin || !end || begin >= end || !pattern.valid) {
+            return nullptr;
+        }
+        if (static_cast<size_t>(end - begin) < pattern.length) {
+            return nullptr;
+        }
+        return end - pattern.length;
+    }
+
+    /**
+     * @brief Scalar scan of [position, last] using the anchor byte as a prefilter
+     */
+    const uint8_t* ScanScalarRange(const uint8_t* position, const uint8_t* last, const scanner::Pattern& pattern) {
+        const uint8_t anchorByte = pattern.bytes[pattern.anchor];
+
+        while (position <= last) {
+            const size_t remaining = static_cast<size_t>(last - position) + 1;
+            const void* hit = memchr(position + pattern.anchor, anchorByte, remaining);
+            if (!hit) {
+                return nullptr;
+            }
+
+            const uint8_t* candidate = static_cast<const uint8_t*>(hit) - pattern.anchor;
+            if (scanner::MatchesAt(candidate, pattern)) {
+                return candidate;
+            }
+            position = candidate + 1;
+        }
+
+        return nullptr;
+    }
+
+#if SCANNER_HAS_X64_SIMD
+    inline unsigned CountTrailingZeros(uint32_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+    }
+
+    inline unsigned CountTrailingZeros64(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+    }
+
+    bool CpuSupportsAVX2() {
+        int regs[4] = { 0 };
+#if defined(_MSC_VER)
+        __cpuid(regs, 0);
+        if (regs[0] < 7) {
+            return false;
+        }
+        __cpuid(regs, 1);
+        const bool osxsave = (regs[2] & (1 << 27)) != 0;
+        const bool avx = (regs[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) {
+            return false;
+        }
+        // OS must save YMM state on context switch (XCR0 bits 1 and 2)
+        if ((_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_max(0, nullptr) < 7) {
+            return false;
+        }
+        __cpuid(1, eax, ebx, ecx, edx);
+        const bool osxsave = (ecx & (1u << 27)) != 0;
+        const bool avx = (ecx & (1u << 28)) != 0;
+        if (!osxsave || !avx) {
+            return false;
+        }
+        unsigned int xcr0Low, xcr0High;
+        __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        if ((xcr0Low & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        (void)regs;
+        return (ebx & (1u << 5)) != 0;
+#endif
+    }
+
+    /**
+     * @brief Masked 16-byte-wide verification of a candidate
+     * Falls back to the scalar compare when the padded read would cross end.
+     */
+    inline bool VerifySSE2(const uint8_t* candidate, const uint8_t* end, const scanner::Pattern& pattern) {
+        const size_t paddedLength = (pattern.length + 15) & ~static_cast<size_t>(15);
+        if (static_cast<size_t>(end - candidate) < paddedLength) {
+            return scanner::MatchesAt(candidate, pattern);
+        }
+
+        for (size_t offset = 0; offset < paddedLength; offset += 16) {
+            const __m128i memory = _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidate + offset));
+            const __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern.bytes + offset));
+            const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern.mask + offset));
+            const __m128i diff = _mm_and_si128(_mm_xor_si128(memory, bytes), mask);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Lanes of a 16-byte block where both anchors match (0xFF per candidate start)
+     */
+    inline __m128i AnchorMatchesSSE2(const uint8_t* position, const scanner::Pattern& pattern, __m128i firstAnchor, __m128i secondAnchor) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position + pattern.anchor));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position + pattern.secondAnchor));
+        return _mm_and_si128(_mm_cmpeq_epi8(first, firstAnchor), _mm_cmpeq_epi8(second, secondAnchor));
+    }
+
+    const uint8_t* ScanSSE2(const uint8_t* begin, const uint8_t* end, const scanner::Pattern& pattern) {
+        const uint8_t* last = LastCandidate(begin, end, pattern);
+        if (!last) {
+            return nullptr;
+        }
+
+        const __m128i firstAnchor = _mm_set1_epi8(static_cast<char>(pattern.bytes[pattern.anchor]));
+        const __m128i secondAnchor = _mm_set1_epi8(static_cast<char>(pattern.bytes[pattern.secondAnchor]));
+
+        // Every lane of a block must be a valid start so both anchor loads stay inside [begin, end)
+        const size_t startCount = static_cast<size_t>(last - begin) + 1;
+        const uint8_t* wideLimit = begin + (startCount & ~static_cast<size_t>(63));
+        const uint8_t* blockLimit = begin + (startCount & ~static_cast<size_t>(15));
+        const uint8_t* position = begin;
+
+        // Four blocks per iteration, tested together: candidates are rare, so most iterations take one branch
+        for (; position < wideLimit; position += 64) {
+            const __m128i block0 = AnchorMatchesSSE2(position, pattern, firstAnchor, secondAnchor);
+            const __m128i block1 = AnchorMatchesSSE2(position + 16, pattern, firstAnchor, secondAnchor);
+            const __m128i block2 = AnchorMatchesSSE2(position + 32, pattern, firstAnchor, secondAnchor);
+            const __m128i block3 = AnchorMatchesSSE2(position + 48, pattern, firstAnchor, secondAnchor);
+            if (!_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(block0, block1), _mm_or_si128(block2, block3)))) {
+                continue;
+            }
+
+            uint64_t candidates = static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(block0))) |
+                static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(block1))) << 16 |
+                static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(block2))) << 32 |
+                static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(block3))) << 48;
+            while (candidates) {
+                const uint8_t* candidate = position + CountTrailingZeros64(candidates);
+                if (VerifySSE2(candidate, end, pattern)) {
+                    return candidate;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+
+        for (; position < blockLimit; position += 16) {
+            uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(AnchorMatchesSSE2(position, pattern, firstAnchor, secondAnchor)));
+
+            while (candidates) {
+                const uint8_t* candidate = position + CountTrailingZeros(candidates);
+                if (VerifySSE2(candidate, end, pattern)) {
+                    return candidate;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+
+        return ScanScalarRange(position, last, pattern);
+    }
+
+    SCANNER_TARGET_AVX2
+    inline bool VerifyAVX2(const uint8_t* candidate, const uint8_t* end, const scanner::Pattern& pattern) {
+        const size_t paddedLength = (pattern.length + 31) & ~static_cast<size_t>(31);
+        if (static_cast<size_t>(end - candidate) < paddedLength) {
+            return scanner::MatchesAt(candidate, pattern);
+        }
+
+        for (size_t offset = 0; offset < paddedLength; offset += 32) {
+            const __m256i memory = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(candidate + offset));
+            const __m256i bytes = _mm256_load_si256(reinterpret_cast<const __m256i*>(pattern.bytes + offset));
+            const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(pattern.mask + offset));
+            const __m256i diff = _mm256_and_si256(_mm256_xor_si256(memory, bytes), mask);
+            if (!_mm256_testz_si256(diff, diff)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    SCANNER_TARGET_AVX2
+    const uint8_t* ScanAVX2(const uint8_t* begin, const uint8_t* end, const scanner::Pattern& pattern) {
+        const uint8_t* last = LastCandidate(begin, end, pattern);
+        if (!last) {
+            return nullptr;
+        }
+
+        const __m256i firstAnchor = _mm256_set1_epi8(static_cast<char>(pattern.bytes[pattern.anchor]));
+        const __m256i secondAnchor = _mm256_set1_epi8(static_cast<char>(pattern.bytes[pattern.secondAnchor]));
+
+        const uint8_t* blockLimit = begin + ((static_cast<size_t>(last - begin) + 1) & ~static_cast<size_t>(31));
+        const uint8_t* position = begin;
+        for (; position < blockLimit; position += 32) {
+            const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(position + pattern.anchor));
+            const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(position + pattern.secondAnchor));
+            uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, firstAnchor), _mm256_cmpeq_epi8(second, secondAnchor))));
+
+            while (candidates) {
+                const uint8_t* candidate = position + CountTrailingZeros(candidates);
+                if (VerifyAVX2(candidate, end, pattern)) {
+                    return candidate;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+
+        return ScanScalarRange(position, last, pattern);
+    }
+#endif
+
+    scanner::ScanBackend DetectBackend() {
+#if SCANNER_HAS_X64_SIMD
+        // SSE2 is part of the x64 baseline; only AVX2 needs a runtime check
+        return CpuSupportsAVX2() ? scanner::ScanBackend::AVX2 : scanner::ScanBackend::SSE2;
+#else
+        return scanner::ScanBackend::Scalar;
+#endif
+    }
+}
+
+bool scanner::CompilePattern(const char* text, Pattern& pattern) {
+    pattern = ParsePattern(text);
+    return pattern.valid;
+}
+
+bool scanner::MatchesAt(const uint8_t* position, const Pattern& pattern) {
+    for (size_t i = 0; i < pattern.length; i++) {
+        if ((position[i] ^ pattern.bytes[i]) & pattern.mask[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const uint8_t* scanner::ScanReference(const uint8_t* begin, const uint8_t* end, const Pattern& pattern) {
+    const uint8_t* last = LastCandidate(begin, end, pattern);
+    if (!last) {
+        return nullptr;
+    }
+
+    for (const uint8_t* position = begin; position <= last; position++) {
+        if (MatchesAt(position, pattern)) {
+            return position;
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* scanner::ScanWithBackend(ScanBackend backend, const uint8_t* begin, const uint8_t* end, const Pattern& pattern) {
+#if SCANNER_HAS_X64_SIMD
+    if (backend == ScanBackend::AVX2 && GetActiveBackend() == ScanBackend::AVX2) {
+        return ScanAVX2(begin, end, pattern);
+    }
+    if (backend == ScanBackend::SSE2 || backend == ScanBackend::AVX2) {
+        return ScanSSE2(begin, end, pattern);
+    }
+#endif
+    const uint8_t* last = LastCandidate(begin, end, pattern);
+    return last ? ScanScalarRange(begin, last, pattern) : nullptr;
+}
+
+const uint8_t* scanner::Scan(const uint8_t* begin, const uint8_t* end, const Pattern& pattern) {
+    return ScanWithBackend(GetActiveBackend(), begin, end, pattern);
+}
+
+scanner::ScanBackend scanner::GetActiveBackend() {
+    static const ScanBackend backend = DetectBackend();
+    return backend;
+}
+
+const char* scanner::BackendName(ScanBackend backend) {
+    switch (backend) {
+    case ScanBackend::AVX2: return "AVX2";
+    case ScanBackend::SSE2: return "SSE2";
+    default:                return "Scalar";
+    }
+}
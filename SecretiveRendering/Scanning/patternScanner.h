@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Vectorised wildcard signature scanner for the TF2 Steam overlay.
+// Patterns are compiled once into byte/mask arrays; the hot loop never touches pattern text.
+namespace scanner {
+    // Longest signature we accept. Keeps compiled patterns fixed-size and lets the
+    // verifier use whole 32-byte vector compares without bounds checks on the pattern side.
+    constexpr size_t MAX_PATTERN_LENGTH = 64;
+
+    /**
+     * @brief Signature compiled from text form ("48 8B ? 88 00 00 00 E8")
+     * mask[i] is 0xFF for a fixed byte and 0x00 for a wildcard. Both arrays are
+     * zero-padded up to MAX_PATTERN_LENGTH so padded lanes always compare equal.
+     */
+    struct Pattern {
+        alignas(32) uint8_t bytes[MAX_PATTERN_LENGTH];
+        alignas(32) uint8_t mask[MAX_PATTERN_LENGTH];
+        size_t length;          // Number of bytes (fixed + wildcard) in the signature
+        size_t anchor;          // Offset of the rarest fixed byte, used to find candidates
+        size_t secondAnchor;    // Offset of the next rarest fixed byte (== anchor if only one)
+        bool valid;
+    };
+
+    /**
+     * @brief Rough frequency rank of a byte value in x64 machine code (higher = more common)
+     * Used to pick anchor bytes that produce as few false candidates as possible.
+     */
+    constexpr uint8_t ByteCommonness(uint8_t value) {
+        switch (value) {
+        case 0x00: return 255;
+        case 0xFF: return 200;
+        case 0x48: return 190;
+        case 0xCC: return 180;
+        case 0x8B: return 170;
+        case 0x89: return 150;
+        case 0x24: return 140;
+        case 0x0F: return 130;
+        case 0x4C: return 120;
+        case 0x01: return 120;
+        case 0x44: return 110;
+        case 0x8D: return 110;
+        case 0xE8: return 100;
+        case 0xC0: return 100;
+        case 0x83: return 100;
+        case 0x85: return 90;
+        case 0x41: return 90;
+        case 0x08: return 90;
+        case 0x10: return 90;
+        case 0x20: return 90;
+        case 0x40: return 90;
+        case 0x49: return 80;
+        case 0x74: return 80;
+        case 0x02: return 80;
+        case 0x04: return 80;
+        case 0x75: return 70;
+        case 0x45: return 70;
+        case 0x33: return 70;
+        case 0xC3: return 60;
+        case 0x90: return 60;
+        case 0x80: return 60;
+        case 0x03: return 60;
+        case 0x5C: return 60;
+        case 0x30: return 60;
+        case 0x18: return 60;
+        case 0x28: return 60;
+        case 0xD2: return 50;
+        case 0x38: return 50;
+        case 0xC7: return 50;
+        case 0x05: return 50;
+        case 0x15: return 50;
+        case 0xEB: return 50;
+        case 0x84: return 50;
+        case 0x0D: return 40;
+        case 0xE9: return 40;
+        case 0xF8: return 40;
+        case 0x50: return 40;
+        case 0x4D: return 40;
+        case 0xC1: return 40;
+        case 0x3B: return 40;
+        case 0x39: return 40;
+        case 0x66: return 40;
+        case 0xFE: return 40;
+        default:   return 10;
+        }
+    }
+
+    namespace detail {
+        constexpr int HexValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 0xA;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 0xA;
+            return -1;
+        }
+    }
+
+    /**
+     * @brief Parse a text signature into a compiled pattern; usable in constant expressions
+     * Accepts hex byte pairs and "?" / "??" wildcards separated by spaces, and picks the two
+     * rarest fixed bytes as scan anchors. Signatures known at build time should go through
+     * DECLARE_SIGNATURE (see signature.h) so a malformed one fails to compile.
+     * @param text Pattern string (e.g., "48 8B ? 88 00 00 00 E8")
+     * @return Compiled pattern; valid is false if the text was malformed, too long or wildcard-only
+     */
+    constexpr Pattern ParsePattern(const char* text) {
+        Pattern pattern{};
+        if (!text) {
+            return pattern;
+        }
+
+        size_t length = 0;
+        const char* cursor = text;
+        while (*cursor) {
+            if (*cursor == ' ') {
+                cursor++;
+                continue;
+            }
+
+            if (length >= MAX_PATTERN_LENGTH) {
+                return Pattern{};
+            }
+
+            if (*cursor == '?') {
+                cursor += cursor[1] == '?' ? 2 : 1;
+                pattern.bytes[length] = 0;
+                pattern.mask[length] = 0;
+            }
+            else {
+                const int high = detail::HexValue(cursor[0]);
+                const int low = high < 0 ? -1 : detail::HexValue(cursor[1]);
+                if (low < 0) {
+                    return Pattern{};
+                }
+                pattern.bytes[length] = static_cast<uint8_t>(high << 4 | low);
+                pattern.mask[length] = 0xFF;
+                cursor += 2;
+            }
+
+            // Tokens must be separated by whitespace ("488B" or "4?" are typos, not patterns)
+            if (*cursor && *cursor != ' ') {
+                return Pattern{};
+            }
+            length++;
+        }
+
+        // Pick the two rarest fixed bytes as anchors
+        size_t anchor = MAX_PATTERN_LENGTH;
+        size_t secondAnchor = MAX_PATTERN_LENGTH;
+        for (size_t i = 0; i < length; i++) {
+            if (!pattern.mask[i]) {
+                continue;
+            }
+            if (anchor == MAX_PATTERN_LENGTH || ByteCommonness(pattern.bytes[i]) < ByteCommonness(pattern.bytes[anchor])) {
+                secondAnchor = anchor;
+                anchor = i;
+            }
+            else if (secondAnchor == MAX_PATTERN_LENGTH || ByteCommonness(pattern.bytes[i]) < ByteCommonness(pattern.bytes[secondAnchor])) {
+                secondAnchor = i;
+            }
+        }
+
+        if (anchor == MAX_PATTERN_LENGTH) {
+            return Pattern{}; // Wildcard-only patterns match everywhere and are always a mistake
+        }
+
+        pattern.length = length;
+        pattern.anchor = anchor;
+        pattern.secondAnchor = secondAnchor == MAX_PATTERN_LENGTH ? anchor : secondAnchor;
+        pattern.valid = true;
+        return pattern;
+    }
+
+    /**
+     * @brief Available scan implementations, selected once at runtime from CPUID
+     */
+    enum class ScanBackend {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @brief Compile a text signature at runtime into byte/mask arrays (see ParsePattern)
+     * @param text Pattern string (e.g., "48 8B ? 88 00 00 00 E8")
+     * @param pattern Receives the compiled pattern; pattern.valid mirrors the return value
+     * @return true if the text was well-formed and contains at least one fixed byte
+     */
+    bool CompilePattern(const char* text, Pattern& pattern);
+
+    /**
+     * @brief Check a single position against a compiled pattern
+     * @param position First byte of the candidate match; [position, position + length) must be readable
+     * @param pattern Compiled pattern
+     * @return true if every fixed byte matches
+     */
+    bool MatchesAt(const uint8_t* position, const Pattern& pattern);
+
+    /**
+     * @brief Straightforward byte-by-byte scanner used as the correctness reference
+     * @return First match in [begin, end), or nullptr if not found
+     */
+    const uint8_t* ScanReference(const uint8_t* begin, const uint8_t* end, const Pattern& pattern);
+
+    /**
+     * @brief Scan with an explicit backend (AVX2 falls back to SSE2 if the CPU lacks it; SSE2 is x64 baseline)
+     * @return First match in [begin, end), or nullptr if not found
+     */
+    const uint8_t* ScanWithBackend(ScanBackend backend, const uint8_t* begin, const uint8_t* end, const Pattern& pattern);
+
+    /**
+     * @brief Scan with the fastest backend supported by the running CPU
+     * @return First match in [begin, end), or nullptr if not found
+     */
+    const uint8_t* Scan(const uint8_t* begin, const uint8_t* end, const Pattern& pattern);
+
+    /**
+     * @brief Backend chosen by Scan() on this machine
+     */
+    ScanBackend GetActiveBackend();
+
+    /**
+     * @brief Human readable backend name for logging
+     */
+    const char* BackendName(ScanBackend backend);
+}
@@ -0,0 +1,145 @@
+#include "peImage.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr uint16_t DOS_SIGNATURE = 0x5A4D;          // "MZ"
+    constexpr uint32_t NT_SIGNATURE = 0x00004550;       // "PE\0\0"
+    constexpr uint16_t OPTIONAL_MAGIC_PE32 = 0x10B;
+    constexpr uint16_t OPTIONAL_MAGIC_PE32_PLUS = 0x20B;
+    constexpr size_t FILE_HEADER_SIZE = 20;
+    constexpr size_t SECTION_HEADER_SIZE = 40;
+    constexpr uint16_t MAX_SECTIONS = 96;               // Loader limit
+
+    // Unaligned little-endian reads; every caller bounds-checks first
+    uint16_t Read16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | p[1] << 8); }
+    uint32_t Read32(const uint8_t* p) { return static_cast<uint32_t>(Read16(p)) | static_cast<uint32_t>(Read16(p + 2)) << 16; }
+    uint64_t Read64(const uint8_t* p) { return static_cast<uint64_t>(Read32(p)) | static_cast<uint64_t>(Read32(p + 4)) << 32; }
+
+    bool InBounds(size_t size, size_t offset, size_t length) {
+        return offset <= size && length <= size - offset;
+    }
+}
+
+bool pe::ParseImage(const uint8_t* data, size_t size, ImageInfo& info) {
+    info = ImageInfo();
+    if (!data || !InBounds(size, 0, 0x40) || Read16(data) != DOS_SIGNATURE) {
+        return false;
+    }
+
+    const size_t ntOffset = Read32(data + 0x3C);
+    if (!InBounds(size, ntOffset, 4 + FILE_HEADER_SIZE) || Read32(data + ntOffset) != NT_SIGNATURE) {
+        return false;
+    }
+
+    const uint8_t* fileHeader = data + ntOffset + 4;
+    const uint16_t sectionCount = Read16(fileHeader + 2);
+    const uint16_t optionalSize = Read16(fileHeader + 16);
+    if (sectionCount > MAX_SECTIONS) {
+        return false;
+    }
+
+    const size_t optionalOffset = ntOffset + 4 + FILE_HEADER_SIZE;
+    if (optionalSize < 64 || !InBounds(size, optionalOffset, optionalSize)) {
+        return false;
+    }
+
+    const uint8_t* optional = data + optionalOffset;
+    const uint16_t magic = Read16(optional);
+    if (magic != OPTIONAL_MAGIC_PE32 && magic != OPTIONAL_MAGIC_PE32_PLUS) {
+        return false;
+    }
+
+    info.is64Bit = magic == OPTIONAL_MAGIC_PE32_PLUS;
+    info.machine = Read16(fileHeader);
+    info.timeDateStamp = Read32(fileHeader + 4);
+    info.entryPoint = Read32(optional + 16);
+    info.imageBase = info.is64Bit ? Read64(optional + 24) : Read32(optional + 28);
+    info.sizeOfImage = Read32(optional + 56);
+    info.sizeOfHeaders = Read32(optional + 60);
+
+    const size_t sectionTable = optionalOffset + optionalSize;
+    if (!InBounds(size, sectionTable, static_cast<size_t>(sectionCount) * SECTION_HEADER_SIZE)) {
+        return false;
+    }
+
+    info.sections.reserve(sectionCount);
+    for (uint16_t i = 0; i < sectionCount; i++) {
+        const uint8_t* header = data + sectionTable + static_cast<size_t>(i) * SECTION_HEADER_SIZE;
+
+        Section section;
+        memcpy(section.name, header, 8);
+        section.name[8] = '\0';
+        section.virtualSize = Read32(header + 8);
+        section.virtualAddress = Read32(header + 12);
+        section.rawSize = Read32(header + 16);
+        section.rawOffset = Read32(header + 20);
+        section.characteristics = Read32(header + 36);
+        info.sections.push_back(section);
+    }
+
+    return true;
+}
+
+uint32_t pe::SectionTarget(const Section& section) {
+    const uint32_t flags = section.characteristics;
+    if (flags & SECTION_MEM_DISCARDABLE) {
+        return 0; // .reloc and friends
+    }
+    if (flags & (SECTION_CNT_CODE | SECTION_MEM_EXECUTE)) {
+        return TARGET_CODE;
+    }
+    if (flags & SECTION_MEM_WRITE) {
+        return TARGET_WRITABLE_DATA;
+    }
+    if (flags & SECTION_CNT_INITIALIZED_DATA) {
+        return TARGET_READONLY_DATA;
+    }
+    return 0;
+}
+
+uint32_t pe::MappedSize(const Section& section) {
+    return section.virtualSize ? section.virtualSize : section.rawSize;
+}
+
+std::vector<pe::RvaRange> pe::SectionRanges(const ImageInfo& info, uint32_t targets) {
+    std::vector<RvaRange> ranges;
+    for (const Section& section : info.sections) {
+        if (!(SectionTarget(section) & targets)) {
+            continue;
+        }
+
+        const uint64_t begin = section.virtualAddress;
+        uint64_t end = begin + MappedSize(section);
+        if (end > info.sizeOfImage) {
+            end = info.sizeOfImage;
+        }
+        if (begin < end) {
+            ranges.push_back({ static_cast<uint32_t>(begin), static_cast<uint32_t>(end) });
+        }
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](const RvaRange& a, const RvaRange& b) { return a.begin < b.begin; });
+
+    // Merge touching/overlapping sections so matches spanning them are not lost
+    std::vector<RvaRange> merged;
+    for (const RvaRange& range : ranges) {
+        if (!merged.empty() && range.begin <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, range.end);
+        }
+        else {
+            merged.push_back(range);
+        }
+    }
+    return merged;
+}
+
+const pe::Section* pe::FindSection(const ImageInfo& info, uint32_t rva) {
+    for (const Section& section : info.sections) {
+        if (rva >= section.virtualAddress && rva - section.virtualAddress < MappedSize(section)) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
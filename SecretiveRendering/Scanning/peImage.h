@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minimal PE/PE32+ header parser.
+// Pure functions over a byte buffer: no windows.h, no loader calls, so the same code reads a
+// module loaded in the game process or a DLL read from disk. Headers are identical in file and
+// mapped layout, so either kind of buffer can be parsed.
+namespace pe {
+    // Section characteristics (same values as IMAGE_SCN_*)
+    constexpr uint32_t SECTION_CNT_CODE = 0x00000020;
+    constexpr uint32_t SECTION_CNT_INITIALIZED_DATA = 0x00000040;
+    constexpr uint32_t SECTION_CNT_UNINITIALIZED_DATA = 0x00000080;
+    constexpr uint32_t SECTION_MEM_DISCARDABLE = 0x02000000;
+    constexpr uint32_t SECTION_MEM_EXECUTE = 0x20000000;
+    constexpr uint32_t SECTION_MEM_READ = 0x40000000;
+    constexpr uint32_t SECTION_MEM_WRITE = 0x80000000;
+
+    // Which kinds of section a signature may match in (bit flags)
+    constexpr uint32_t TARGET_CODE = 1u << 0;           // Executable sections (.text, ...)
+    constexpr uint32_t TARGET_READONLY_DATA = 1u << 1;  // Initialized, non-writable data (.rdata, ...)
+    constexpr uint32_t TARGET_WRITABLE_DATA = 1u << 2;  // Writable data (.data, ...)
+    constexpr uint32_t TARGET_ALL = TARGET_CODE | TARGET_READONLY_DATA | TARGET_WRITABLE_DATA;
+
+    struct Section {
+        char name[9];               // NUL-terminated copy of the 8-byte section name
+        uint32_t virtualAddress;    // RVA of the section once mapped
+        uint32_t virtualSize;
+        uint32_t rawOffset;         // File offset of the section data
+        uint32_t rawSize;
+        uint32_t characteristics;
+    };
+
+    struct ImageInfo {
+        bool is64Bit = false;
+        uint16_t machine = 0;
+        uint32_t timeDateStamp = 0;
+        uint32_t sizeOfImage = 0;
+        uint32_t sizeOfHeaders = 0;
+        uint32_t entryPoint = 0;
+        uint64_t imageBase = 0;
+        std::vector<Section> sections;
+    };
+
+    /**
+     * @brief RVA range [begin, end) inside a mapped image
+     */
+    struct RvaRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    /**
+     * @brief Parse DOS/NT headers and the section table
+     * @param data Start of the image (module base or file contents)
+     * @param size Number of readable bytes at data
+     * @param info Receives the parsed headers
+     * @return false if the buffer is not a well-formed PE image
+     */
+    bool ParseImage(const uint8_t* data, size_t size, ImageInfo& info);
+
+    /**
+     * @brief Classify a section into one of the TARGET_* kinds (0 for discardable/bss sections)
+     */
+    uint32_t SectionTarget(const Section& section);
+
+    /**
+     * @brief Size of a section once mapped (VirtualSize, or SizeOfRawData if the linker left it 0)
+     */
+    uint32_t MappedSize(const Section& section);
+
+    /**
+     * @brief Mapped RVA ranges of all sections matching a target mask, sorted and merged
+     * @param info Parsed image
+     * @param targets Combination of TARGET_* flags
+     */
+    std::vector<RvaRange> SectionRanges(const ImageInfo& info, uint32_t targets);
+
+    /**
+     * @brief Section containing an RVA, or nullptr
+     */
+    const Section* FindSection(const ImageInfo& info, uint32_t rva);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include "patternScanner.h"
+#include "peImage.h"
+
+// Signatures known at build time.
+// DECLARE_SIGNATURE parses the text while compiling, so the scanner only ever sees the finished
+// byte/mask arrays and anchors, and a typo in a signature is a build error instead of a
+// "Pattern not found" at runtime.
+namespace scanner {
+    /**
+     * @brief Named signature compiled at build time
+     */
+    struct Signature {
+        const char* name;   // Used for logging and as the signature cache key
+        const char* text;   // Original text form (hashed to detect edited signatures)
+        Pattern pattern;
+        uint32_t sections;  // pe::TARGET_* kinds of section the signature may match in
+    };
+}
+
+/**
+ * @brief Declare an inline constexpr scanner::Signature and reject malformed text at compile time
+ * @param identifier Variable name
+ * @param name Signature name used for logging/caching
+ * @param text Pattern string (e.g., "48 8B ? 88 00 00 00 E8")
+ * @param sections pe::TARGET_* mask
+ */
+#define DECLARE_SIGNATURE_IN(identifier, name, text, sections) \
+    inline constexpr ::scanner::Signature identifier = { name, text, ::scanner::ParsePattern(text), sections }; \
+    static_assert(identifier.pattern.valid, "Malformed signature " #identifier ": \"" text "\"")
+
+/**
+ * @brief DECLARE_SIGNATURE_IN restricted to code sections (the usual case)
+ */
+#define DECLARE_SIGNATURE(identifier, name, text) DECLARE_SIGNATURE_IN(identifier, name, text, ::pe::TARGET_CODE)
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "signatureCache.h"
+#include "peImage.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    constexpr const char* CACHE_MAGIC = "TF2SR-SIGCACHE";
+    constexpr int CACHE_VERSION = 1;
+    constexpr size_t HEADER_READ_SIZE = 64 * 1024;  // Generous upper bound for DOS + NT headers and section table
+
+    constexpr uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+    inline uint64_t Mix(uint64_t hash, uint64_t value) {
+        hash = (hash ^ value) * HASH_MULTIPLIER;
+        return hash ^ (hash >> 32);
+    }
+
+    /**
+     * @brief Chain the hash of every code section's raw bytes, in section-table order
+     * @param readSection Callback reading one section's raw bytes; returns false on failure
+     */
+    template<typename ReadSection>
+    bool HashCodeSections(const pe::ImageInfo& info, uint64_t& hash, ReadSection&& readSection) {
+        hash = 0;
+        bool sawCode = false;
+        for (const pe::Section& section : info.sections) {
+            if (!(pe::SectionTarget(section) & pe::TARGET_CODE) || !section.rawSize) {
+                continue;
+            }
+            if (!readSection(section, hash)) {
+                return false;
+            }
+            sawCode = true;
+        }
+        return sawCode;
+    }
+}
+
+uint64_t scanner::HashBytes(const uint8_t* data, size_t size, uint64_t seed) {
+    uint64_t hash = Mix(seed, size);
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        memcpy(&word, data + offset, sizeof(word));
+        hash = Mix(hash, word);
+    }
+
+    uint64_t tail = 0;
+    for (size_t shift = 0; offset < size; offset++, shift += 8) {
+        tail |= static_cast<uint64_t>(data[offset]) << shift;
+    }
+    return Mix(hash, tail);
+}
+
+uint64_t scanner::HashPattern(const char* text) {
+    return text ? HashBytes(reinterpret_cast<const uint8_t*>(text), strlen(text)) : 0;
+}
+
+bool scanner::ComputeImageIdentity(const uint8_t* fileData, size_t size, ModuleIdentity& identity) {
+    pe::ImageInfo info;
+    if (!pe::ParseImage(fileData, size, info)) {
+        return false;
+    }
+
+    identity.timeDateStamp = info.timeDateStamp;
+    identity.sizeOfImage = info.sizeOfImage;
+    return HashCodeSections(info, identity.codeHash, [&](const pe::Section& section, uint64_t& hash) {
+        if (section.rawOffset > size || section.rawSize > size - section.rawOffset) {
+            return false;
+        }
+        hash = HashBytes(fileData + section.rawOffset, section.rawSize, hash);
+        return true;
+    });
+}
+
+bool scanner::ComputeFileIdentity(const char* path, ModuleIdentity& identity) {
+    if (!path) {
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<uint8_t> headers(HEADER_READ_SIZE);
+    file.read(reinterpret_cast<char*>(headers.data()), static_cast<std::streamsize>(headers.size()));
+    headers.resize(static_cast<size_t>(file.gcount()));
+    file.clear();
+
+    pe::ImageInfo info;
+    if (!pe::ParseImage(headers.data(), headers.size(), info)) {
+        return false;
+    }
+
+    identity.timeDateStamp = info.timeDateStamp;
+    identity.sizeOfImage = info.sizeOfImage;
+
+    std::vector<uint8_t> buffer;
+    return HashCodeSections(info, identity.codeHash, [&](const pe::Section& section, uint64_t& hash) {
+        buffer.resize(section.rawSize);
+        file.seekg(section.rawOffset);
+        file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (static_cast<size_t>(file.gcount()) != buffer.size()) {
+            return false;
+        }
+        hash = HashBytes(buffer.data(), buffer.size(), hash);
+        return true;
+    });
+}
+
+bool scanner::SignatureCache::Load(const std::string& path, const ModuleIdentity& current) {
+    identity = current;
+    entries.clear();
+
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string magic;
+    int version = 0;
+    if (!(file >> magic >> version) || magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        return false;
+    }
+
+    std::string tag;
+    ModuleIdentity stored;
+    if (!(file >> tag >> std::hex >> stored.timeDateStamp >> stored.sizeOfImage >> stored.codeHash) || tag != "module") {
+        return false;
+    }
+
+    // Overlay was updated (or the file belongs to another build): start over
+    if (stored != current) {
+        return false;
+    }
+
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        CachedSignature entry;
+        if (!(fields >> tag >> entry.name) || tag != "sig") {
+            continue;
+        }
+        if (fields >> std::hex >> entry.patternHash >> entry.patternRva >> std::dec >> entry.instructionOffset >> std::hex >> entry.functionRva) {
+            Store(entry);
+        }
+    }
+    return true;
+}
+
+bool scanner::SignatureCache::Save(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    file << CACHE_MAGIC << ' ' << CACHE_VERSION << '\n';
+    file << "module " << std::hex << identity.timeDateStamp << ' ' << identity.sizeOfImage << ' ' << identity.codeHash << '\n';
+    for (const CachedSignature& entry : entries) {
+        file << "sig " << entry.name << ' ' << std::hex << entry.patternHash << ' ' << entry.patternRva << ' '
+             << std::dec << entry.instructionOffset << ' ' << std::hex << entry.functionRva << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+const scanner::CachedSignature* scanner::SignatureCache::Find(const char* name, uint64_t patternHash) const {
+    for (const CachedSignature& entry : entries) {
+        if (name && entry.name == name) {
+            return entry.patternHash == patternHash ? &entry : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+void scanner::SignatureCache::Store(const CachedSignature& entry) {
+    for (CachedSignature& existing : entries) {
+        if (existing.name == entry.name) {
+            existing = entry;
+            return;
+        }
+    }
+    entries.push_back(entry);
+}
+
+void scanner::SignatureCache::Remove(const char* name) {
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (name && it->name == name) {
+            entries.erase(it);
+            return;
+        }
+    }
+}
\ No newline at end of file
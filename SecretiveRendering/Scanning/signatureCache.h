@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Persistent cache of resolved signatures, keyed by the build identity of the scanned module.
+// The identity comes from the PE file on disk (TimeDateStamp, SizeOfImage and a hash of the raw
+// code sections), so it does not change with ASLR relocations and changes whenever Steam ships
+// a new overlay build. A mismatching identity discards every cached entry.
+namespace scanner {
+    struct ModuleIdentity {
+        uint32_t timeDateStamp = 0;
+        uint32_t sizeOfImage = 0;
+        uint64_t codeHash = 0;
+
+        bool operator==(const ModuleIdentity& other) const {
+            return timeDateStamp == other.timeDateStamp && sizeOfImage == other.sizeOfImage && codeHash == other.codeHash;
+        }
+        bool operator!=(const ModuleIdentity& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief One resolved signature, stored as RVAs so it survives relocation
+     */
+    struct CachedSignature {
+        std::string name;
+        uint64_t patternHash = 0;       // HashPattern() of the signature text, so edited signatures miss
+        uint32_t patternRva = 0;        // Where the signature matched
+        int32_t instructionOffset = 0;  // Offset from the match to the instruction holding the reference
+        uint32_t functionRva = 0;       // Resolved target
+    };
+
+    /**
+     * @brief Fast non-cryptographic 64-bit hash (8 bytes per step)
+     * @param seed Previous hash when hashing data in pieces
+     */
+    uint64_t HashBytes(const uint8_t* data, size_t size, uint64_t seed = 0);
+
+    /**
+     * @brief Hash of a signature's text form
+     */
+    uint64_t HashPattern(const char* text);
+
+    /**
+     * @brief Identity of a PE file held in memory (file layout, not mapped)
+     * @return false if the buffer is not a PE image
+     */
+    bool ComputeImageIdentity(const uint8_t* fileData, size_t size, ModuleIdentity& identity);
+
+    /**
+     * @brief Identity of a PE file on disk; only the headers and code sections are read
+     * @return false if the file cannot be read or is not a PE image
+     */
+    bool ComputeFileIdentity(const char* path, ModuleIdentity& identity);
+
+    class SignatureCache {
+    public:
+        /**
+         * @brief Load cached entries for a module build
+         * @param path Cache file path
+         * @param identity Identity of the module currently loaded
+         * @return true if the file exists and was written for this exact build; otherwise the
+         *         cache starts empty for the new identity
+         */
+        bool Load(const std::string& path, const ModuleIdentity& identity);
+
+        /**
+         * @brief Write the identity and all entries, replacing the file
+         */
+        bool Save(const std::string& path) const;
+
+        /**
+         * @brief Entry for a signature, or nullptr if missing or recorded for different signature text
+         */
+        const CachedSignature* Find(const char* name, uint64_t patternHash) const;
+
+        /**
+         * @brief Add or replace the entry for entry.name
+         */
+        void Store(const CachedSignature& entry);
+
+        /**
+         * @brief Drop the entry for a signature (e.g., when its cached site failed validation)
+         */
+        void Remove(const char* name);
+
+        const ModuleIdentity& Identity() const { return identity; }
+        size_t Size() const { return entries.size(); }
+
+    private:
+        ModuleIdentity identity;
+        std::vector<CachedSignature> entries;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "x64Decoder.h"
+
+namespace {
+    constexpr size_t MAX_PREFIXES = 4;
+
+    bool IsLegacyPrefix(uint8_t value) {
+        switch (value) {
+        case 0x66: case 0x67: case 0xF0: case 0xF2: case 0xF3:
+        case 0x26: case 0x2E: case 0x36: case 0x3E: case 0x64: case 0x65:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool IsRex(uint8_t value) {
+        return (value & 0xF0) == 0x40;
+    }
+
+    /**
+     * @brief Operand layout of the supported opcodes
+     */
+    struct OpcodeInfo {
+        bool supported;
+        bool hasModRM;
+        uint8_t immediate;  // Immediate size in bytes (REX.W widening handled by the caller)
+    };
+
+    OpcodeInfo LookupOpcode(uint8_t opcode) {
+        switch (opcode) {
+        // ALU r/m, r and r, r/m forms (add/or/and/sub/xor/cmp), test, mov, lea
+        case 0x01: case 0x03: case 0x09: case 0x0B: case 0x21: case 0x23:
+        case 0x29: case 0x2B: case 0x31: case 0x33: case 0x39: case 0x3B:
+        case 0x84: case 0x85: case 0x88: case 0x89: case 0x8A: case 0x8B: case 0x8D:
+        case 0x63: case 0xD1:
+            return { true, true, 0 };
+        // Byte ALU / shift r/m, imm8
+        case 0x80: case 0x83: case 0xC0: case 0xC1: case 0xC6:
+            return { true, true, 1 };
+        case 0x81: case 0xC7:
+            return { true, true, 4 };
+        case 0xFF:
+            return { true, true, 0 };
+        case 0xE8: case 0xE9:
+            return { true, false, 4 };
+        // jmp rel8, cmp/test al, imm8
+        case 0xEB: case 0x3C: case 0xA8:
+            return { true, false, 1 };
+        // cmp/test eax, imm32
+        case 0x3D: case 0xA9:
+            return { true, false, 4 };
+        default:
+            break;
+        }
+
+        // jcc rel8
+        if (opcode >= 0x70 && opcode <= 0x7F) {
+            return { true, false, 1 };
+        }
+
+        // push/pop r64, nop, ret, int3
+        if ((opcode >= 0x50 && opcode <= 0x5F) || opcode == 0x90 || opcode == 0xC3 || opcode == 0xCC) {
+            return { true, false, 0 };
+        }
+        // mov r, imm32 (imm64 with REX.W)
+        if (opcode >= 0xB8 && opcode <= 0xBF) {
+            return { true, false, 4 };
+        }
+        return { false, false, 0 };
+    }
+
+    OpcodeInfo LookupEscapedOpcode(uint8_t opcode) {
+        // jcc rel32
+        if (opcode >= 0x80 && opcode <= 0x8F) {
+            return { true, false, 4 };
+        }
+        // cmovcc, setcc, imul r, r/m, movzx/movsx
+        if ((opcode >= 0x40 && opcode <= 0x4F) || (opcode >= 0x90 && opcode <= 0x9F) ||
+            opcode == 0xAF || opcode == 0xB6 || opcode == 0xB7 || opcode == 0xBE || opcode == 0xBF) {
+            return { true, true, 0 };
+        }
+        return { false, false, 0 };
+    }
+
+    int32_t ReadInt32(const uint8_t* p) {
+        return static_cast<int32_t>(static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+            static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24);
+    }
+}
+
+bool x64::Decode(const uint8_t* code, size_t available, Instruction& instruction) {
+    instruction = Instruction();
+    if (!code || !available) {
+        return false;
+    }
+    if (available > MAX_INSTRUCTION_LENGTH) {
+        available = MAX_INSTRUCTION_LENGTH;
+    }
+
+    size_t position = 0;
+    bool operandSizePrefix = false;
+    while (position < available && IsLegacyPrefix(code[position])) {
+        operandSizePrefix |= code[position] == 0x66;
+        if (++position > MAX_PREFIXES) {
+            return false;
+        }
+    }
+
+    // REX must immediately precede the opcode
+    if (position < available && IsRex(code[position])) {
+        instruction.rex = code[position++];
+    }
+    if (position >= available) {
+        return false;
+    }
+
+    uint8_t opcode = code[position++];
+    if (opcode == 0x0F) {
+        if (position >= available) {
+            return false;
+        }
+        instruction.escaped = true;
+        opcode = code[position++];
+    }
+    const OpcodeInfo info = instruction.escaped ? LookupEscapedOpcode(opcode) : LookupOpcode(opcode);
+    if (!info.supported) {
+        return false;
+    }
+    instruction.opcode = opcode;
+    const bool oneByte = !instruction.escaped;
+
+    bool ripRelative = false;
+    size_t displacementOffset = 0;
+    if (info.hasModRM) {
+        if (position >= available) {
+            return false;
+        }
+        const uint8_t modrm = code[position++];
+        const uint8_t mod = modrm >> 6;
+        const uint8_t reg = (modrm >> 3) & 7;
+        const uint8_t rm = modrm & 7;
+        instruction.reg = static_cast<uint8_t>(reg | (instruction.rex & 0x04 ? 8 : 0));
+
+        if (oneByte && opcode == 0x8D && mod == 3) {
+            return false; // lea needs a memory operand
+        }
+        if (oneByte && opcode == 0xFF && (reg == 3 || reg == 5 || reg == 7)) {
+            return false; // far call/jmp and undefined encodings
+        }
+
+        size_t displacementSize = 0;
+        if (mod != 3) {
+            if (rm == 4) {
+                if (position >= available) {
+                    return false;
+                }
+                const uint8_t sib = code[position++];
+                if (mod == 0 && (sib & 7) == 5) {
+                    displacementSize = 4;
+                }
+            }
+            else if (mod == 0 && rm == 5) {
+                ripRelative = true;
+                displacementSize = 4;
+            }
+
+            if (mod == 1) {
+                displacementSize = 1;
+            }
+            else if (mod == 2) {
+                displacementSize = 4;
+            }
+        }
+
+        displacementOffset = position;
+        position += displacementSize;
+    }
+
+    size_t immediateSize = info.immediate;
+    if (!oneByte) {
+        if (operandSizePrefix && opcode >= 0x80 && opcode <= 0x8F) {
+            return false; // rel16 branches are not used in 64-bit code
+        }
+    }
+    else if (opcode >= 0xB8 && opcode <= 0xBF && (instruction.rex & 0x08)) {
+        immediateSize = 8;
+    }
+    else if (operandSizePrefix && (opcode == 0x81 || opcode == 0xC7 || opcode == 0x3D || opcode == 0xA9 ||
+        (opcode >= 0xB8 && opcode <= 0xBF))) {
+        immediateSize = 2;
+    }
+    else if (operandSizePrefix && (opcode == 0xE8 || opcode == 0xE9)) {
+        return false; // rel16 branches are not used in 64-bit code
+    }
+
+    const size_t immediateOffset = position;
+    position += immediateSize;
+    if (position > available) {
+        return false;
+    }
+    instruction.length = static_cast<uint8_t>(position);
+
+    if (!oneByte) {
+        instruction.kind = 0;   // jcc rel32 and RIP-relative movzx/cmov/... are stepped over
+    }
+    else if (opcode == 0xE8 || opcode == 0xE9) {
+        instruction.kind = opcode == 0xE8 ? REFERENCE_CALL : REFERENCE_JMP;
+        instruction.displacement = ReadInt32(code + immediateOffset);
+    }
+    else if (ripRelative) {
+        instruction.displacement = ReadInt32(code + displacementOffset);
+        switch (opcode) {
+        case 0x8D:
+            instruction.kind = REFERENCE_LEA;
+            break;
+        case 0x88: case 0x89: case 0x8A: case 0x8B:
+            instruction.kind = REFERENCE_MOV;
+            break;
+        case 0xFF:
+            instruction.kind = (instruction.reg & 7) == 2 || (instruction.reg & 7) == 4 ? REFERENCE_INDIRECT : 0;
+            break;
+        default:
+            instruction.kind = 0;   // Other RIP-relative data accesses (cmp [rip+x], ...) are stepped over
+            break;
+        }
+    }
+    return true;
+}
+
+bool x64::ProbeReferenceBefore(const uint8_t* hit, const uint8_t* lowerBound, uint32_t kinds, Reference& reference) {
+    reference = Reference();
+    if (!hit || !lowerBound || lowerBound > hit) {
+        return false;
+    }
+
+    // Nearest end first, longest decoding first, so a REX prefix is never cut off its instruction
+    for (size_t gap = 0; gap < MAX_LOOKBEHIND; gap++) {
+        const uint8_t* end = hit - gap;
+        for (size_t length = MAX_INSTRUCTION_LENGTH; length >= 1; length--) {
+            const size_t distance = gap + length;
+            if (distance > MAX_LOOKBEHIND || distance > static_cast<size_t>(hit - lowerBound)) {
+                continue;
+            }
+
+            Instruction candidate;
+            if (!Decode(end - length, length, candidate) || candidate.length != length || !(candidate.kind & kinds)) {
+                continue;
+            }
+
+            reference.offset = -static_cast<int32_t>(distance);
+            reference.instruction = candidate;
+            reference.target = TargetOf(reinterpret_cast<uintptr_t>(end - length), candidate);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool x64::FindReferenceBefore(const uint8_t* hit, const uint8_t* lowerBound, uint32_t kinds, Reference& reference) {
+    reference = Reference();
+    if (!hit || !lowerBound || lowerBound > hit) {
+        return false;
+    }
+
+    const uint8_t* end = hit;
+    for (size_t step = 0; step < MAX_WALK_INSTRUCTIONS; step++) {
+        // Longest decoding ending exactly at 'end'; a reference of a wanted kind beats any other decoding
+        const uint8_t* bestStart = nullptr;
+        Instruction best;
+        for (size_t length = MAX_INSTRUCTION_LENGTH; length >= 1; length--) {
+            if (static_cast<size_t>(end - lowerBound) < length || static_cast<size_t>(hit - (end - length)) > MAX_LOOKBEHIND) {
+                continue;
+            }
+
+            Instruction candidate;
+            if (!Decode(end - length, length, candidate) || candidate.length != length) {
+                continue;
+            }
+
+            const bool wanted = (candidate.kind & kinds) != 0;
+            if (!bestStart || (wanted && !(best.kind & kinds))) {
+                bestStart = end - length;
+                best = candidate;
+                if (wanted) {
+                    break;
+                }
+            }
+        }
+
+        if (!bestStart) {
+            // Code the decoder does not know; fall back to probing for the reference at fixed offsets
+            return ProbeReferenceBefore(hit, lowerBound, kinds, reference);
+        }
+
+        if (best.kind & kinds) {
+            reference.offset = static_cast<int32_t>(bestStart - hit);
+            reference.instruction = best;
+            reference.target = TargetOf(reinterpret_cast<uintptr_t>(bestStart), best);
+            return true;
+        }
+        end = bestStart;
+    }
+    return false;
+}
\ No newline at end of file
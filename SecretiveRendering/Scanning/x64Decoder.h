@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Minimal x64 decoder for the instructions signatures resolve through.
+// Decodes legacy prefixes, REX, ModRM/SIB and displacements for LEA, MOV r/m, CALL/JMP rel32
+// and CALL/JMP [mem] with any register and REX prefix, and reports the RIP-relative target.
+// The common ALU, shift, jcc, setcc, cmovcc and movzx/movsx forms are decoded so the backward
+// walk can step over them. Everything else is reported as undecodable; this is not a general
+// disassembler.
+namespace x64 {
+    constexpr size_t MAX_INSTRUCTION_LENGTH = 15;
+
+    // Kinds of reference an instruction can carry (bit flags, combined to filter a search)
+    constexpr uint32_t REFERENCE_LEA = 1u << 0;          // lea r, [rip+disp32]      -> effective address
+    constexpr uint32_t REFERENCE_MOV = 1u << 1;          // mov r, [rip+disp32] / mov [rip+disp32], r -> memory slot
+    constexpr uint32_t REFERENCE_CALL = 1u << 2;         // call rel32               -> branch target
+    constexpr uint32_t REFERENCE_JMP = 1u << 3;          // jmp rel32                -> branch target
+    constexpr uint32_t REFERENCE_INDIRECT = 1u << 4;     // call/jmp [rip+disp32]    -> pointer slot
+    constexpr uint32_t REFERENCE_ANY = REFERENCE_LEA | REFERENCE_MOV | REFERENCE_CALL | REFERENCE_JMP | REFERENCE_INDIRECT;
+
+    /**
+     * @brief One decoded instruction
+     */
+    struct Instruction {
+        uint8_t length = 0;         // 0 if the bytes are not a supported instruction
+        uint8_t opcode = 0;         // Opcode byte (the one after 0F when escaped)
+        bool escaped = false;       // Two-byte opcode (0F xx)
+        uint8_t rex = 0;            // REX byte, or 0
+        uint8_t reg = 0;            // ModRM.reg extended by REX.R (register operand)
+        uint32_t kind = 0;          // One REFERENCE_* flag, or 0 if the instruction has no RIP-relative target
+        int32_t displacement = 0;   // disp32 / rel32 the target is computed from
+    };
+
+    /**
+     * @brief Decode one instruction
+     * @param code First byte of the instruction
+     * @param available Readable bytes at code (decoding never reads past them)
+     * @param instruction Receives the decoded instruction
+     * @return true if the bytes form a supported, complete instruction
+     */
+    bool Decode(const uint8_t* code, size_t available, Instruction& instruction);
+
+    /**
+     * @brief Absolute target of a decoded reference (next instruction + displacement)
+     * @param address Address the instruction was decoded from
+     */
+    inline uintptr_t TargetOf(uintptr_t address, const Instruction& instruction) {
+        return address + instruction.length + static_cast<intptr_t>(instruction.displacement);
+    }
+
+    /**
+     * @brief RIP-relative reference found before a signature hit
+     */
+    struct Reference {
+        int32_t offset = 0;         // Instruction start relative to the hit (negative)
+        Instruction instruction;
+        uintptr_t target = 0;
+    };
+
+    // How far back from a hit references are searched, and how many instructions are stepped over
+    constexpr size_t MAX_LOOKBEHIND = 24;
+    constexpr size_t MAX_WALK_INSTRUCTIONS = 3;
+
+    /**
+     * @brief Walk backwards from a hit, instruction by instruction, to the nearest reference of a wanted kind
+     * At each step the decoding that ends exactly where the previous one started is taken (longest
+     * first); the walk stops at the first reference whose kind is in kinds, at an undecodable
+     * byte sequence, or after MAX_WALK_INSTRUCTIONS / MAX_LOOKBEHIND bytes. No memory is queried.
+     * If it stops at an undecodable sequence, ProbeReferenceBefore is tried instead.
+     * @param hit Signature hit
+     * @param lowerBound Lowest readable address (e.g., start of the containing section)
+     * @param kinds REFERENCE_* mask of acceptable references
+     * @param reference Receives the reference
+     * @return true if a reference was found
+     */
+    bool FindReferenceBefore(const uint8_t* hit, const uint8_t* lowerBound, uint32_t kinds, Reference& reference);
+
+    /**
+     * @brief Probe every offset within MAX_LOOKBEHIND of a hit for a reference of a wanted kind
+     * Fallback for code the walk cannot decode: the wanted reference ending nearest the hit (the
+     * longest decoding at that end) is taken, without checking the bytes in between.
+     * @return true if a reference was found
+     */
+    bool ProbeReferenceBefore(const uint8_t* hit, const uint8_t* lowerBound, uint32_t kinds, Reference& reference);
+}
\ No newline at end of file
@@ -3,12 +3,58 @@
 #include <iostream>
 #include <windows.h>
 #include <cstdio>
+#include "Core/asyncLogger.h"
 
 // Enable debug output for TF2 SecretiveRendering
 #define DEBUG
 
+// Optional log file next to the console output
+// #define LOG_FILE "TF2SecretiveRendering.log"
+
+// Compile-time log levels; calls below LOG_LEVEL compile to nothing
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_NONE 4
+
+#ifndef LOG_LEVEL
+#ifdef DEBUG
+#define LOG_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+#endif
+
+// Records are queued on the calling thread and written by the logger's drain thread.
+// "" name forces the name to be a string literal: only its pointer is stored.
+#define LOG_WRITE(level, name, val) core::GetLogger().Write(level, "" name, val)
+
+#if LOG_LEVEL <= LOG_LEVEL_TRACE
+#define LOGTRACE(name, val) LOG_WRITE(core::LogLevel::Trace, name, val)
+#else
+#define LOGTRACE(name, val)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOGHEX(name, val) LOG_WRITE(core::LogLevel::Info, name, val)
+#else
+#define LOGHEX(name, val)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOGWARN(name, val) LOG_WRITE(core::LogLevel::Warn, name, val)
+#else
+#define LOGWARN(name, val)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOGERROR(name, val) LOG_WRITE(core::LogLevel::Error, name, val)
+#else
+#define LOGERROR(name, val)
+#endif
+
 #ifdef DEBUG
-#define LOGHEX(name, val) std::cout << name << ": " << std::hex << val << std::endl;
 #define ALLOCCONSOLE()\
 {\
     AllocConsole();\
@@ -21,7 +67,6 @@
     FreeConsole();\
 }
 #else
-#define LOGHEX(name, val)
 #define ALLOCCONSOLE()
 #define FREECONSOLE()
 #endif
\ No newline at end of file
@@ -10,15 +10,20 @@ namespace TF2SecretiveRendering {
     constexpr const char* PROJECT_NAME = "TF2 SecretiveRendering";
     constexpr const char* VERSION = "2.0.0-x64";
     constexpr const char* TARGET_GAME = "Team Fortress 2";
-    constexpr DWORD INITIALIZATION_DELAY_MS = 3000; // Wait for TF2 to fully load
+    constexpr DWORD OVERLAY_WAIT_TIMEOUT_MS = 60000; // Upper bound on waiting for the Steam overlay to load
     constexpr DWORD EXIT_KEY = VK_DELETE;
+    constexpr DWORD EXIT_KEY_POLL_MS = 100;          // Key polling until the window procedure is hooked
 }
 
+// Performance counter at DLL_PROCESS_ATTACH; fMain traces thread creation from it
+static int64_t g_attachTicks = 0;
+
 /**
  * @brief Validate target process is TF2
  * @return true if running in Team Fortress 2 process
  */
 bool ValidateTF2Process() {
+    core::TraceScope trace("ValidateTF2Process");
     char processName[MAX_PATH];
     DWORD processNameLength = GetModuleFileNameA(nullptr, processName, MAX_PATH);
     
@@ -48,20 +53,69 @@ bool ValidateTF2Process() {
 }
 
 /**
- * @brief Check if Steam overlay is available for TF2
- * @return true if gameoverlayrenderer64.dll is loaded
+ * @brief Wait for the Steam overlay to be mapped into TF2
+ * Returns as soon as gameoverlayrenderer64.dll is loaded (immediately if it already is).
+ * @return true if the module loaded within OVERLAY_WAIT_TIMEOUT_MS
  */
 bool ValidateSteamOverlay() {
-    HMODULE overlayModule = GetModuleHandleA("gameoverlayrenderer64.dll");
-    if (!overlayModule) {
+    core::TraceScope trace("ValidateSteamOverlay");
+    core::GetStartupTimeline().Mark("Startup (ms): waiting for Steam overlay");
+    
+    core::ModuleWaitResult overlay = core::WaitForModule(TF2Config::STEAM_OVERLAY_DLL, TF2SecretiveRendering::OVERLAY_WAIT_TIMEOUT_MS);
+    LOGHEX("Loader notifications available", overlay.notificationsUsed);
+    LOGHEX("Overlay module polls", overlay.polls);
+    if (!overlay.module) {
         LOGHEX("Steam overlay module not found", 0);
         return false;
     }
     
-    LOGHEX("Steam overlay module found", reinterpret_cast<uintptr_t>(overlayModule));
+    core::GetStartupTimeline().Mark("Startup (ms): Steam overlay mapped");
+    LOGHEX("Steam overlay module found", reinterpret_cast<uintptr_t>(overlay.module));
+    LOGHEX("Steam overlay detected by", core::ReadySourceName(overlay.source));
     return true;
 }
 
+/**
+ * @brief Block until the exit key is pressed
+ * The key is signaled from hkWndProc, which is only installed on the first Present; until then
+ * (or if that never happens) the key is polled as well, so the DLL can always be unloaded.
+ * @return false if waiting failed
+ */
+bool WaitForExitKey() {
+    core::InputEvents& input = core::GetInputEvents();
+    input.SetShutdownKey(TF2SecretiveRendering::EXIT_KEY);
+    while (!imguiHook::WndProcInstalled()) {
+        if (input.WaitForShutdown(TF2SecretiveRendering::EXIT_KEY_POLL_MS)) {
+            return true;
+        }
+        if (GetAsyncKeyState(TF2SecretiveRendering::EXIT_KEY) & 1) {
+            return true;
+        }
+    }
+    return input.WaitForShutdown();
+}
+
+/**
+ * @brief Stop every thread this DLL started and unload it (does not return)
+ * The hooks go first, so no Present builds the overlay inline once the UI thread is gone and no
+ * hook call is in flight when Detach destroys the renderer and the ImGui context. If they cannot
+ * be disabled, or a call never leaves its detour, only this thread exits and the DLL stays loaded.
+ * UI, scheduler, worker and logger threads must be joined here; joining under the loader lock in DllMain deadlocks.
+ */
+void ShutdownAndExit(HMODULE module, DWORD exitCode) {
+    if (!hooks::Disable()) {
+        // Unloading would free code a hooked thread may still run; everything stays as it is
+        LOGERROR("Hooks still live - the DLL stays loaded", 0);
+        ExitThread(exitCode);
+    }
+    hud::GetUiThread().Stop();
+    core::GetUpdateScheduler().Stop();
+    core::ShutdownWorkerPool();
+    hooks::ExportTrace();
+    core::GetLogger().Stop();
+    FreeLibraryAndExitThread(module, exitCode);
+}
+
 /**
  * @brief Cleanup function called on DLL detach
  */
@@ -72,6 +126,9 @@ void Detach()
     // Uninitialize hooks before console cleanup
     hooks::Uninitialize();
     
+    // The logger thread is already stopped; write what Uninitialize logged on this thread
+    core::GetLogger().Flush();
+    
     // Cleanup console last
     FREECONSOLE()
     
@@ -85,29 +142,45 @@ void Detach()
  */
 DWORD WINAPI fMain(LPVOID lpParameter)
 {
+    // Startup stages are timed from here
+    core::GetStartupTimeline();
+    core::TraceRecorder& tracer = core::GetTraceRecorder();
+    tracer.NameThread("fMain");
+    tracer.Complete("Thread creation", g_attachTicks, core::FrameProfiler::Now());
+    
     // Initialize console for debugging
     ALLOCCONSOLE()
     
+    // Log records are written by the logger thread from here on (earlier ones are kept and written first)
+    core::GetLogger().Start();
+#ifdef LOG_FILE
+    core::GetLogger().OpenFile(LOG_FILE);
+#endif
+    
     LOGHEX("=== TF2 SecretiveRendering v2.0.0 (x64) ===", 0);
     LOGHEX("Target Game", TF2SecretiveRendering::TARGET_GAME);
     LOGHEX("Architecture", "x64");
     LOGHEX("Process ID", GetCurrentProcessId());
+    core::GetStartupTimeline().Mark("Startup (ms): injected");
     
     // Validate we're running in TF2
     if (!ValidateTF2Process()) {
-        LOGHEX("WARNING: Not running in recognized TF2 process", 0);
-        LOGHEX("Hook may not work correctly", 0);
+        LOGWARN("WARNING: Not running in recognized TF2 process", 0);
+        LOGWARN("Hook may not work correctly", 0);
         // Continue anyway for testing purposes
     }
     
-    // Wait for TF2 and Steam overlay to fully initialize
-    LOGHEX("Waiting for TF2 initialization", TF2SecretiveRendering::INITIALIZATION_DELAY_MS);
-    Sleep(TF2SecretiveRendering::INITIALIZATION_DELAY_MS);
+    // Start the shared worker pool now so its threads are warm by the time signatures are scanned
+    {
+        core::TraceScope trace("Worker pool start");
+        core::WorkerPool* pool = core::GetWorkerPool();
+        LOGHEX("Worker pool threads", pool ? pool->ThreadCount() : 0);
+    }
     
-    // Validate Steam overlay is available
+    // Wait for the Steam overlay module; hooks are installed as soon as it is mapped
     if (!ValidateSteamOverlay()) {
-        LOGHEX("ERROR: Steam overlay not available", 0);
-        LOGHEX("Ensure Steam overlay is enabled for TF2", 0);
+        LOGERROR("ERROR: Steam overlay not available", 0);
+        LOGERROR("Ensure Steam overlay is enabled for TF2", 0);
         MessageBoxA(nullptr, 
                    "Steam overlay not found!\n\nPlease ensure:\n"
                    "1. Steam overlay is enabled in Steam settings\n"
@@ -116,29 +189,40 @@ DWORD WINAPI fMain(LPVOID lpParameter)
                    "TF2 SecretiveRendering Error", 
                    MB_ICONERROR);
         
-        FreeLibraryAndExitThread(static_cast<HMODULE>(lpParameter), EXIT_FAILURE);
+        ShutdownAndExit(static_cast<HMODULE>(lpParameter), EXIT_FAILURE);
         return EXIT_FAILURE;
     }
     
     // Initialize TF2 Steam overlay hooks
     LOGHEX("Initializing TF2 Steam overlay hooks", 0);
-    hooks::Initialize();
+    bool hooked = false;
+    {
+        core::TraceScope trace("hooks::Initialize");
+        hooked = hooks::Initialize();
+    }
+    if (!hooked) {
+        // Nothing is hooked, so nothing would ever signal the exit key; unload now
+        LOGERROR("ERROR: Steam overlay hooks not installed - unloading", 0);
+        ShutdownAndExit(static_cast<HMODULE>(lpParameter), EXIT_FAILURE);
+        return EXIT_FAILURE;
+    }
+    
+    // Background data providers registered by Initialize
+    core::GetUpdateScheduler().Start();
     
     LOGHEX("TF2 SecretiveRendering initialization complete", 0);
+    core::GetStartupTimeline().Mark("Startup (ms): initialization complete");
     LOGHEX("Press DELETE to exit", TF2SecretiveRendering::EXIT_KEY);
     
-    // Main loop - wait for exit key
-    while (true)
-    {
-        if (GetAsyncKeyState(TF2SecretiveRendering::EXIT_KEY) & 1) {
-            LOGHEX("Exit key pressed - shutting down", 0);
-            break;
-        }
-        Sleep(100);
+    // Sleep until the exit key reaches the game window (signaled from hkWndProc)
+    if (WaitForExitKey()) {
+        LOGHEX("Exit key pressed - shutting down", 0);
+    } else {
+        LOGERROR("Failed to wait for the exit key", GetLastError());
     }
     
     LOGHEX("TF2 SecretiveRendering shutting down", 0);
-    FreeLibraryAndExitThread(static_cast<HMODULE>(lpParameter), EXIT_SUCCESS);
+    ShutdownAndExit(static_cast<HMODULE>(lpParameter), EXIT_SUCCESS);
     return EXIT_SUCCESS;
 }
 
@@ -159,6 +243,7 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD dwReason, LPVOID lpReserved)
             DisableThreadLibraryCalls(hModule);
             
             // Create main thread to avoid blocking DLL load
+            g_attachTicks = core::FrameProfiler::Now();
             HANDLE hThread = CreateThread(nullptr, 0, fMain, hModule, 0, nullptr);
             if (hThread) {
                 CloseHandle(hThread);
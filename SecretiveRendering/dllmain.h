@@ -5,5 +5,9 @@
 #include <string>
 #include <cstring>
 #include <cctype>
+#include "Core/moduleReadiness.h"
+#include "Core/startupTimeline.h"
+#include "Core/traceRecorder.h"
+#include "Core/workerPool.h"
 #include "Rendering/basicHook.h"
 #include "debugMessage.h"
\ No newline at end of file
@@ -1,14 +1,21 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include <Psapi.h>
 #include <windows.h>
 
+#include "Core/regionMap.h"
+#include "Scanning/patternScanner.h"
+#include "Scanning/multiPatternScanner.h"
+#include "Scanning/parallelScanner.h"
+#include "Scanning/imageScanner.h"
+#include "Scanning/peImage.h"
+#include "Scanning/signature.h"
+#include "Scanning/x64Decoder.h"
+
 // Enhanced pattern scanning for 64-bit TF2 Steam overlay
-// Based on learn_more implementation with 64-bit improvements
-#define INRANGE(x, a, b) (x >= a && x <= b) 
-#define getBits(x) (INRANGE((x & (~0x20)), 'A', 'F') ? ((x & (~0x20)) - 'A' + 0xA): (INRANGE(x, '0', '9') ? x - '0': 0))
-#define getByte(x) (getBits(x[0]) << 4 | getBits(x[1]))
+// Patterns are compiled once into byte/mask arrays and scanned with SSE2/AVX2 (see Scanning/patternScanner.h)
 
 /**
  * @brief Enhanced pattern finder with bounds checking for 64-bit addresses
@@ -22,68 +29,130 @@ static uintptr_t FindPattern(const uintptr_t& start_address, const uintptr_t& en
 		return 0;
 	}
 
-	const char* pattern = target_pattern;
-	uintptr_t first_match = 0;
+	scanner::Pattern pattern;
+	if (!scanner::CompilePattern(target_pattern, pattern)) {
+		return 0;
+	}
 
-	for (uintptr_t position = start_address; position < end_address; position++) {
-		if (!*pattern)
-			return first_match;
+	const uint8_t* match = scanner::Scan(reinterpret_cast<const uint8_t*>(start_address),
+		reinterpret_cast<const uint8_t*>(end_address), pattern);
 
-		const uint8_t pattern_current = *reinterpret_cast<const uint8_t*>(pattern);
-		const uint8_t memory_current = *reinterpret_cast<const uint8_t*>(position);
+	return reinterpret_cast<uintptr_t>(match);
+}
 
-		if (pattern_current == '\?' || memory_current == getByte(pattern)) {
-			if (!first_match)
-				first_match = position;
+/**
+ * @brief Resolve the loaded address range of a module
+ * @param module Module name (e.g., "gameoverlayrenderer64.dll")
+ * @param start_address Receives the module base address
+ * @param end_address Receives the first address past the image
+ * @return true if the module is loaded and its range is sane
+ */
+static bool GetModuleRange(const char* module, uintptr_t& start_address, uintptr_t& end_address) {
+	if (!module) {
+		return false;
+	}
 
-			if (!pattern[2])
-				return first_match;
+	HMODULE moduleHandle = GetModuleHandleA(module);
+	if (!moduleHandle) {
+		return false;
+	}
 
-			pattern += pattern_current != '\?' ? 3 : 2;
-		}
-		else {
-			pattern = target_pattern;
-			first_match = 0;
-		}
+	MODULEINFO module_info = { 0 };
+	if (!GetModuleInformation(GetCurrentProcess(), moduleHandle, &module_info, sizeof(MODULEINFO))) {
+		return false;
 	}
 
-	return 0;
+	start_address = reinterpret_cast<uintptr_t>(module_info.lpBaseOfDll);
+	end_address = start_address + module_info.SizeOfImage;
+
+	// Validate address range for 64-bit
+	return start_address >= 0x10000 && end_address > start_address;
 }
 
 /**
- * @brief Find pattern in a specific module with enhanced validation
+ * @brief Find an already compiled pattern in a specific module
+ * Only sections matching the target mask are scanned; if the PE headers cannot be parsed the
+ * whole image is scanned instead.
  * @param module Module name (e.g., "gameoverlayrenderer64.dll")
- * @param target_pattern Pattern to search for
+ * @param pattern Compiled pattern (e.g., a DECLARE_SIGNATURE pattern)
+ * @param sections pe::TARGET_* kinds of section to search (code-only by default)
  * @return Address where pattern was found, or 0 if not found
  */
-static uintptr_t FindPattern(const char* module, const char* target_pattern) {
-	if (!module || !target_pattern) {
-		return 0;
+static uintptr_t FindPattern(const char* module, const scanner::Pattern& pattern, uint32_t sections = pe::TARGET_CODE) {
+	uintptr_t start_address = 0;
+	uintptr_t end_address = 0;
+	core::WorkerPool* pool = core::GetWorkerPool();
+	if (!pattern.valid || !pool || !GetModuleRange(module, start_address, end_address)) {
+		return 0; // No pool: the DLL is shutting down
 	}
 
-	HMODULE moduleHandle = GetModuleHandleA(module);
-	if (!moduleHandle) {
-		return 0;
+	const uint8_t* image = reinterpret_cast<const uint8_t*>(start_address);
+	pe::ImageInfo image_info;
+	const uint8_t* match = nullptr;
+	if (pe::ParseImage(image, end_address - start_address, image_info)) {
+		match = scanner::ScanImage(image, image_info, pattern, sections, *pool);
+	}
+	else {
+		// Whole images are scanned in chunks on the shared worker pool; result matches the serial scan
+		match = scanner::ScanParallel(image, reinterpret_cast<const uint8_t*>(end_address), pattern, *pool);
 	}
 
-	MODULEINFO module_info = { 0 };
-	if (!GetModuleInformation(GetCurrentProcess(), moduleHandle, &module_info, sizeof(MODULEINFO))) {
+	return reinterpret_cast<uintptr_t>(match);
+}
+
+/**
+ * @brief Find pattern in a specific module with enhanced validation
+ * @param module Module name (e.g., "gameoverlayrenderer64.dll")
+ * @param target_pattern Pattern to search for, parsed at runtime
+ * @param sections pe::TARGET_* kinds of section to search (code-only by default)
+ * @return Address where pattern was found, or 0 if not found
+ */
+static uintptr_t FindPattern(const char* module, const char* target_pattern, uint32_t sections = pe::TARGET_CODE) {
+	scanner::Pattern pattern;
+	if (!target_pattern || !scanner::CompilePattern(target_pattern, pattern)) {
 		return 0;
 	}
 
-	const uintptr_t start_address = reinterpret_cast<uintptr_t>(module_info.lpBaseOfDll);
-	const uintptr_t end_address = start_address + module_info.SizeOfImage;
+	return FindPattern(module, pattern, sections);
+}
 
-	// Validate address range for 64-bit
-	if (start_address < 0x10000 || end_address <= start_address) {
-		return 0;
+/**
+ * @brief Find a build-time signature in a specific module, in the sections it targets
+ * @param module Module name (e.g., "gameoverlayrenderer64.dll")
+ * @param signature Signature declared with DECLARE_SIGNATURE
+ * @return Address where the signature was found, or 0 if not found
+ */
+static uintptr_t FindPattern(const char* module, const scanner::Signature& signature) {
+	return FindPattern(module, signature.pattern, signature.sections);
+}
+
+/**
+ * @brief Find every hit of every signature in a module with a single pass over the image
+ * Each signature only reports hits inside the sections it targets (see SignatureSet::Add).
+ * @param module Module name (e.g., "gameoverlayrenderer64.dll")
+ * @param signatures Named signatures to search for
+ * @return One entry per signature in insertion order (empty hit lists if the module is missing)
+ */
+static std::vector<scanner::SignatureHits> FindPatterns(const char* module, const scanner::SignatureSet& signatures) {
+	uintptr_t start_address = 0;
+	uintptr_t end_address = 0;
+	core::WorkerPool* pool = core::GetWorkerPool();
+	if (!pool || !GetModuleRange(module, start_address, end_address)) {
+		return signatures.ScanAll(nullptr, nullptr);
+	}
+
+	const uint8_t* image = reinterpret_cast<const uint8_t*>(start_address);
+	pe::ImageInfo image_info;
+	if (pe::ParseImage(image, end_address - start_address, image_info)) {
+		return scanner::ScanImageAll(image, image_info, signatures, *pool);
 	}
 
-	return FindPattern(start_address, end_address, target_pattern);
+	return scanner::ScanAllParallel(image, reinterpret_cast<const uint8_t*>(end_address), signatures, *pool);
 }
 
 /**
  * @brief Validate if a memory address is executable and safe to use
+ * Answered from the cached region map (see Core/regionMap.h), so repeated checks cost no syscalls.
  * @param address Address to validate
  * @return true if address is valid and executable
  */
@@ -92,17 +161,13 @@ static bool IsValidExecutableAddress(uintptr_t address) {
 		return false;
 	}
 
-	MEMORY_BASIC_INFORMATION mbi;
-	if (!VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi))) {
-		return false;
-	}
-
-	return (mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE)) != 0;
+	return core::GetRegionMap().IsExecutable(address);
 }
 
 /**
  * @brief Extract function address from LEA instruction pattern (64-bit)
- * Used to extract Steam overlay function addresses from call patterns
+ * Used to extract Steam overlay function addresses from call patterns. Any
+ * "lea r, [rip+disp32]" is accepted, whatever the register and REX prefix.
  * @param patternAddr Address where the call pattern was found
  * @param leaOffset Offset to the LEA instruction (typically -7 for Steam patterns)
  * @return Extracted function address, or 0 if extraction failed
@@ -112,19 +177,13 @@ static uintptr_t ExtractFunctionFromLEA(uintptr_t patternAddr, int leaOffset = -
 		return 0;
 	}
 
-	uint8_t* leaAddr = reinterpret_cast<uint8_t*>(patternAddr + leaOffset);
-	
-	// Verify LEA instruction: 48 8D 15 (LEA RDX, [RIP+offset])
-	if (leaAddr[0] == 0x48 && leaAddr[1] == 0x8D && leaAddr[2] == 0x15) {
-		// Extract 32-bit relative offset
-		int32_t relativeOffset = *reinterpret_cast<int32_t*>(leaAddr + 3);
-		// Calculate absolute address: instruction_end + relative_offset
-		uintptr_t functionAddr = reinterpret_cast<uintptr_t>(leaAddr + 7) + relativeOffset;
-		
-		if (IsValidExecutableAddress(functionAddr)) {
-			return functionAddr;
-		}
+	const uint8_t* leaAddr = reinterpret_cast<const uint8_t*>(patternAddr + leaOffset);
+
+	x64::Instruction instruction;
+	if (!x64::Decode(leaAddr, x64::MAX_INSTRUCTION_LENGTH, instruction) || instruction.kind != x64::REFERENCE_LEA) {
+		return 0;
 	}
 
-	return 0;
+	uintptr_t functionAddr = x64::TargetOf(reinterpret_cast<uintptr_t>(leaAddr), instruction);
+	return IsValidExecutableAddress(functionAddr) ? functionAddr : 0;
 }
\ No newline at end of file
@@ -0,0 +1,530 @@
+// framesim: drives the overlay renderer through thousands of simulated Present/Reset cycles.
+// Frames shaped like the overlay's ImGui output (debug window + HUD, content changing every few
+// frames like the quantised FPS text, occasional oversized frames) are rendered on a recording
+// device in the same order hkPresent and hkReset use. Device rules are checked on every call, the
+// per-frame counters are checked against what the renderer reported, and the CPU cost of each
+// frame is compared with the hook's overhead budget. The quality governor is run through a scripted
+// load profile (idle, overload, recovery, a game paced at the refresh rate), and the overlay
+// callback throttle through overruns, recovery and disabling. The exit code is non-zero on any
+// failure.
+//
+// Usage: framesim [--frames N] [--reset-every N] [--change-every N] [--spike-every N]
+//                 [--seed N] [--budget-us US] [--json OUT] [--trace OUT]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Core/callbackThrottle.h"
+#include "Core/frameProfiler.h"
+#include "Core/qualityGovernor.h"
+#include "Core/traceRecorder.h"
+#include "Rendering/overlayRenderer.h"
+#include "recordingDevice.h"
+
+namespace {
+    constexpr uint64_t DEFAULT_SEED = 0xF2A3E;
+    constexpr uint32_t SPIKE_LISTS = 3;
+    constexpr uint32_t SPIKE_QUADS_PER_LIST = 16000;    // 64000 vertices: the most one 16-bit list can hold
+    constexpr float DISPLAY_WIDTH = 1920.0f;
+    constexpr float DISPLAY_HEIGHT = 1080.0f;
+
+    struct Options {
+        uint64_t frames = 20000;
+        uint64_t resetEvery = 1000;
+        uint64_t changeEvery = 15;      // ~250 ms at 60 FPS, like the displayed frame rate
+        uint64_t spikeEvery = 5000;
+        uint64_t seed = DEFAULT_SEED;
+        double budgetUs = core::OVERHEAD_BUDGET_US;
+        std::string jsonPath;
+        std::string tracePath;
+    };
+
+    /**
+     * @brief One synthetic draw list and the storage its view points into
+     */
+    struct SyntheticList {
+        std::vector<render::SourceVertex> vertices;
+        std::vector<uint16_t> indices;
+        std::vector<render::DrawCommand> commands;
+    };
+
+    /**
+     * @brief Generates overlay-like frames
+     */
+    class Scene {
+    public:
+        explicit Scene(uint64_t seed) : random(seed) {}
+
+        /**
+         * @brief Texture ids in use (the image is recreated after a device reset, the managed font atlas is not)
+         */
+        void SetTextures(uint64_t font, uint64_t image) {
+            fontTexture = font;
+            imageTexture = image;
+        }
+
+        /**
+         * @brief Regenerate the geometry
+         * @param spike Emit an oversized frame (forces buffer growth and per-list base vertices)
+         */
+        void Rebuild(bool spike) {
+            lists.clear();
+            if (spike) {
+                for (uint32_t i = 0; i < SPIKE_LISTS; i++) {
+                    lists.emplace_back();
+                    AddWindow(lists.back(), SPIKE_QUADS_PER_LIST, 4, { 0.0f, 0.0f, DISPLAY_WIDTH, DISPLAY_HEIGHT });
+                }
+            } else {
+                // Debug window: text and widgets in a few clip rectangles, one image
+                std::uniform_int_distribution<uint32_t> windowQuads(300, 900);
+                lists.emplace_back();
+                AddWindow(lists.back(), windowQuads(random), 8, { 50.0f, 50.0f, 400.0f, 420.0f });
+
+                // HUD: a background and two lines of text
+                std::uniform_int_distribution<uint32_t> hudQuads(20, 40);
+                lists.emplace_back();
+                AddWindow(lists.back(), hudQuads(random), 2, { 10.0f, 10.0f, 90.0f, 50.0f });
+            }
+            generation++;
+            BuildView();
+        }
+
+        /**
+         * @brief The retained HUD drops its cache on reset; the next frame is new geometry
+         */
+        void Invalidate() { Rebuild(false); }
+
+        const render::FrameView& View() const { return view; }
+        uint32_t CommandCount() const { return commandCount; }
+
+    private:
+        void AddQuad(SyntheticList& list, float x, float y, float size, uint32_t color) {
+            const uint16_t base = static_cast<uint16_t>(list.vertices.size());
+            list.vertices.push_back({ x, y, 0.0f, 0.0f, color });
+            list.vertices.push_back({ x + size, y, 1.0f, 0.0f, color });
+            list.vertices.push_back({ x + size, y + size, 1.0f, 1.0f, color });
+            list.vertices.push_back({ x, y + size, 0.0f, 1.0f, color });
+            const uint16_t quad[] = { base, static_cast<uint16_t>(base + 1), static_cast<uint16_t>(base + 2),
+                base, static_cast<uint16_t>(base + 2), static_cast<uint16_t>(base + 3) };
+            list.indices.insert(list.indices.end(), std::begin(quad), std::end(quad));
+        }
+
+        /**
+         * @brief Quads split over commands the way ImGui splits a window (clip changes, an image)
+         */
+        void AddWindow(SyntheticList& list, uint32_t quads, uint32_t commands, const render::ClipRect& clip) {
+            std::uniform_real_distribution<float> x(clip.left, clip.right);
+            std::uniform_real_distribution<float> y(clip.top, clip.bottom);
+            std::uniform_int_distribution<uint32_t> color;
+
+            const uint32_t perCommand = (quads + commands - 1) / commands;
+            for (uint32_t c = 0; c < commands && quads; c++) {
+                const uint32_t count = (std::min)(perCommand, quads);
+                quads -= count;
+
+                render::DrawCommand command;
+                command.clip = clip;
+                command.texture = fontTexture;
+                command.indexOffset = static_cast<uint32_t>(list.indices.size());
+                command.vertexOffset = 0;
+                if (c % 3 == 1) {
+                    // A child region (scrolling area, plot) with a narrower clip rectangle
+                    command.clip.right = clip.left + (clip.right - clip.left) / 2.0f;
+                }
+                if (c == commands / 2 && commands > 2) {
+                    command.texture = imageTexture;
+                }
+                for (uint32_t i = 0; i < count; i++) {
+                    AddQuad(list, x(random), y(random), 8.0f, color(random));
+                }
+                command.elementCount = static_cast<uint32_t>(list.indices.size()) - command.indexOffset;
+                list.commands.push_back(command);
+            }
+        }
+
+        void BuildView() {
+            views.clear();
+            view = render::FrameView();
+            commandCount = 0;
+            for (const SyntheticList& list : lists) {
+                views.push_back({ list.vertices.data(), static_cast<uint32_t>(list.vertices.size()),
+                    list.indices.data(), static_cast<uint32_t>(list.indices.size()),
+                    list.commands.data(), static_cast<uint32_t>(list.commands.size()) });
+                view.totalVertices += static_cast<uint32_t>(list.vertices.size());
+                view.totalIndices += static_cast<uint32_t>(list.indices.size());
+                commandCount += static_cast<uint32_t>(list.commands.size());
+            }
+            view.displayWidth = DISPLAY_WIDTH;
+            view.displayHeight = DISPLAY_HEIGHT;
+            view.lists = views.data();
+            view.listCount = views.size();
+            view.generation = generation;
+        }
+
+        std::mt19937_64 random;
+        uint64_t fontTexture = 0;
+        uint64_t imageTexture = 0;
+        uint64_t generation = 0;
+        std::vector<SyntheticList> lists;
+        std::vector<render::DrawListView> views;
+        render::FrameView view;
+        uint32_t commandCount = 0;
+    };
+
+    struct Summary {
+        uint64_t frames = 0;
+        uint64_t uploads = 0;
+        uint64_t reused = 0;
+        uint64_t resets = 0;
+        uint64_t commands = 0;
+        uint64_t failedChecks = 0;
+        framesim::DeviceCounters totals;
+        render::RenderStats lastStats;
+        core::LatencyHistogram renderNs;
+    };
+
+    /**
+     * @brief Compare one frame's device counters with what the renderer says it did
+     */
+    void CheckFrame(const render::OverlayRenderer& renderer, const render::FrameView& view, uint32_t commands,
+        const framesim::DeviceCounters& counters, uint64_t frame, Summary& summary) {
+        const render::RenderStats& stats = renderer.LastStats();
+        auto check = [&](bool condition, const char* message) {
+            if (!condition) {
+                if (summary.failedChecks < 20) {
+                    std::fprintf(stderr, "frame %llu: %s\n", static_cast<unsigned long long>(frame), message);
+                }
+                summary.failedChecks++;
+            }
+        };
+
+        check(counters.draws == stats.batches && counters.draws == renderer.Batches().size(), "draw count differs from the batches");
+        check(counters.draws <= commands, "more draws than commands");
+        check(counters.stateApplies == 3, "state blocks not applied exactly once per frame");
+        check(counters.textureChanges <= counters.draws && counters.scissorChanges <= counters.draws, "redundant state changes");
+        if (stats.uploaded) {
+            check(counters.vertexBytes == static_cast<uint64_t>(view.totalVertices) * sizeof(render::Vertex), "vertex upload size");
+            check(counters.indexBytes == static_cast<uint64_t>(view.totalIndices) * sizeof(uint16_t), "index upload size");
+            check(counters.locks == 2, "expected one vertex and one index lock");
+        } else {
+            check(counters.locks == 0 && counters.vertexBytes == 0, "unchanged frame was uploaded");
+        }
+    }
+
+    /**
+     * @brief Drive the quality governor through idle, overload and recovery phases
+     */
+    void CheckGovernor(Summary& summary) {
+        core::QualityGovernor governor(1000.0 / 60.0);
+        auto check = [&](bool condition, const char* message) {
+            if (!condition) {
+                std::fprintf(stderr, "governor: %s (level %s)\n", message, core::OverlayQualityName(governor.Level()));
+                summary.failedChecks++;
+            }
+        };
+        auto run = [&](double frameMs, double seconds) {
+            for (double elapsed = 0.0; elapsed < seconds * 1000.0; elapsed += frameMs) {
+                governor.Update(frameMs);
+            }
+        };
+
+        run(10.0, 2.0);
+        check(governor.Level() == core::OverlayQuality::Full && governor.StepsDown() == 0, "stepped down with headroom");
+
+        // Loading hitches are not load
+        governor.Update(1000.0);
+        run(10.0, 0.5);
+        check(governor.Level() == core::OverlayQuality::Full, "stepped down on a single hitch");
+
+        run(25.0, 3.0);
+        check(governor.Level() == core::OverlayQuality::HalfRate, "did not reach the lowest level under sustained load");
+
+        // Just under the target: no headroom, so no recovery and no oscillation
+        const uint64_t steps = governor.StepsDown() + governor.StepsUp();
+        run(15.5, 5.0);
+        check(governor.StepsDown() + governor.StepsUp() == steps, "changed level without a clear signal");
+
+        run(8.0, 10.0);
+        check(governor.Level() == core::OverlayQuality::Full, "did not recover with headroom");
+
+        // A 59.94 Hz display behind a 60 Hz mode: presenting at the refresh rate is not load
+        core::QualityGovernor refreshPaced(1000.0 / 60.0);
+        for (double elapsed = 0.0; elapsed < 10000.0; elapsed += 16.68) {
+            refreshPaced.Update(16.68);
+        }
+        if (refreshPaced.Level() != core::OverlayQuality::Full || refreshPaced.StepsDown() != 0) {
+            std::fprintf(stderr, "governor: stepped down at the display's refresh rate (level %s)\n",
+                core::OverlayQualityName(refreshPaced.Level()));
+            summary.failedChecks++;
+        }
+    }
+
+    /**
+     * @brief Drive a callback throttle through occasional and sustained overruns, recovery and disabling
+     */
+    void CheckCallbackThrottle(Summary& summary) {
+        constexpr double BUDGET_US = 100.0;
+        core::CallbackThrottle throttle(BUDGET_US);
+        auto check = [&](bool condition, const char* message) {
+            if (!condition) {
+                std::fprintf(stderr, "callback throttle: %s (interval %u%s)\n", message, throttle.Interval(),
+                    throttle.Disabled() ? ", disabled" : "");
+                summary.failedChecks++;
+            }
+        };
+        auto run = [&](double costUs, uint32_t calls) {
+            core::ThrottleChange last = core::ThrottleChange::None;
+            for (uint32_t i = 0; i < calls; i++) {
+                const core::ThrottleChange change = throttle.Account(costUs);
+                if (change != core::ThrottleChange::None) {
+                    last = change;
+                }
+            }
+            return last;
+        };
+
+        run(50.0, 100);
+        check(throttle.Interval() == 1 && !throttle.Disabled(), "throttled within budget");
+
+        // Isolated overruns are noise
+        for (uint32_t i = 0; i < 20; i++) {
+            run(150.0, core::CALLBACK_OVERRUNS_TO_THROTTLE - 1);
+            run(50.0, 1);
+        }
+        check(throttle.Interval() == 1, "throttled on isolated overruns");
+
+        check(run(150.0, core::CALLBACK_OVERRUNS_TO_THROTTLE) == core::ThrottleChange::Lowered && throttle.Interval() == 2,
+            "rate not halved after consecutive overruns");
+        while (throttle.Interval() < core::CALLBACK_MAX_INTERVAL && !throttle.Disabled()) {
+            run(150.0, core::CALLBACK_OVERRUNS_TO_THROTTLE);
+        }
+        check(throttle.Interval() == core::CALLBACK_MAX_INTERVAL && !throttle.Disabled(), "disabled before the lowest rate");
+
+        // Back within budget: the rate doubles after every CALLBACK_CLEAN_RUNS_TO_RECOVER calls
+        run(50.0, core::CALLBACK_CLEAN_RUNS_TO_RECOVER - 1);
+        check(throttle.Interval() == core::CALLBACK_MAX_INTERVAL, "recovered early");
+        check(run(50.0, 1) == core::ThrottleChange::Raised && throttle.Interval() == core::CALLBACK_MAX_INTERVAL / 2,
+            "rate not doubled after clean calls");
+        run(50.0, core::CALLBACK_CLEAN_RUNS_TO_RECOVER * 4);
+        check(throttle.Interval() == 1, "did not recover the full rate");
+
+        // Over budget at the lowest rate: disabled after the last strike, not before
+        while (throttle.Interval() < core::CALLBACK_MAX_INTERVAL) {
+            run(150.0, core::CALLBACK_OVERRUNS_TO_THROTTLE);
+        }
+        run(150.0, core::CALLBACK_OVERRUNS_TO_THROTTLE * (core::CALLBACK_STRIKES_TO_DISABLE - 1));
+        check(!throttle.Disabled(), "disabled before the last strike");
+        check(run(150.0, core::CALLBACK_OVERRUNS_TO_THROTTLE) == core::ThrottleChange::Disabled && throttle.Disabled(),
+            "not disabled over budget at the lowest rate");
+
+        throttle.Reset();
+        check(throttle.Interval() == 1 && !throttle.Disabled() && throttle.Runs() > 0, "reset did not restore the full rate");
+    }
+
+    void Simulate(const Options& options, Summary& summary, framesim::RecordingDevice& device) {
+        render::OverlayRenderer renderer(device);
+        core::FrameProfiler clock;
+        Scene scene(options.seed);
+
+        // The font atlas lives in a managed texture created once (see fontAtlasCache.h)
+        const uint64_t font = 1;
+        uint64_t nextTexture = 2;
+        device.AddTexture(font, true);
+        auto createTextures = [&]() {
+            const uint64_t image = nextTexture++;
+            device.AddTexture(image);
+            scene.SetTextures(font, image);
+        };
+
+        // First hkPresent: ImGui and the renderer are initialized
+        createTextures();
+        renderer.CreateDeviceObjects();
+        scene.Rebuild(false);
+
+        core::TraceRecorder& tracer = core::GetTraceRecorder();
+        tracer.NameThread("framesim");
+        for (uint64_t frame = 0; frame < options.frames; frame++) {
+            if (options.resetEvery && frame && frame % options.resetEvery == 0) {
+                // hkReset: release, Reset, recreate, and the retained HUD drops its cache
+                core::TraceScope resetSpan("Device reset");
+                renderer.InvalidateDeviceObjects();
+                device.Reset();
+                createTextures();
+                renderer.CreateDeviceObjects();
+                scene.Invalidate();
+                summary.resets++;
+            }
+            if (options.spikeEvery && frame && frame % options.spikeEvery == 0) {
+                scene.Rebuild(true);
+            } else if (options.changeEvery && frame % options.changeEvery == 0) {
+                scene.Rebuild(false);
+            }
+
+            const int64_t start = core::FrameProfiler::Now();
+            renderer.Render(scene.View());
+            const int64_t end = core::FrameProfiler::Now();
+            summary.renderNs.Record(clock.TicksToNanoseconds(end - start));
+            tracer.Complete("Render", start, end);
+            if (frame == 0) {
+                tracer.EndStartup();
+            }
+
+            const framesim::DeviceCounters counters = device.EndFrame();
+            CheckFrame(renderer, scene.View(), scene.CommandCount(), counters, frame, summary);
+
+            summary.frames++;
+            summary.commands += scene.CommandCount();
+            if (renderer.LastStats().uploaded) {
+                summary.uploads++;
+            } else {
+                summary.reused++;
+            }
+        }
+
+        // Unload: everything released before the device goes away
+        renderer.InvalidateDeviceObjects();
+        device.Reset();
+        summary.totals = device.Totals();
+        summary.lastStats = renderer.LastStats();
+    }
+
+    bool WriteJson(const std::string& path, const Summary& summary, const uint64_t* percentilesNs, size_t violations) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        char text[1024];
+        std::snprintf(text, sizeof(text),
+            "{\n"
+            "  \"frames\": %llu, \"resets\": %llu, \"uploads\": %llu, \"reused\": %llu,\n"
+            "  \"commands\": %llu, \"draws\": %llu, \"locks\": %llu, \"discard_locks\": %llu,\n"
+            "  \"vertex_bytes\": %llu, \"index_bytes\": %llu, \"texture_changes\": %llu, \"scissor_changes\": %llu,\n"
+            "  \"buffer_growths\": %llu, \"render_p50_us\": %.3f, \"render_p99_us\": %.3f, \"render_p999_us\": %.3f,\n"
+            "  \"violations\": %zu, \"failed_checks\": %llu\n"
+            "}\n",
+            static_cast<unsigned long long>(summary.frames), static_cast<unsigned long long>(summary.resets),
+            static_cast<unsigned long long>(summary.uploads), static_cast<unsigned long long>(summary.reused),
+            static_cast<unsigned long long>(summary.commands), static_cast<unsigned long long>(summary.totals.draws),
+            static_cast<unsigned long long>(summary.totals.locks), static_cast<unsigned long long>(summary.totals.discardLocks),
+            static_cast<unsigned long long>(summary.totals.vertexBytes), static_cast<unsigned long long>(summary.totals.indexBytes),
+            static_cast<unsigned long long>(summary.totals.textureChanges), static_cast<unsigned long long>(summary.totals.scissorChanges),
+            static_cast<unsigned long long>(summary.lastStats.bufferGrowths),
+            percentilesNs[0] / 1000.0, percentilesNs[1] / 1000.0, percentilesNs[2] / 1000.0,
+            violations, static_cast<unsigned long long>(summary.failedChecks));
+        file << text;
+        return static_cast<bool>(file);
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const bool hasValue = i + 1 < argc;
+            if (!std::strcmp(argv[i], "--frames") && hasValue) {
+                options.frames = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (!std::strcmp(argv[i], "--reset-every") && hasValue) {
+                options.resetEvery = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (!std::strcmp(argv[i], "--change-every") && hasValue) {
+                options.changeEvery = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (!std::strcmp(argv[i], "--spike-every") && hasValue) {
+                options.spikeEvery = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (!std::strcmp(argv[i], "--seed") && hasValue) {
+                options.seed = std::strtoull(argv[++i], nullptr, 0);
+            }
+            else if (!std::strcmp(argv[i], "--budget-us") && hasValue) {
+                options.budgetUs = std::atof(argv[++i]);
+            }
+            else if (!std::strcmp(argv[i], "--json") && hasValue) {
+                options.jsonPath = argv[++i];
+            }
+            else if (!std::strcmp(argv[i], "--trace") && hasValue) {
+                options.tracePath = argv[++i];
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void PrintUsage(const char* program) {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --frames N          Presents to simulate (default: 20000)\n"
+            "  --reset-every N     Device reset every N frames, 0 for none (default: 1000)\n"
+            "  --change-every N    New overlay geometry every N frames (default: 15)\n"
+            "  --spike-every N     Oversized frame every N frames, 0 for none (default: 5000)\n"
+            "  --seed N            Random seed\n"
+            "  --budget-us US      p99.9 render cost allowed per frame (default: %.0f)\n"
+            "  --json OUT          Write the summary as JSON\n"
+            "  --trace OUT         Write the last frames as Chrome trace-event JSON\n",
+            program, core::OVERHEAD_BUDGET_US);
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    framesim::RecordingDevice device;
+    Summary summary;
+    Simulate(options, summary, device);
+    CheckGovernor(summary);
+    CheckCallbackThrottle(summary);
+
+    static const double percentiles[] = { 50.0, 99.0, 99.9 };
+    uint64_t percentilesNs[3];
+    summary.renderNs.Percentiles(percentiles, 3, percentilesNs);
+
+    const framesim::DeviceCounters& totals = summary.totals;
+    const double frames = summary.frames ? static_cast<double>(summary.frames) : 1.0;
+    std::printf("%llu frames, %llu resets: %llu uploaded, %llu reused\n", static_cast<unsigned long long>(summary.frames),
+        static_cast<unsigned long long>(summary.resets), static_cast<unsigned long long>(summary.uploads),
+        static_cast<unsigned long long>(summary.reused));
+    std::printf("per frame: %.1f commands -> %.1f draws, %.2f texture / %.2f scissor changes, %.2f locks, %.1f KB uploaded\n",
+        summary.commands / frames, totals.draws / frames, totals.textureChanges / frames, totals.scissorChanges / frames,
+        totals.locks / frames, (totals.vertexBytes + totals.indexBytes) / frames / 1024.0);
+    std::printf("ring wraps %llu, buffer growths %llu, buffers created %llu, state blocks created %llu\n",
+        static_cast<unsigned long long>(summary.lastStats.ringWraps), static_cast<unsigned long long>(summary.lastStats.bufferGrowths),
+        static_cast<unsigned long long>(totals.bufferCreations), static_cast<unsigned long long>(totals.stateBlockCreations));
+    std::printf("render cost: p50 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us (budget %.0f us)\n",
+        percentilesNs[0] / 1000.0, percentilesNs[1] / 1000.0, percentilesNs[2] / 1000.0,
+        summary.renderNs.Max() / 1000.0, options.budgetUs);
+
+    int exitCode = 0;
+    for (const std::string& violation : device.Violations()) {
+        std::fprintf(stderr, "violation: %s\n", violation.c_str());
+    }
+    if (!device.Violations().empty() || summary.failedChecks) {
+        std::fprintf(stderr, "%zu device rule violation(s), %llu failed check(s)\n", device.Violations().size(),
+            static_cast<unsigned long long>(summary.failedChecks));
+        exitCode = 1;
+    }
+    if (percentilesNs[2] / 1000.0 > options.budgetUs) {
+        std::fprintf(stderr, "p99.9 render cost over budget\n");
+        exitCode = 1;
+    }
+
+    if (!options.jsonPath.empty() && !WriteJson(options.jsonPath, summary, percentilesNs, device.Violations().size())) {
+        std::fprintf(stderr, "Failed to write %s\n", options.jsonPath.c_str());
+        exitCode = 2;
+    }
+    if (!options.tracePath.empty() && !core::GetTraceRecorder().ExportJson(options.tracePath)) {
+        std::fprintf(stderr, "Failed to write %s\n", options.tracePath.c_str());
+        exitCode = 2;
+    }
+    return exitCode;
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "recordingDevice.h"
+
+#include <algorithm>
+
+void framesim::DeviceCounters::Add(const DeviceCounters& other) {
+    draws += other.draws;
+    primitives += other.primitives;
+    vertexBytes += other.vertexBytes;
+    indexBytes += other.indexBytes;
+    locks += other.locks;
+    discardLocks += other.discardLocks;
+    textureChanges += other.textureChanges;
+    scissorChanges += other.scissorChanges;
+    stateApplies += other.stateApplies;
+    bufferCreations += other.bufferCreations;
+    stateBlockCreations += other.stateBlockCreations;
+}
+
+void framesim::RecordingDevice::Violation(const std::string& message) {
+    // Keep the report readable when one bug repeats every frame
+    if (violations.size() < 100) {
+        violations.push_back("frame " + std::to_string(frame) + ": " + message);
+    }
+}
+
+bool framesim::RecordingDevice::CreateBuffers(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    if (vertices.locked || indices.locked) {
+        Violation("buffers recreated while locked");
+    }
+    vertices = Ring<render::Vertex>();
+    indices = Ring<uint16_t>();
+    vertices.data.resize(vertexCapacity);
+    indices.data.resize(indexCapacity);
+    vertices.exists = true;
+    indices.exists = true;
+    current.bufferCreations++;
+    return true;
+}
+
+void framesim::RecordingDevice::ReleaseBuffers() {
+    if (vertices.locked || indices.locked) {
+        Violation("buffers released while locked");
+    }
+    vertices = Ring<render::Vertex>();
+    indices = Ring<uint16_t>();
+}
+
+bool framesim::RecordingDevice::CreateStateBlocks() {
+    if (inOverlay) {
+        Violation("state blocks recorded between BeginOverlay and EndOverlay");
+    }
+    stateBlocks = true;
+    current.stateBlockCreations++;
+    return true;
+}
+
+void framesim::RecordingDevice::ReleaseStateBlocks() {
+    stateBlocks = false;
+}
+
+template<typename T>
+T* framesim::RecordingDevice::Lock(Ring<T>& ring, uint32_t first, uint32_t count, bool discard, uint64_t& bytes, const char* name) {
+    if (!ring.exists) {
+        Violation(std::string(name) + " buffer locked after release");
+        return nullptr;
+    }
+    if (ring.locked) {
+        Violation(std::string(name) + " buffer locked twice");
+        return nullptr;
+    }
+    if (static_cast<uint64_t>(first) + count > ring.data.size()) {
+        Violation(std::string(name) + " lock past the end of the buffer");
+        return nullptr;
+    }
+
+    if (discard) {
+        // Orphaned: earlier draws keep reading the old storage
+        ring.written = 0;
+        ring.drawnEnd = 0;
+        current.discardLocks++;
+    } else if (first < ring.drawnEnd) {
+        Violation(std::string(name) + " no-overwrite lock over data an earlier draw may still read");
+    }
+
+    ring.locked = true;
+    ring.written = (std::max)(ring.written, first + count);
+    current.locks++;
+    bytes += static_cast<uint64_t>(count) * sizeof(T);
+    return ring.data.data() + first;
+}
+
+template<typename T>
+void framesim::RecordingDevice::Unlock(Ring<T>& ring, const char* name) {
+    if (!ring.locked) {
+        Violation(std::string(name) + " buffer unlocked without a lock");
+    }
+    ring.locked = false;
+}
+
+render::Vertex* framesim::RecordingDevice::LockVertices(uint32_t first, uint32_t count, bool discard) {
+    return Lock(vertices, first, count, discard, current.vertexBytes, "vertex");
+}
+
+void framesim::RecordingDevice::UnlockVertices() {
+    Unlock(vertices, "vertex");
+}
+
+uint16_t* framesim::RecordingDevice::LockIndices(uint32_t first, uint32_t count, bool discard) {
+    return Lock(indices, first, count, discard, current.indexBytes, "index");
+}
+
+void framesim::RecordingDevice::UnlockIndices() {
+    Unlock(indices, "index");
+}
+
+void framesim::RecordingDevice::BeginOverlay(const render::FrameView&) {
+    if (inOverlay) {
+        Violation("BeginOverlay twice");
+    }
+    if (!stateBlocks) {
+        Violation("BeginOverlay without state blocks");
+    }
+    inOverlay = true;
+    scissorSet = false;
+    boundTexture = 0;
+    current.stateApplies += 2;  // Capture the game's states, apply ours
+}
+
+void framesim::RecordingDevice::EndOverlay() {
+    if (!inOverlay) {
+        Violation("EndOverlay without BeginOverlay");
+    }
+    inOverlay = false;
+    current.stateApplies++;
+}
+
+void framesim::RecordingDevice::SetTexture(uint64_t texture) {
+    if (std::find(textures.begin(), textures.end(), texture) == textures.end() &&
+        std::find(managedTextures.begin(), managedTextures.end(), texture) == managedTextures.end()) {
+        Violation("unknown texture " + std::to_string(texture));
+    }
+    boundTexture = texture;
+    current.textureChanges++;
+}
+
+void framesim::RecordingDevice::SetScissor(const render::ScissorRect& scissor) {
+    if (scissor.right <= scissor.left || scissor.bottom <= scissor.top) {
+        Violation("empty scissor rectangle");
+    }
+    scissorSet = true;
+    current.scissorChanges++;
+}
+
+void framesim::RecordingDevice::DrawIndexed(uint32_t baseVertex, uint32_t vertexCount, uint32_t startIndex, uint32_t primitiveCount) {
+    current.draws++;
+    current.primitives += primitiveCount;
+
+    if (!inOverlay) {
+        Violation("draw outside BeginOverlay/EndOverlay");
+    }
+    if (vertices.locked || indices.locked) {
+        Violation("draw while a buffer is locked");
+    }
+    if (!boundTexture || !scissorSet) {
+        Violation("draw without texture or scissor");
+    }
+    if (!primitiveCount) {
+        Violation("empty draw");
+        return;
+    }
+
+    const uint64_t indexEnd = static_cast<uint64_t>(startIndex) + primitiveCount * 3ull;
+    if (indexEnd > indices.written || static_cast<uint64_t>(baseVertex) + vertexCount > vertices.written) {
+        Violation("draw reads outside the uploaded data");
+        return;
+    }
+    // Indices are checked in EndFrame, outside the renderer's timed work
+    draws.push_back({ vertexCount, startIndex, primitiveCount });
+
+    vertices.drawnEnd = (std::max)(vertices.drawnEnd, baseVertex + vertexCount);
+    indices.drawnEnd = (std::max)(indices.drawnEnd, static_cast<uint32_t>(indexEnd));
+}
+
+void framesim::RecordingDevice::Reset() {
+    if (vertices.exists || indices.exists) {
+        Violation("Reset with default-pool buffers alive");
+    }
+    if (stateBlocks) {
+        Violation("Reset with state blocks alive");
+    }
+    if (inOverlay) {
+        Violation("Reset between BeginOverlay and EndOverlay");
+    }
+    // Default-pool textures are gone as well; managed ones (the font atlas) survive
+    textures.clear();
+}
+
+framesim::DeviceCounters framesim::RecordingDevice::EndFrame() {
+    if (inOverlay) {
+        Violation("Present between BeginOverlay and EndOverlay");
+    }
+    if (vertices.locked || indices.locked) {
+        Violation("Present with a buffer locked");
+    }
+
+    for (const RecordedDraw& draw : draws) {
+        const uint64_t indexEnd = static_cast<uint64_t>(draw.startIndex) + draw.primitiveCount * 3ull;
+        for (uint64_t i = draw.startIndex; i < indexEnd; i++) {
+            if (indices.data[i] >= draw.vertexCount) {
+                Violation("index outside the draw's vertex range");
+                break;
+            }
+        }
+    }
+    draws.clear();
+
+    const DeviceCounters counters = current;
+    totals.Add(counters);
+    current = DeviceCounters();
+    frame++;
+    return counters;
+}
\ No newline at end of file
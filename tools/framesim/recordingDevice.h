@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Rendering/overlayRenderer.h"
+
+// IRenderDevice that records instead of drawing.
+// Buffers are plain memory, so uploads and draws can be checked; every call is counted per frame
+// and checked against the rules Direct3D 9 enforces (or silently breaks on): lock pairing,
+// no-overwrite locks never touching data an earlier draw may still read, draws only inside
+// BeginOverlay/EndOverlay with every index inside the uploaded data, and no default-pool
+// object alive across a device Reset.
+namespace framesim {
+    struct DeviceCounters {
+        uint64_t draws = 0;
+        uint64_t primitives = 0;
+        uint64_t vertexBytes = 0;       // Bytes locked for writing
+        uint64_t indexBytes = 0;
+        uint64_t locks = 0;
+        uint64_t discardLocks = 0;
+        uint64_t textureChanges = 0;
+        uint64_t scissorChanges = 0;
+        uint64_t stateApplies = 0;      // State block Capture/Apply calls
+        uint64_t bufferCreations = 0;
+        uint64_t stateBlockCreations = 0;
+
+        void Add(const DeviceCounters& other);
+    };
+
+    class RecordingDevice final : public render::IRenderDevice {
+    public:
+        bool CreateBuffers(uint32_t vertexCapacity, uint32_t indexCapacity) override;
+        void ReleaseBuffers() override;
+        bool CreateStateBlocks() override;
+        void ReleaseStateBlocks() override;
+
+        render::Vertex* LockVertices(uint32_t first, uint32_t count, bool discard) override;
+        void UnlockVertices() override;
+        uint16_t* LockIndices(uint32_t first, uint32_t count, bool discard) override;
+        void UnlockIndices() override;
+
+        void BeginOverlay(const render::FrameView& frame) override;
+        void EndOverlay() override;
+
+        void SetTexture(uint64_t texture) override;
+        void SetScissor(const render::ScissorRect& scissor) override;
+        void DrawIndexed(uint32_t baseVertex, uint32_t vertexCount, uint32_t startIndex, uint32_t primitiveCount) override;
+
+        /**
+         * @brief Simulate IDirect3DDevice9::Reset: every default-pool object must be released
+         */
+        void Reset();
+
+        /**
+         * @brief Simulate Present: close the frame's counters (and check nothing is left open)
+         */
+        DeviceCounters EndFrame();
+
+        /**
+         * @brief Make a texture id valid (textures the device knows about)
+         * @param managed D3DPOOL_MANAGED: restored by the runtime, so it stays valid across Reset
+         */
+        void AddTexture(uint64_t texture, bool managed = false) {
+            (managed ? managedTextures : textures).push_back(texture);
+        }
+
+        const DeviceCounters& Totals() const { return totals; }
+        const std::vector<std::string>& Violations() const { return violations; }
+        uint64_t Frame() const { return frame; }
+
+    private:
+        /**
+         * @brief Memory standing in for a dynamic buffer
+         */
+        template<typename T>
+        struct Ring {
+            std::vector<T> data;
+            bool exists = false;
+            bool locked = false;
+            uint32_t written = 0;       // End of the data written since the last discard
+            uint32_t drawnEnd = 0;      // End of the data read by draws since the last discard
+        };
+
+        template<typename T>
+        T* Lock(Ring<T>& ring, uint32_t first, uint32_t count, bool discard, uint64_t& bytes, const char* name);
+
+        template<typename T>
+        void Unlock(Ring<T>& ring, const char* name);
+
+        void Violation(const std::string& message);
+
+        struct RecordedDraw {
+            uint32_t vertexCount;
+            uint32_t startIndex;
+            uint32_t primitiveCount;
+        };
+
+        Ring<render::Vertex> vertices;
+        Ring<uint16_t> indices;
+        bool stateBlocks = false;
+        bool inOverlay = false;
+        uint64_t boundTexture = 0;
+        bool scissorSet = false;
+        std::vector<uint64_t> textures;
+        std::vector<uint64_t> managedTextures;
+        std::vector<RecordedDraw> draws;    // This frame's draws, index-checked at EndFrame
+
+        uint64_t frame = 0;
+        DeviceCounters current;
+        DeviceCounters totals;
+        std::vector<std::string> violations;
+    };
+}
\ No newline at end of file
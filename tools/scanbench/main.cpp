@@ -0,0 +1,596 @@
+// scanbench: throughput benchmarks for the signature scanners.
+// Every scanner variant (reference, scalar, SSE2, AVX2, multi-signature, parallel) is run over
+// synthetic buffers across pattern length, wildcard density, match position and buffer size,
+// and optionally over real PE images. Results are printed as a table and can be written as
+// JSON and compared against a previous run to catch regressions between commits. Every variant's
+// result is also checked once against the reference scanner, so a broken fast path fails the run
+// instead of showing up as a speedup.
+//
+// Usage: scanbench [--sizes 1,16,256] [--threads N] [--min-time SECONDS] [--image DLL]...
+//                  [--filter TEXT] [--json OUT] [--compare BASELINE] [--tolerance PERCENT]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Core/workerPool.h"
+#include "Scanning/imageScanner.h"
+#include "Scanning/leaResolver.h"
+#include "Scanning/mappedImage.h"
+#include "Scanning/multiPatternScanner.h"
+#include "Scanning/overlaySignatures.h"
+#include "Scanning/parallelScanner.h"
+#include "Scanning/patternScanner.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t MB = 1024 * 1024;
+    constexpr size_t MIN_ITERATIONS = 3;
+    constexpr size_t MAX_ITERATIONS = 1000;
+    constexpr size_t MULTI_SIGNATURE_COUNT = 8;    // Signatures per multi-signature benchmark
+    constexpr size_t EARLY_MATCH_OFFSET = 4096;
+    constexpr uint64_t SYNTHETIC_SEED = 0x5EC12E7;  // Fixed so every run scans identical data
+
+    struct Options {
+        std::vector<size_t> sizesMb = { 1, 16, 256 };
+        size_t threads = 0;
+        double minTime = 0.25;
+        std::vector<std::string> images;
+        std::string filter;
+        std::string jsonPath;
+        std::string comparePath;
+        double tolerance = 10.0;
+    };
+
+    struct Result {
+        std::string name;
+        std::string variant;
+        size_t bytes = 0;           // Bytes one iteration scans
+        size_t iterations = 0;
+        double bestSeconds = 0.0;
+        double medianSeconds = 0.0;
+
+        double Gbps() const { return bestSeconds > 0.0 ? static_cast<double>(bytes) / bestSeconds / 1e9 : 0.0; }
+    };
+
+    /**
+     * @brief Run fn until minTime has elapsed (at least MIN_ITERATIONS times) and keep the timings
+     */
+    Result Measure(const std::string& name, const std::string& variant, size_t bytes, double minTime, const std::function<void()>& fn) {
+        std::vector<double> samples;
+        const Clock::time_point start = Clock::now();
+        while (samples.size() < MIN_ITERATIONS ||
+            (samples.size() < MAX_ITERATIONS && std::chrono::duration<double>(Clock::now() - start).count() < minTime)) {
+            const Clock::time_point runStart = Clock::now();
+            fn();
+            samples.push_back(std::chrono::duration<double>(Clock::now() - runStart).count());
+        }
+
+        std::sort(samples.begin(), samples.end());
+        Result result;
+        result.name = name;
+        result.variant = variant;
+        result.bytes = bytes;
+        result.iterations = samples.size();
+        result.bestSeconds = samples.front();
+        result.medianSeconds = samples[samples.size() / 2];
+        return result;
+    }
+
+    /**
+     * @brief Keep the optimizer from discarding scan results
+     */
+    volatile uintptr_t g_sink = 0;
+
+    /**
+     * @brief Random bytes skewed towards common x64 opcode bytes, like a real .text section
+     * Drawn with ByteCommonness weights so anchor selection faces a realistic distribution.
+     */
+    std::vector<uint8_t> MakeSyntheticCode(size_t size, uint64_t seed) {
+        std::vector<double> weights(256);
+        for (int value = 0; value < 256; value++) {
+            weights[value] = scanner::ByteCommonness(static_cast<uint8_t>(value));
+        }
+
+        std::mt19937_64 random(seed);
+        std::discrete_distribution<int> byteDistribution(weights.begin(), weights.end());
+        std::vector<uint8_t> buffer(size);
+        for (uint8_t& value : buffer) {
+            value = static_cast<uint8_t>(byteDistribution(random));
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Random pattern text of a given length and wildcard density, first and last byte fixed
+     */
+    std::string MakePatternText(size_t length, double wildcardDensity, std::mt19937_64& random) {
+        std::uniform_int_distribution<int> byteValue(0, 255);
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+        std::string text;
+        for (size_t i = 0; i < length; i++) {
+            if (i) {
+                text += ' ';
+            }
+            if (i && i + 1 < length && chance(random) < wildcardDensity) {
+                text += '?';
+            }
+            else {
+                char hex[3];
+                std::snprintf(hex, sizeof(hex), "%02X", byteValue(random));
+                text += hex;
+            }
+        }
+        return text;
+    }
+
+    /**
+     * @brief Write the fixed bytes of a pattern into a buffer so it matches there
+     */
+    void PlantPattern(std::vector<uint8_t>& buffer, size_t offset, const scanner::Pattern& pattern) {
+        for (size_t i = 0; i < pattern.length; i++) {
+            if (pattern.mask[i]) {
+                buffer[offset + i] = pattern.bytes[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Lowest match of a pattern over the given sections, from the reference scanner
+     */
+    const uint8_t* ReferenceImageScan(const uint8_t* image, const pe::ImageInfo& info, const scanner::Pattern& pattern, uint32_t sections) {
+        for (const pe::RvaRange& range : pe::SectionRanges(info, sections)) {
+            const uint8_t* match = scanner::ScanReference(image + range.begin, image + range.end, pattern);
+            if (match) {
+                return match;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Bytes a first-match scan reads before stopping
+     */
+    size_t BytesScanned(const uint8_t* begin, const uint8_t* end, const uint8_t* match, const scanner::Pattern& pattern) {
+        return match ? static_cast<size_t>(match - begin) + pattern.length : static_cast<size_t>(end - begin);
+    }
+
+    class Suite {
+    public:
+        Suite(const Options& options, core::WorkerPool& pool) : options(options), pool(pool) {}
+
+        void Add(Result result) {
+            std::printf("%-48s %-10s %10.2f MB %7zu it %10.3f ms %8.2f GB/s\n", result.name.c_str(), result.variant.c_str(),
+                static_cast<double>(result.bytes) / MB, result.iterations, result.bestSeconds * 1000.0, result.Gbps());
+            std::fflush(stdout);
+            results.push_back(std::move(result));
+        }
+
+        bool Selected(const std::string& name) const {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        }
+
+        /**
+         * @brief Record whether a variant returned the reference result
+         */
+        void Verify(const std::string& name, const std::string& variant, bool matches, const std::string& detail) {
+            if (!matches) {
+                std::printf("%-48s %-10s MISMATCH: %s\n", name.c_str(), variant.c_str(), detail.c_str());
+                mismatches++;
+            }
+        }
+
+        /**
+         * @brief Verify a first-match result against the reference match
+         */
+        void Verify(const std::string& name, const std::string& variant, const uint8_t* begin, const uint8_t* match, const uint8_t* expected) {
+            auto offset = [begin](const uint8_t* position) { return position ? std::to_string(position - begin) : std::string("none"); };
+            Verify(name, variant, match == expected, "offset " + offset(match) + ", reference " + offset(expected));
+        }
+
+        /**
+         * @brief Every single-pattern variant over one buffer
+         */
+        void RunSingle(const std::string& name, const uint8_t* begin, const uint8_t* end, const scanner::Pattern& pattern, bool includeReference) {
+            if (!Selected(name)) {
+                return;
+            }
+
+            // Run once even when it is not timed: every variant must return the same match
+            const uint8_t* expected = scanner::ScanReference(begin, end, pattern);
+            const size_t bytes = BytesScanned(begin, end, expected, pattern);
+            if (includeReference) {
+                Add(Measure(name, "reference", bytes, options.minTime, [&]() { g_sink = g_sink + reinterpret_cast<uintptr_t>(scanner::ScanReference(begin, end, pattern)); }));
+            }
+
+            const uint8_t* match = nullptr;
+            const scanner::ScanBackend backends[] = { scanner::ScanBackend::Scalar, scanner::ScanBackend::SSE2, scanner::ScanBackend::AVX2 };
+            for (scanner::ScanBackend backend : backends) {
+                if (backend > scanner::GetActiveBackend()) {
+                    continue;
+                }
+                Add(Measure(name, scanner::BackendName(backend), bytes, options.minTime, [&]() {
+                    match = scanner::ScanWithBackend(backend, begin, end, pattern);
+                    g_sink = g_sink + reinterpret_cast<uintptr_t>(match);
+                }));
+                Verify(name, scanner::BackendName(backend), begin, match, expected);
+            }
+
+            Add(Measure(name, "parallel", bytes, options.minTime, [&]() {
+                match = scanner::ScanParallel(begin, end, pattern, pool);
+                g_sink = g_sink + reinterpret_cast<uintptr_t>(match);
+            }));
+            Verify(name, "parallel", begin, match, expected);
+        }
+
+        /**
+         * @brief Multi-signature variants (serial and parallel) over one buffer
+         */
+        void RunMulti(const std::string& name, const uint8_t* begin, const uint8_t* end, const scanner::SignatureSet& signatures) {
+            if (!Selected(name)) {
+                return;
+            }
+
+            const size_t bytes = static_cast<size_t>(end - begin);
+            std::vector<scanner::SignatureHits> serial;
+            std::vector<scanner::SignatureHits> parallel;
+            Add(Measure(name, "multi", bytes, options.minTime, [&]() {
+                serial = signatures.ScanAll(begin, end);
+                g_sink = g_sink + serial.size();
+            }));
+            Add(Measure(name, "multi-par", bytes, options.minTime, [&]() {
+                parallel = scanner::ScanAllParallel(begin, end, signatures, pool);
+                g_sink = g_sink + parallel.size();
+            }));
+
+            // First hit of each signature against the reference; the parallel scan must find every serial hit
+            for (size_t i = 0; i < signatures.Size(); i++) {
+                const uint8_t* expected = scanner::ScanReference(begin, end, signatures.PatternAt(i));
+                const bool found = i < serial.size() && !serial[i].hits.empty();
+                Verify(name, "multi", begin, found ? serial[i].hits.front() : nullptr, expected);
+                Verify(name, "multi-par", i < parallel.size() && i < serial.size() && parallel[i].hits == serial[i].hits,
+                    std::string("hits of ") + signatures.NameAt(i) + " differ from the serial scan");
+            }
+        }
+
+        const std::vector<Result>& Results() const { return results; }
+
+        size_t Mismatches() const { return mismatches; }
+
+    private:
+        const Options& options;
+        core::WorkerPool& pool;
+        std::vector<Result> results;
+        size_t mismatches = 0;
+    };
+
+    void RunSynthetic(Suite& suite, const Options& options) {
+        const size_t lengths[] = { 8, 16, 32, 64 };
+        const double densities[] = { 0.0, 0.25, 0.5 };
+
+        for (size_t sizeMb : options.sizesMb) {
+            const size_t size = sizeMb * MB;
+            std::vector<uint8_t> buffer = MakeSyntheticCode(size, SYNTHETIC_SEED);
+            std::mt19937_64 random(SYNTHETIC_SEED + sizeMb);
+
+            for (size_t length : lengths) {
+                for (double density : densities) {
+                    scanner::Pattern pattern;
+                    if (!scanner::CompilePattern(MakePatternText(length, density, random).c_str(), pattern)) {
+                        continue;
+                    }
+
+                    struct Position {
+                        const char* name;
+                        size_t offset;  // SIZE_MAX = not planted
+                    };
+                    const Position positions[] = {
+                        { "early", EARLY_MATCH_OFFSET },
+                        { "late", size - EARLY_MATCH_OFFSET },
+                        { "absent", SIZE_MAX },
+                    };
+
+                    for (const Position& position : positions) {
+                        char name[96];
+                        std::snprintf(name, sizeof(name), "synthetic/%zuMB/len%zu/wild%02d/%s", sizeMb, length,
+                            static_cast<int>(density * 100), position.name);
+                        if (!suite.Selected(name)) {
+                            continue;
+                        }
+
+                        // Plant in place and restore afterwards so the absent case stays clean
+                        std::vector<uint8_t> saved;
+                        if (position.offset != SIZE_MAX) {
+                            saved.assign(buffer.begin() + position.offset, buffer.begin() + position.offset + pattern.length);
+                            PlantPattern(buffer, position.offset, pattern);
+                        }
+
+                        // The byte-by-byte reference takes seconds per pass on large buffers
+                        suite.RunSingle(name, buffer.data(), buffer.data() + size, pattern, sizeMb <= 16);
+
+                        if (!saved.empty()) {
+                            std::copy(saved.begin(), saved.end(), buffer.begin() + position.offset);
+                        }
+                    }
+                }
+            }
+
+            // Multi-signature cost should stay flat as signatures are added
+            const size_t counts[] = { 2, MULTI_SIGNATURE_COUNT, 32 };
+            for (size_t count : counts) {
+                std::vector<std::string> texts;
+                scanner::SignatureSet signatures;
+                for (size_t i = 0; i < count; i++) {
+                    texts.push_back(MakePatternText(8 + i % 4 * 4, 0.25, random));
+                }
+                for (size_t i = 0; i < count; i++) {
+                    signatures.Add(texts[i].c_str(), texts[i].c_str());
+                }
+
+                char name[96];
+                std::snprintf(name, sizeof(name), "synthetic/%zuMB/multi%zu", sizeMb, count);
+                suite.RunMulti(name, buffer.data(), buffer.data() + size, signatures);
+            }
+        }
+    }
+
+    void RunImages(Suite& suite, const Options& options, core::WorkerPool& pool) {
+        for (const std::string& path : options.images) {
+            pe::MappedImage image;
+            if (!image.Load(path.c_str())) {
+                std::fprintf(stderr, "Skipping %s: not a readable PE image\n", path.c_str());
+                continue;
+            }
+
+            std::string baseName = path.substr(path.find_last_of("/\\") + 1);
+            const uint8_t* data = image.Data();
+            const pe::ImageInfo& info = image.Info();
+
+            scanner::SignatureSet signatures;
+            for (const scanner::Signature* signature : overlaySignatures::ALL) {
+                signatures.Add(signature->name, signature->pattern, signature->sections);
+
+                // Whole image, as the original FindPattern did, and code sections only
+                suite.RunSingle("image/" + baseName + "/" + signature->name + "/whole", data, data + image.Size(), signature->pattern, true);
+
+                const std::string sectionName = "image/" + baseName + "/" + signature->name + "/code";
+                if (suite.Selected(sectionName)) {
+                    const size_t codeBytes = scanner::ScannedBytes(info, signature->sections);
+                    const uint8_t* match = nullptr;
+                    suite.Add(Measure(sectionName, "sections", codeBytes, options.minTime, [&]() {
+                        match = scanner::ScanImage(data, info, signature->pattern, signature->sections, pool);
+                        g_sink = g_sink + reinterpret_cast<uintptr_t>(match);
+                    }));
+                    suite.Verify(sectionName, "sections", data, match, ReferenceImageScan(data, info, signature->pattern, signature->sections));
+                }
+            }
+
+            // Full startup resolution: one section-aware pass for every signature plus LEA resolution
+            const std::string resolveName = "image/" + baseName + "/resolve-all";
+            if (suite.Selected(resolveName)) {
+                const size_t codeBytes = scanner::ScannedBytes(info, signatures.CombinedSections());
+                suite.Add(Measure(resolveName, "resolve", codeBytes, options.minTime, [&]() {
+                    for (const scanner::SignatureHits& hits : scanner::ScanImageAll(data, info, signatures, pool)) {
+                        g_sink = g_sink + scanner::ResolveFromHits(data, info, hits).functionRva;
+                    }
+                }));
+            }
+        }
+    }
+
+    std::string JsonEscape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    /**
+     * @brief Results as JSON, one benchmark object per line (ReadBaseline relies on that)
+     */
+    bool WriteJson(const std::string& path, const std::vector<Result>& results, size_t threads) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        file << "{\n";
+        file << "  \"context\": { \"backend\": \"" << scanner::BackendName(scanner::GetActiveBackend())
+             << "\", \"threads\": " << threads << ", \"chunk_size\": " << scanner::PARALLEL_CHUNK_SIZE << " },\n";
+        file << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+            char numbers[256];
+            std::snprintf(numbers, sizeof(numbers),
+                "\"bytes\": %zu, \"iterations\": %zu, \"best_seconds\": %.9f, \"median_seconds\": %.9f, \"gbps\": %.4f",
+                result.bytes, result.iterations, result.bestSeconds, result.medianSeconds, result.Gbps());
+            file << "    { \"name\": \"" << JsonEscape(result.name) << "\", \"variant\": \"" << JsonEscape(result.variant) << "\", "
+                 << numbers << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief Read "name/variant" -> GB/s from a file written by WriteJson
+     */
+    bool ReadBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        auto field = [](const std::string& line, const char* key) -> std::string {
+            const std::string marker = std::string("\"") + key + "\": ";
+            size_t position = line.find(marker);
+            if (position == std::string::npos) {
+                return std::string();
+            }
+            position += marker.size();
+            if (line[position] == '"') {
+                const size_t close = line.find('"', position + 1);
+                return close == std::string::npos ? std::string() : line.substr(position + 1, close - position - 1);
+            }
+            return line.substr(position, line.find_first_of(",}", position) - position);
+        };
+
+        std::string line;
+        while (std::getline(file, line)) {
+            const std::string name = field(line, "name");
+            const std::string variant = field(line, "variant");
+            const std::string gbps = field(line, "gbps");
+            if (!name.empty() && !variant.empty() && !gbps.empty()) {
+                baseline[name + " " + variant] = std::atof(gbps.c_str());
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Print throughput changes against a baseline run
+     * @return Number of benchmarks slower than the baseline by more than the tolerance
+     */
+    size_t Compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline, double tolerance) {
+        size_t regressions = 0;
+        std::printf("\n%-59s %10s %10s %8s\n", "benchmark", "baseline", "current", "change");
+        for (const Result& result : results) {
+            const auto it = baseline.find(result.name + " " + result.variant);
+            if (it == baseline.end() || it->second <= 0.0) {
+                continue;
+            }
+
+            const double change = (result.Gbps() / it->second - 1.0) * 100.0;
+            const bool regressed = change < -tolerance;
+            regressions += regressed;
+            std::printf("%-48s %-10s %10.2f %10.2f %+7.1f%%%s\n", result.name.c_str(), result.variant.c_str(), it->second, result.Gbps(),
+                change, regressed ? "  REGRESSION" : "");
+        }
+        return regressions;
+    }
+
+    std::vector<size_t> ParseSizes(const char* text) {
+        std::vector<size_t> sizes;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            const size_t size = std::strtoul(item.c_str(), nullptr, 10);
+            if (size) {
+                sizes.push_back(size);
+            }
+        }
+        return sizes;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const bool hasValue = i + 1 < argc;
+            if (!std::strcmp(argv[i], "--sizes") && hasValue) {
+                options.sizesMb = ParseSizes(argv[++i]);
+            }
+            else if (!std::strcmp(argv[i], "--threads") && hasValue) {
+                options.threads = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (!std::strcmp(argv[i], "--min-time") && hasValue) {
+                options.minTime = std::atof(argv[++i]);
+            }
+            else if (!std::strcmp(argv[i], "--image") && hasValue) {
+                options.images.push_back(argv[++i]);
+            }
+            else if (!std::strcmp(argv[i], "--filter") && hasValue) {
+                options.filter = argv[++i];
+            }
+            else if (!std::strcmp(argv[i], "--json") && hasValue) {
+                options.jsonPath = argv[++i];
+            }
+            else if (!std::strcmp(argv[i], "--compare") && hasValue) {
+                options.comparePath = argv[++i];
+            }
+            else if (!std::strcmp(argv[i], "--tolerance") && hasValue) {
+                options.tolerance = std::atof(argv[++i]);
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void PrintUsage(const char* program) {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --sizes 1,16,256    Synthetic buffer sizes in MB\n"
+            "  --threads N         Worker threads for parallel variants (default: same as the injected DLL)\n"
+            "  --min-time SECONDS  Minimum time per benchmark (default: 0.25)\n"
+            "  --image DLL         Also benchmark against a PE image (repeatable)\n"
+            "  --filter TEXT       Only run benchmarks whose name contains TEXT\n"
+            "  --json OUT          Write results as JSON\n"
+            "  --compare BASELINE  Compare against a previous --json file\n"
+            "  --tolerance PERCENT Slowdown treated as a regression (default: 10)\n"
+            "Exit code: 1 on a regression, 2 on an I/O error, 3 if a variant disagrees with the reference scanner\n",
+            program);
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    std::unique_ptr<core::WorkerPool> ownedPool;
+    if (options.threads) {
+        ownedPool.reset(new core::WorkerPool(options.threads));
+    }
+    core::WorkerPool& pool = ownedPool ? *ownedPool : *core::GetWorkerPool();
+
+    std::printf("backend %s, %zu worker thread(s), min time %.2f s\n\n", scanner::BackendName(scanner::GetActiveBackend()),
+        pool.ThreadCount(), options.minTime);
+
+    Suite suite(options, pool);
+    RunSynthetic(suite, options);
+    RunImages(suite, options, pool);
+
+    int exitCode = 0;
+    if (!options.jsonPath.empty() && !WriteJson(options.jsonPath, suite.Results(), pool.ThreadCount())) {
+        std::fprintf(stderr, "Failed to write %s\n", options.jsonPath.c_str());
+        exitCode = 2;
+    }
+
+    if (!options.comparePath.empty()) {
+        std::map<std::string, double> baseline;
+        if (!ReadBaseline(options.comparePath, baseline)) {
+            std::fprintf(stderr, "Failed to read %s\n", options.comparePath.c_str());
+            exitCode = 2;
+        }
+        else if (Compare(suite.Results(), baseline, options.tolerance)) {
+            exitCode = exitCode ? exitCode : 1;
+        }
+    }
+
+    // Wrong results make every timing meaningless
+    if (suite.Mismatches()) {
+        std::fprintf(stderr, "%zu variant result(s) differ from the reference scanner\n", suite.Mismatches());
+        exitCode = 3;
+    }
+
+    ownedPool.reset();
+    core::ShutdownWorkerPool();
+    return exitCode;
+}
\ No newline at end of file
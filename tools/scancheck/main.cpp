@@ -0,0 +1,573 @@
+// scancheck: correctness checks for the signature scanners.
+// Every fast path is compared with a plain reference over randomized data: each scan backend
+// against ScanReference, SignatureSet::ScanAll against repeated single scans, the parallel scans
+// against the serial ones (with matches planted across chunk boundaries), section-aware image
+// scans against a synthetic PE image, and the x64 decoder against hand-assembled instructions.
+// Exits non-zero on the first kind of check that finds a difference.
+//
+// Usage: scancheck [--seed N] [--rounds N] [--threads N]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Core/workerPool.h"
+#include "Scanning/imageScanner.h"
+#include "Scanning/multiPatternScanner.h"
+#include "Scanning/parallelScanner.h"
+#include "Scanning/patternScanner.h"
+#include "Scanning/peImage.h"
+#include "Scanning/x64Decoder.h"
+
+namespace {
+    constexpr uint64_t DEFAULT_SEED = 0x5CA7C4EC;
+    constexpr size_t DEFAULT_ROUNDS = 2000;
+    constexpr size_t MAX_REPORTED_FAILURES = 10;    // Per check; the rest are only counted
+
+    struct Options {
+        uint64_t seed = DEFAULT_SEED;
+        size_t rounds = DEFAULT_ROUNDS;
+        size_t threads = 4;
+    };
+
+    /**
+     * @brief Failures of one named check
+     */
+    class Check {
+    public:
+        explicit Check(const char* name) : name(name) {}
+
+        void Expect(bool condition, const std::string& what) {
+            cases++;
+            if (condition) {
+                return;
+            }
+            if (failures++ < MAX_REPORTED_FAILURES) {
+                std::printf("  FAIL %s: %s\n", name, what.c_str());
+            }
+        }
+
+        bool Report() const {
+            std::printf("%-12s %8zu cases %6zu failures\n", name, cases, failures);
+            return failures == 0;
+        }
+
+    private:
+        const char* name;
+        size_t cases = 0;
+        size_t failures = 0;
+    };
+
+    std::string Offset(const uint8_t* begin, const uint8_t* match) {
+        return match ? std::to_string(match - begin) : std::string("none");
+    }
+
+    /**
+     * @brief Low-entropy random bytes, so short patterns match by chance as well as where planted
+     */
+    std::vector<uint8_t> MakeBuffer(size_t size, std::mt19937_64& random) {
+        std::uniform_int_distribution<int> byteValue(0, 7);
+        std::vector<uint8_t> buffer(size);
+        for (uint8_t& value : buffer) {
+            value = static_cast<uint8_t>(byteValue(random) * 0x25);
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Random pattern text from the buffer's alphabet, first byte fixed
+     */
+    std::string MakePatternText(size_t length, double wildcardDensity, std::mt19937_64& random) {
+        std::uniform_int_distribution<int> byteValue(0, 7);
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+        std::string text;
+        for (size_t i = 0; i < length; i++) {
+            if (i) {
+                text += ' ';
+            }
+            if (i && chance(random) < wildcardDensity) {
+                text += '?';
+            }
+            else {
+                char hex[3];
+                std::snprintf(hex, sizeof(hex), "%02X", byteValue(random) * 0x25);
+                text += hex;
+            }
+        }
+        return text;
+    }
+
+    void PlantPattern(uint8_t* position, const scanner::Pattern& pattern) {
+        for (size_t i = 0; i < pattern.length; i++) {
+            if (pattern.mask[i]) {
+                position[i] = pattern.bytes[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Every match in [begin, end), from repeated reference scans
+     */
+    std::vector<const uint8_t*> ReferenceHits(const uint8_t* begin, const uint8_t* end, const scanner::Pattern& pattern) {
+        std::vector<const uint8_t*> hits;
+        for (const uint8_t* match = scanner::ScanReference(begin, end, pattern); match;
+            match = scanner::ScanReference(match + 1, end, pattern)) {
+            hits.push_back(match);
+        }
+        return hits;
+    }
+
+    /**
+     * @brief Offsets worth planting at: both ends, vector-width edges and random spots
+     */
+    std::vector<size_t> PlantOffsets(size_t size, size_t length, std::mt19937_64& random) {
+        std::vector<size_t> offsets;
+        if (size < length) {
+            return offsets;
+        }
+        const size_t last = size - length;
+        offsets.push_back(0);
+        offsets.push_back(last);
+        const size_t edges[] = { 15, 16, 31, 32, 33, 63, 64 };
+        for (size_t edge : edges) {
+            if (edge <= last) {
+                offsets.push_back(edge);
+                offsets.push_back(last - edge);
+            }
+        }
+        std::uniform_int_distribution<size_t> anywhere(0, last);
+        offsets.push_back(anywhere(random));
+        return offsets;
+    }
+
+    /**
+     * @brief Scalar, SSE2 and AVX2 backends (where the CPU has them) against ScanReference
+     */
+    bool CheckBackends(const Options& options, std::mt19937_64& random) {
+        Check check("backends");
+        const scanner::ScanBackend backends[] = { scanner::ScanBackend::Scalar, scanner::ScanBackend::SSE2, scanner::ScanBackend::AVX2 };
+        std::uniform_int_distribution<size_t> sizes(0, 300);
+        std::uniform_int_distribution<size_t> lengths(1, scanner::MAX_PATTERN_LENGTH);
+        std::uniform_real_distribution<double> densities(0.0, 0.6);
+        std::uniform_int_distribution<size_t> misalignment(0, 31);
+
+        for (size_t round = 0; round < options.rounds; round++) {
+            scanner::Pattern pattern;
+            const std::string text = MakePatternText(lengths(random), densities(random), random);
+            if (!scanner::CompilePattern(text.c_str(), pattern)) {
+                check.Expect(false, "pattern did not compile: " + text);
+                continue;
+            }
+
+            // Unaligned starts exercise the vector head/tail handling
+            const size_t skew = misalignment(random);
+            std::vector<uint8_t> storage = MakeBuffer(skew + sizes(random), random);
+            const size_t size = storage.size() - skew;
+            std::vector<size_t> offsets = PlantOffsets(size, pattern.length, random);
+            offsets.push_back(SIZE_MAX);    // Unplanted: only chance matches, if any
+
+            for (size_t offset : offsets) {
+                std::vector<uint8_t> buffer = storage;
+                const uint8_t* begin = buffer.data() + skew;
+                const uint8_t* end = begin + size;
+                if (offset != SIZE_MAX) {
+                    PlantPattern(buffer.data() + skew + offset, pattern);
+                }
+
+                const uint8_t* expected = scanner::ScanReference(begin, end, pattern);
+                for (scanner::ScanBackend backend : backends) {
+                    if (backend > scanner::GetActiveBackend()) {
+                        continue;
+                    }
+                    const uint8_t* match = scanner::ScanWithBackend(backend, begin, end, pattern);
+                    check.Expect(match == expected, std::string(scanner::BackendName(backend)) + " \"" + text + "\" over " +
+                        std::to_string(size) + " bytes: " + Offset(begin, match) + ", reference " + Offset(begin, expected));
+                }
+                const uint8_t* match = scanner::Scan(begin, end, pattern);
+                check.Expect(match == expected, "Scan \"" + text + "\": " + Offset(begin, match) + ", reference " + Offset(begin, expected));
+            }
+        }
+        return check.Report();
+    }
+
+    /**
+     * @brief SignatureSet::ScanAll against repeated single scans of each signature
+     */
+    bool CheckSignatureSet(const Options& options, std::mt19937_64& random) {
+        Check check("multi");
+        std::uniform_int_distribution<size_t> counts(1, 48);
+        std::uniform_int_distribution<size_t> lengths(2, 12);
+        std::uniform_int_distribution<size_t> sizes(0, 8192);
+        std::uniform_real_distribution<double> densities(0.0, 0.5);
+        const size_t rounds = (std::max)(options.rounds / 10, static_cast<size_t>(1));
+
+        for (size_t round = 0; round < rounds; round++) {
+            std::vector<std::string> texts(counts(random));
+            std::vector<uint8_t> buffer = MakeBuffer(sizes(random), random);
+            scanner::SignatureSet signatures;
+            for (size_t i = 0; i < texts.size(); i++) {
+                texts[i] = MakePatternText(lengths(random), densities(random), random);
+                check.Expect(signatures.Add(texts[i].c_str(), texts[i].c_str()), "signature did not compile: " + texts[i]);
+                // Tables are built by the first scan; signatures added after it must still be found
+                if (i == texts.size() / 2) {
+                    signatures.ScanAll(buffer.data(), buffer.data() + buffer.size());
+                }
+            }
+
+            for (size_t i = 0; i < signatures.Size(); i++) {
+                const scanner::Pattern& pattern = signatures.PatternAt(i);
+                for (size_t offset : PlantOffsets(buffer.size(), pattern.length, random)) {
+                    PlantPattern(buffer.data() + offset, pattern);
+                }
+            }
+
+            const uint8_t* begin = buffer.data();
+            const uint8_t* end = begin + buffer.size();
+            const std::vector<scanner::SignatureHits> results = signatures.ScanAll(begin, end);
+            check.Expect(results.size() == signatures.Size(), "ScanAll returned " + std::to_string(results.size()) + " entries");
+            for (size_t i = 0; i < results.size() && i < signatures.Size(); i++) {
+                const std::vector<const uint8_t*> expected = ReferenceHits(begin, end, signatures.PatternAt(i));
+                check.Expect(results[i].hits == expected, std::string("\"") + signatures.NameAt(i) + "\" over " + std::to_string(buffer.size()) +
+                    " bytes: " + std::to_string(results[i].hits.size()) + " hits, reference " + std::to_string(expected.size()));
+            }
+        }
+        return check.Report();
+    }
+
+    /**
+     * @brief ScanParallel and ScanAllParallel against serial scans, matches straddling every chunk boundary
+     */
+    bool CheckParallel(const Options& options, core::WorkerPool& pool, std::mt19937_64& random) {
+        Check check("parallel");
+        const size_t chunk = scanner::PARALLEL_CHUNK_SIZE;
+        const size_t sizes[] = { chunk - 1, 2 * chunk, 2 * chunk + 7, 5 * chunk + 12345 };
+        std::uniform_int_distribution<size_t> lengths(2, scanner::MAX_PATTERN_LENGTH);
+        std::uniform_real_distribution<double> densities(0.0, 0.5);
+        const size_t rounds = (std::max)(options.rounds / 200, static_cast<size_t>(2));
+
+        for (size_t size : sizes) {
+            std::vector<uint8_t> clean = MakeBuffer(size, random);
+            for (size_t round = 0; round < rounds; round++) {
+                scanner::Pattern pattern;
+                const std::string text = MakePatternText(lengths(random), densities(random), random);
+                if (!scanner::CompilePattern(text.c_str(), pattern)) {
+                    check.Expect(false, "pattern did not compile: " + text);
+                    continue;
+                }
+
+                // One plant per boundary, at a random overlap, so the lowest match straddles chunks
+                std::vector<uint8_t> buffer = clean;
+                std::uniform_int_distribution<size_t> overlap(1, pattern.length - 1);
+                for (size_t boundary = chunk; boundary + pattern.length < size; boundary += chunk) {
+                    PlantPattern(buffer.data() + boundary - overlap(random), pattern);
+                }
+
+                const uint8_t* begin = buffer.data();
+                const uint8_t* end = begin + size;
+                const uint8_t* expected = scanner::Scan(begin, end, pattern);
+                const uint8_t* match = scanner::ScanParallel(begin, end, pattern, pool);
+                check.Expect(match == expected, "ScanParallel \"" + text + "\" over " + std::to_string(size) + " bytes: " +
+                    Offset(begin, match) + ", serial " + Offset(begin, expected));
+
+                scanner::SignatureSet signatures;
+                signatures.Add("planted", pattern);
+                const std::string other = MakePatternText(4, 0.0, random);
+                signatures.Add("chance", other.c_str());
+                const std::vector<scanner::SignatureHits> serial = signatures.ScanAll(begin, end);
+                const std::vector<scanner::SignatureHits> parallel = scanner::ScanAllParallel(begin, end, signatures, pool);
+                check.Expect(parallel.size() == serial.size(), "ScanAllParallel returned " + std::to_string(parallel.size()) + " entries");
+                for (size_t i = 0; i < parallel.size() && i < serial.size(); i++) {
+                    check.Expect(parallel[i].hits == serial[i].hits, std::string("ScanAllParallel \"") + signatures.NameAt(i) + "\" over " +
+                        std::to_string(size) + " bytes: " + std::to_string(parallel[i].hits.size()) + " hits, serial " + std::to_string(serial[i].hits.size()));
+                }
+            }
+        }
+
+        // Throwing tasks still finish their group, and Wait rethrows instead of spinning forever
+        std::atomic<size_t> ran{ 0 };
+        bool caught = false;
+        try {
+            core::ParallelFor(pool, 64, [&ran](size_t index) {
+                ran.fetch_add(1, std::memory_order_relaxed);
+                if (index % 16 == 3) {
+                    throw std::runtime_error("task failed");
+                }
+            });
+        }
+        catch (const std::runtime_error&) {
+            caught = true;
+        }
+        check.Expect(caught && ran.load() == 64, "ParallelFor with throwing tasks: " + std::to_string(ran.load()) + " of 64 ran" +
+            (caught ? "" : ", exception lost"));
+        return check.Report();
+    }
+
+    /**
+     * @brief Synthetic PE32+ image in virtual layout
+     */
+    class SyntheticImage {
+    public:
+        static constexpr uint32_t SIZE_OF_HEADERS = 0x1000;
+
+        SyntheticImage() : data(SIZE_OF_HEADERS, 0) {}
+
+        void AddSection(const char* name, uint32_t rva, uint32_t size, uint32_t characteristics) {
+            sections.push_back({ name, rva, size, characteristics });
+        }
+
+        /**
+         * @brief Lay out headers and section table; section contents are left zeroed
+         */
+        void Build() {
+            uint32_t sizeOfImage = SIZE_OF_HEADERS;
+            for (const Entry& section : sections) {
+                sizeOfImage = (std::max)(sizeOfImage, section.rva + section.size);
+            }
+            data.assign(sizeOfImage, 0);
+
+            constexpr uint32_t NT_OFFSET = 0x80;
+            constexpr uint16_t OPTIONAL_SIZE = 240;
+            Write16(0, 0x5A4D);
+            Write32(0x3C, NT_OFFSET);
+            Write32(NT_OFFSET, 0x00004550);
+            const uint32_t fileHeader = NT_OFFSET + 4;
+            Write16(fileHeader, 0x8664);
+            Write16(fileHeader + 2, static_cast<uint16_t>(sections.size()));
+            Write16(fileHeader + 16, OPTIONAL_SIZE);
+            const uint32_t optional = fileHeader + 20;
+            Write16(optional, 0x20B);
+            Write32(optional + 56, sizeOfImage);
+            Write32(optional + 60, SIZE_OF_HEADERS);
+
+            uint32_t header = optional + OPTIONAL_SIZE;
+            for (const Entry& section : sections) {
+                std::memcpy(&data[header], section.name, (std::min)(std::strlen(section.name), static_cast<size_t>(8)));
+                Write32(header + 8, section.size);
+                Write32(header + 12, section.rva);
+                Write32(header + 16, section.size);
+                Write32(header + 20, section.rva);
+                Write32(header + 36, section.characteristics);
+                header += 40;
+            }
+        }
+
+        std::vector<uint8_t> data;
+
+    private:
+        struct Entry {
+            const char* name;
+            uint32_t rva;
+            uint32_t size;
+            uint32_t characteristics;
+        };
+
+        void Write16(uint32_t offset, uint16_t value) {
+            data[offset] = static_cast<uint8_t>(value);
+            data[offset + 1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        void Write32(uint32_t offset, uint32_t value) {
+            Write16(offset, static_cast<uint16_t>(value));
+            Write16(offset + 2, static_cast<uint16_t>(value >> 16));
+        }
+
+        std::vector<Entry> sections;
+    };
+
+    /**
+     * @brief Section parsing, range merging and section-restricted scans on a synthetic image
+     */
+    bool CheckSections(core::WorkerPool& pool) {
+        Check check("sections");
+        constexpr uint32_t CODE = pe::SECTION_CNT_CODE | pe::SECTION_MEM_EXECUTE | pe::SECTION_MEM_READ;
+        constexpr uint32_t RDATA = pe::SECTION_CNT_INITIALIZED_DATA | pe::SECTION_MEM_READ;
+        constexpr uint32_t DATA = pe::SECTION_CNT_INITIALIZED_DATA | pe::SECTION_MEM_READ | pe::SECTION_MEM_WRITE;
+        constexpr uint32_t RELOC = pe::SECTION_CNT_INITIALIZED_DATA | pe::SECTION_MEM_READ | pe::SECTION_MEM_DISCARDABLE;
+
+        // Two touching code sections (merged into one range), then one section of every other kind
+        SyntheticImage image;
+        image.AddSection(".text", 0x1000, 0x3000, CODE);
+        image.AddSection(".text2", 0x4000, 0x1000, CODE);
+        image.AddSection(".rdata", 0x6000, 0x1000, RDATA);
+        image.AddSection(".data", 0x7000, 0x1000, DATA);
+        image.AddSection(".reloc", 0x8000, 0x1000, RELOC);
+        image.Build();
+
+        pe::ImageInfo info;
+        const bool parsed = pe::ParseImage(image.data.data(), image.data.size(), info);
+        check.Expect(parsed && info.is64Bit && info.sections.size() == 5 && info.sizeOfImage == 0x9000, "synthetic image did not parse");
+        if (!parsed) {
+            return check.Report();
+        }
+        check.Expect(!std::strcmp(info.sections[1].name, ".text2") && info.sections[2].virtualAddress == 0x6000, "section table read wrongly");
+
+        const std::vector<pe::RvaRange> code = pe::SectionRanges(info, pe::TARGET_CODE);
+        check.Expect(code.size() == 1 && code[0].begin == 0x1000 && code[0].end == 0x5000, "touching code sections not merged");
+        const std::vector<pe::RvaRange> all = pe::SectionRanges(info, pe::TARGET_ALL);
+        check.Expect(all.size() == 2 && all[1].begin == 0x6000 && all[1].end == 0x8000, "data ranges wrong or .reloc included");
+        check.Expect(scanner::ScannedBytes(info, pe::TARGET_CODE) == 0x4000, "ScannedBytes(code) is " + std::to_string(scanner::ScannedBytes(info, pe::TARGET_CODE)));
+
+        uint8_t* base = image.data.data();
+        const scanner::Pattern pattern = scanner::ParsePattern("4C 8D 05 ? ? ? ? 48 8B CB E8");
+        check.Expect(!scanner::ScanImage(base, info, pattern, pe::TARGET_CODE, pool), "match in an empty image");
+
+        // Data-only hits are invisible to code scans; one straddling .text/.text2 is not
+        PlantPattern(base + 0x6100, pattern);
+        PlantPattern(base + 0x8100, pattern);
+        check.Expect(!scanner::ScanImage(base, info, pattern, pe::TARGET_CODE, pool), "code scan matched in .rdata or .reloc");
+        check.Expect(scanner::ScanImage(base, info, pattern, pe::TARGET_READONLY_DATA, pool) == base + 0x6100, "read-only data scan missed .rdata");
+        PlantPattern(base + 0x4000 - 5, pattern);
+        check.Expect(scanner::ScanImage(base, info, pattern, pe::TARGET_CODE, pool) == base + 0x4000 - 5, "match across touching code sections missed");
+
+        // The last bytes of .rdata run into .data: merged for scanning, filtered per signature
+        PlantPattern(base + 0x7000 - 4, pattern);
+        PlantPattern(base + 0x7200, pattern);
+        scanner::SignatureSet signatures;
+        signatures.Add("code", pattern, pe::TARGET_CODE);
+        signatures.Add("rdata", pattern, pe::TARGET_READONLY_DATA);
+        signatures.Add("data", pattern, pe::TARGET_WRITABLE_DATA);
+        const std::vector<scanner::SignatureHits> hits = scanner::ScanImageAll(base, info, signatures, pool);
+        const std::vector<const uint8_t*> expected[] = {
+            { base + 0x4000 - 5 },
+            { base + 0x6100, base + 0x7000 - 4 },
+            { base + 0x7200 },
+        };
+        check.Expect(hits.size() == 3, "ScanImageAll returned " + std::to_string(hits.size()) + " entries");
+        for (size_t i = 0; i < hits.size() && i < 3; i++) {
+            check.Expect(hits[i].hits == expected[i], std::string("ScanImageAll \"") + signatures.NameAt(i) + "\": " +
+                std::to_string(hits[i].hits.size()) + " hits, expected " + std::to_string(expected[i].size()));
+        }
+        return check.Report();
+    }
+
+    /**
+     * @brief Decoding of hand-assembled instructions and the backward reference walk
+     */
+    bool CheckDecoder() {
+        Check check("decoder");
+
+        struct Case {
+            const char* text;
+            uint8_t length;
+            uint32_t kind;
+            uint8_t reg;
+            int32_t displacement;
+        };
+        const Case cases[] = {
+            { "48 8D 05 10 00 00 00", 7, x64::REFERENCE_LEA, 0, 0x10 },                 // lea rax, [rip+0x10]
+            { "4C 8D 0D F0 FF FF FF", 7, x64::REFERENCE_LEA, 9, -0x10 },                // lea r9, [rip-0x10]
+            { "48 8B 05 00 01 00 00", 7, x64::REFERENCE_MOV, 0, 0x100 },                // mov rax, [rip+0x100]
+            { "48 89 0D 08 00 00 00", 7, x64::REFERENCE_MOV, 1, 8 },                    // mov [rip+8], rcx
+            { "E8 00 10 00 00", 5, x64::REFERENCE_CALL, 0, 0x1000 },                    // call rel32
+            { "E9 FB FF FF FF", 5, x64::REFERENCE_JMP, 0, -5 },                         // jmp rel32
+            { "FF 15 20 00 00 00", 6, x64::REFERENCE_INDIRECT, 2, 0x20 },               // call [rip+0x20]
+            { "FF 25 20 00 00 00", 6, x64::REFERENCE_INDIRECT, 4, 0x20 },               // jmp [rip+0x20]
+            { "48 8B 44 24 08", 5, 0, 0, 0 },                                           // mov rax, [rsp+8]
+            { "48 81 EC 28 01 00 00", 7, 0, 5, 0 },                                     // sub rsp, 0x128
+            { "48 B8 01 02 03 04 05 06 07 08", 10, 0, 0, 0 },                           // mov rax, imm64
+            { "66 C7 05 10 00 00 00 34 12", 9, 0, 0, 0x10 },                            // mov word [rip+0x10], imm16
+            { "41 5F", 2, 0, 0, 0 },                                                    // pop r15
+            { "74 05", 2, 0, 0, 0 },                                                    // je rel8
+            { "0F 84 00 01 00 00", 6, 0, 0, 0 },                                        // je rel32
+            { "0F B6 05 10 00 00 00", 7, 0, 0, 0 },                                     // movzx eax, byte [rip+0x10]
+            { "0F 94 C0", 3, 0, 0, 0 },                                                 // sete al
+            { "80 7B 08 00", 4, 0, 7, 0 },                                              // cmp byte [rbx+8], 0
+            { "48 C1 E8 03", 4, 0, 5, 0 },                                              // shr rax, 3
+            { "3C 2F", 2, 0, 0, 0 },                                                    // cmp al, 0x2F
+        };
+        for (const Case& test : cases) {
+            const scanner::Pattern bytes = scanner::ParsePattern(test.text);
+            x64::Instruction instruction;
+            const bool decoded = x64::Decode(bytes.bytes, bytes.length, instruction);
+            check.Expect(decoded && instruction.length == test.length && instruction.kind == test.kind &&
+                instruction.reg == test.reg && (!test.kind || instruction.displacement == test.displacement),
+                std::string("\"") + test.text + "\" decoded as length " + std::to_string(instruction.length) + ", kind " + std::to_string(instruction.kind));
+
+            // Truncated bytes must be rejected, never read past
+            x64::Instruction truncated;
+            check.Expect(!x64::Decode(bytes.bytes, bytes.length - 1, truncated), std::string("truncated \"") + test.text + "\" decoded");
+        }
+
+        const char* rejected[] = { "48 8D C0", "FF 1D 00 00 00 00", "0F 05", "66 E8 00 00" };
+        for (const char* text : rejected) {
+            const scanner::Pattern bytes = scanner::ParsePattern(text);
+            x64::Instruction instruction;
+            check.Expect(!x64::Decode(bytes.bytes, bytes.length, instruction), std::string("\"") + text + "\" decoded");
+        }
+
+        // lea rdx, [rip+0x40]; mov rcx, rbx; hit  -> the LEA, two instructions back
+        const scanner::Pattern code = scanner::ParsePattern("90 48 8D 15 40 00 00 00 48 8B CB E8 00 00 00 00");
+        const uint8_t* hit = code.bytes + 11;
+        x64::Reference reference;
+        const bool found = x64::FindReferenceBefore(hit, code.bytes, x64::REFERENCE_LEA, reference);
+        check.Expect(found && reference.offset == -10 && reference.target == reinterpret_cast<uintptr_t>(code.bytes + 1 + 7 + 0x40),
+            "LEA before the hit not found (offset " + std::to_string(reference.offset) + ")");
+        check.Expect(!x64::FindReferenceBefore(hit, code.bytes, x64::REFERENCE_CALL, reference), "CALL found where there is none");
+        check.Expect(!x64::FindReferenceBefore(hit, code.bytes + 4, x64::REFERENCE_LEA, reference), "walk read below its lower bound");
+
+        // lea rdx, [rip+0x40]; test al, al; je +5; hit  -> the walk steps over the jcc
+        const scanner::Pattern branchy = scanner::ParsePattern("48 8D 15 40 00 00 00 84 C0 74 05 E8 00 00 00 00");
+        check.Expect(x64::FindReferenceBefore(branchy.bytes + 11, branchy.bytes, x64::REFERENCE_LEA, reference) && reference.offset == -11,
+            "LEA before a jcc not found (offset " + std::to_string(reference.offset) + ")");
+
+        // lea rcx, [rip+0x20]; movaps xmm0, xmm1; hit  -> the walk stops at movaps, the probe finds the LEA
+        const scanner::Pattern unknown = scanner::ParsePattern("48 8D 0D 20 00 00 00 0F 28 C1 E8 00 00 00 00");
+        check.Expect(x64::FindReferenceBefore(unknown.bytes + 10, unknown.bytes, x64::REFERENCE_LEA, reference) && reference.offset == -10 &&
+            reference.target == reinterpret_cast<uintptr_t>(unknown.bytes + 7 + 0x20),
+            "LEA before undecodable code not probed (offset " + std::to_string(reference.offset) + ")");
+        return check.Report();
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const bool hasValue = i + 1 < argc;
+            if (!std::strcmp(argv[i], "--seed") && hasValue) {
+                options.seed = std::strtoull(argv[++i], nullptr, 0);
+            }
+            else if (!std::strcmp(argv[i], "--rounds") && hasValue) {
+                options.rounds = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (!std::strcmp(argv[i], "--threads") && hasValue) {
+                options.threads = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else {
+                return false;
+            }
+        }
+        return options.rounds > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --seed N      Random seed (default: 0x%llX)\n"
+            "  --rounds N    Randomized cases per backend check (default: %zu)\n"
+            "  --threads N   Worker threads for the parallel checks (default: 4)\n",
+            argv[0], static_cast<unsigned long long>(DEFAULT_SEED), DEFAULT_ROUNDS);
+        return 2;
+    }
+
+    std::printf("backend %s, seed 0x%llX, %zu rounds\n\n", scanner::BackendName(scanner::GetActiveBackend()),
+        static_cast<unsigned long long>(options.seed), options.rounds);
+
+    core::WorkerPool pool(options.threads);
+    std::mt19937_64 random(options.seed);
+    bool passed = CheckBackends(options, random);
+    passed &= CheckSignatureSet(options, random);
+    passed &= CheckParallel(options, pool, random);
+    passed &= CheckSections(pool);
+    passed &= CheckDecoder();
+
+    std::printf("\n%s\n", passed ? "all checks passed" : "CHECKS FAILED");
+    return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+// sigscan: resolve the overlay signatures against a DLL on disk.
+// Uses the same scanning core as the injected DLL (section-aware multi-signature scan on the
+// worker pool, then LEA resolution), so RVAs printed here are what the game process will find.
+//
+// Usage: sigscan <gameoverlayrenderer64.dll> [--threads N] [--repeat N] [--pattern NAME "48 8B ? ..."]...
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/workerPool.h"
+#include "Scanning/imageScanner.h"
+#include "Scanning/leaResolver.h"
+#include "Scanning/mappedImage.h"
+#include "Scanning/overlaySignatures.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        const char* path = nullptr;
+        size_t threads = 0;     // 0 = same policy as the DLL (core::GetWorkerPool)
+        size_t repeat = 1;
+        std::vector<std::pair<std::string, std::string>> extraPatterns;
+    };
+
+    double Milliseconds(Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void PrintUsage(const char* program) {
+        std::fprintf(stderr,
+            "Usage: %s <image.dll> [--threads N] [--repeat N] [--pattern NAME \"PATTERN\"]...\n"
+            "  --threads N   Worker threads for the scan (default: same as the injected DLL)\n"
+            "  --repeat N    Scan N times and report min/average timing (default: 1)\n"
+            "  --pattern     Resolve an extra signature, e.g. to try a replacement before shipping it\n",
+            program);
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+                options.threads = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) {
+                options.repeat = (std::max)(1ul, std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (!std::strcmp(argv[i], "--pattern") && i + 2 < argc) {
+                options.extraPatterns.emplace_back(argv[i + 1], argv[i + 2]);
+                i += 2;
+            }
+            else if (argv[i][0] != '-' && !options.path) {
+                options.path = argv[i];
+            }
+            else {
+                return false;
+            }
+        }
+        return options.path != nullptr;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    const Clock::time_point loadStart = Clock::now();
+    pe::MappedImage image;
+    if (!image.Load(options.path)) {
+        std::fprintf(stderr, "%s: not a readable PE image\n", options.path);
+        return 2;
+    }
+    const double loadMs = Milliseconds(Clock::now() - loadStart);
+
+    scanner::SignatureSet signatures;
+    for (const scanner::Signature* signature : overlaySignatures::ALL) {
+        signatures.Add(signature->name, signature->pattern, signature->sections);
+    }
+    for (const auto& extra : options.extraPatterns) {
+        if (!signatures.Add(extra.first.c_str(), extra.second.c_str())) {
+            std::fprintf(stderr, "Malformed pattern for %s: \"%s\"\n", extra.first.c_str(), extra.second.c_str());
+            return 2;
+        }
+    }
+
+    std::unique_ptr<core::WorkerPool> ownedPool;
+    if (options.threads) {
+        ownedPool.reset(new core::WorkerPool(options.threads));
+    }
+    core::WorkerPool& pool = ownedPool ? *ownedPool : *core::GetWorkerPool();
+
+    std::vector<scanner::SignatureHits> hits;
+    double bestScanMs = 0.0;
+    double totalScanMs = 0.0;
+    for (size_t run = 0; run < options.repeat; run++) {
+        const Clock::time_point scanStart = Clock::now();
+        hits = scanner::ScanImageAll(image.Data(), image.Info(), signatures, pool);
+        const double scanMs = Milliseconds(Clock::now() - scanStart);
+        bestScanMs = run ? (std::min)(bestScanMs, scanMs) : scanMs;
+        totalScanMs += scanMs;
+    }
+
+    const pe::ImageInfo& info = image.Info();
+    std::printf("image      %s\n", options.path);
+    std::printf("build      timestamp %08X, size of image 0x%X, %s\n", info.timeDateStamp, info.sizeOfImage, info.is64Bit ? "PE32+" : "PE32");
+    std::printf("backend    %s, %zu worker thread(s)\n", scanner::BackendName(scanner::GetActiveBackend()), pool.ThreadCount());
+    std::printf("\n%-12s %6s %12s %8s %12s\n", "signature", "hits", "pattern RVA", "offset", "function RVA");
+
+    size_t unresolved = 0;
+    for (size_t i = 0; i < hits.size(); i++) {
+        const scanner::Resolution resolution = scanner::ResolveFromHits(image.Data(), info, hits[i]);
+        if (resolution.resolved) {
+            std::printf("%-12s %6zu %12X %8d %12X\n", hits[i].name, hits[i].hits.size(),
+                resolution.patternRva, resolution.instructionOffset, resolution.functionRva);
+        }
+        else {
+            std::printf("%-12s %6zu %12s %8s %12s\n", hits[i].name, hits[i].hits.size(), "-", "-", "UNRESOLVED");
+            unresolved++;
+        }
+    }
+
+    const double scannedMb = static_cast<double>(scanner::ScannedBytes(info, signatures.CombinedSections())) / (1024.0 * 1024.0);
+    std::printf("\nload       %.3f ms (%zu bytes on disk)\n", loadMs, image.FileSize());
+    std::printf("scan       %.3f ms best, %.3f ms average over %zu run(s)\n", bestScanMs, totalScanMs / options.repeat, options.repeat);
+    std::printf("throughput %.1f MB/s over %.2f MB of targeted sections\n", bestScanMs > 0.0 ? scannedMb / (bestScanMs / 1000.0) : 0.0, scannedMb);
+
+    ownedPool.reset();
+    core::ShutdownWorkerPool();
+    return unresolved ? 1 : 0;
+}
\ No newline at end of file